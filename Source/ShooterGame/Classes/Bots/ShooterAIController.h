@@ -19,6 +19,10 @@ class AShooterAIController : public AAIController
 	virtual void BeginInactiveState() OVERRIDE;
 	// End APlayerController interface
 
+	// Begin AActor interface
+	virtual void Destroyed() OVERRIDE;
+	// End AActor interface
+
 	void Respawn();
 
 	void CheckAmmo(const class AShooterWeapon* CurrentWeapon);
@@ -35,6 +39,9 @@ class AShooterAIController : public AAIController
 	UFUNCTION(BlueprintCallable, Category=Behavior)
 	void FindClosestEnemy();
 
+	/** reacts to gunfire, explosion or damage delivered by perception bus */
+	void OnStimulus(const struct FShooterStimulus& Stimulus);
+
 	// Begin AAIController interface
 	/** Update direction AI is looking based on FocalPoint */
 	virtual void UpdateControlRotation(float DeltaTime, bool bUpdatePawn = true) OVERRIDE;
@@ -43,4 +50,16 @@ class AShooterAIController : public AAIController
 protected:
 	int32 EnemyKeyID;
 	int32 NeedAmmoKeyID;
+
+	/** earliest time of next enemy search while server sheds bot think */
+	float NextEnemySearchTime;
+
+	/** earliest time of next line of sight check while server sheds bot think */
+	float NextShootCheckTime;
+
+	/** earliest time of next enemy search while current enemy is alive, perceived enemies are picked up in between */
+	float NextEnemyPollTime;
+
+	/** returns false if server is shedding bot think and NextThinkTime hasn't passed yet */
+	bool CanThink(float& NextThinkTime);
 };
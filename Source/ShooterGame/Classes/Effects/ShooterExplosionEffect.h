@@ -24,6 +24,10 @@ class AShooterExplosionEffect : public AActor
 	UPROPERTY(EditDefaultsOnly, Category=Effect)
 	float ExplosionLightFadeOut;
 
+	/** explosion light intensity over normalized fade time, uses default fade if not set */
+	UPROPERTY(EditDefaultsOnly, Category=Effect)
+	UCurveFloat* ExplosionLightCurve;
+
 	/** explosion sound */
 	UPROPERTY(EditDefaultsOnly, Category=Effect)
 	USoundCue* ExplosionSound;
@@ -36,14 +40,6 @@ class AShooterExplosionEffect : public AActor
 	UPROPERTY(BlueprintReadOnly, Category=Surface)
 	FHitResult SurfaceHit;
 
-	/** spawn explosion */
+	/** spawn explosion, hand light over to light animation manager */
 	virtual void BeginPlay() OVERRIDE;
-
-	/** update fading light */
-	virtual void Tick(float DeltaSeconds) OVERRIDE;
-
-private:
-
-	/** Point light component name */
-	FName ExplosionLightComponentName;
 };
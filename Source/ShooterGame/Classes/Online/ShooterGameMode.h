@@ -38,6 +38,36 @@ class AShooterGameMode : public AGameMode
 	/** prevents friendly fire */
 	virtual float ModifyDamage(float Damage, AActor* DamagedActor, struct FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser) const;
 
+	/** adds damage to this frame's queue, resolved in FlushPendingDamage */
+	void QueueDamage(class AShooterCharacter* Victim, float Damage, struct FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser);
+
+	/** applies game rules to queued damage and resolves a single hit or kill per victim */
+	void FlushPendingDamage();
+
+	/** finds pawns within radius of explosion, their falloff damage and whether world geometry occludes them */
+	void GatherExplosionHits(float BaseDamage, const FVector& Origin, float Radius, AActor* DamageCauser, TArray<struct FShooterExplosionHit>& OutHits);
+
+	/** deals explosion damage with linear falloff to pawns within radius that aren't occluded by world geometry */
+	void ApplyExplosionDamage(float BaseDamage, const FVector& Origin, float Radius, TSubclassOf<UDamageType> DamageTypeClass, AActor* DamageCauser, AController* EventInstigator);
+
+	/** returns pawn spatial index for radius queries */
+	class FShooterPawnSpatialIndex& GetPawnSpatialIndex();
+
+	/** returns frame budget governor deciding which non-critical work to shed */
+	class FShooterServerBudget& GetServerBudget();
+
+	/** returns rolling buffer of pawn transforms and shots kill-cams are cut from */
+	class FShooterKillCamRecorder& GetKillCamRecorder();
+
+	/** returns index of level pickups for nearest available queries */
+	class FShooterPickupRegistry& GetPickupRegistry();
+
+	/** returns queue respawning all level pickups */
+	class FShooterPickupScheduler& GetPickupScheduler();
+
+	/** returns event bus bots perceive gunfire, explosions and damage through */
+	class FShooterPerceptionBus& GetPerceptionBus();
+
 	/** notify about kills */
 	virtual void Killed(AController* Killer, AController* KilledPlayer, APawn* KilledPawn, const UDamageType* DamageType);
 
@@ -62,6 +92,9 @@ class AShooterGameMode : public AGameMode
 
 protected:
 
+	/** also registers frame start of server budget */
+	virtual void RegisterActorTickFunctions(bool bRegister) OVERRIDE;
+
 	/** delay between first player login and starting match */
 	UPROPERTY(config)
 	int32 WarmupTime;
@@ -93,6 +126,27 @@ protected:
 	
 	EShooterGameState CurrentState;
 
+	/** damage queued during the current frame */
+	TArray<FShooterPendingDamage> PendingDamage;
+
+	/** spatial index of live pawns, created on first use */
+	TSharedPtr<class FShooterPawnSpatialIndex> PawnSpatialIndex;
+
+	/** frame budget governor, created on first use */
+	TSharedPtr<class FShooterServerBudget> ServerBudget;
+
+	/** kill-cam buffer, created on first use */
+	TSharedPtr<class FShooterKillCamRecorder> KillCamRecorder;
+
+	/** pickup registry, created on first use */
+	TSharedPtr<class FShooterPickupRegistry> PickupRegistry;
+
+	/** pickup respawn queue, created on first use */
+	TSharedPtr<class FShooterPickupScheduler> PickupScheduler;
+
+	/** bot perception bus, created on first use */
+	TSharedPtr<class FShooterPerceptionBus> PerceptionBus;
+
 	bool bAllowBots;		
 
 	/** Triggers round start event for local players. Needs revising when shootergame goes multiplayer */
@@ -134,7 +188,4 @@ public:
 	/** get the name of the bots count option used in server travel URL */
 	static FString GetBotsCountOptionName();
 
-	UPROPERTY()
-	TArray<class AShooterPickup*> LevelPickups;
-
 };
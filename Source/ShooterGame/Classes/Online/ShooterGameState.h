@@ -1,5 +1,6 @@
 // Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
 
+#include "ShooterTypes.h"
 #include "ShooterGameState.generated.h"
 
 /** ranked PlayerState map, created from the GameState */
@@ -26,6 +27,10 @@ class AShooterGameState : public AGameState
 	UPROPERTY(Transient, Replicated)
 	bool bTimerPaused;
 
+	/** recent kills, written as a ring by the server, slot of event is (EventId - 1) % size */
+	UPROPERTY(Transient, ReplicatedUsing=OnRep_KillEvents)
+	FShooterKillEvent KillEvents[8];
+
 	/** gets ranked PlayerState map for specific team */
 	void GetRankedMap(int32 TeamIndex, RankedPlayerMap& OutRankedMap) const;	
 
@@ -34,4 +39,74 @@ class AShooterGameState : public AGameState
 	void ConformToKingState();
 
 	virtual void Tick(float DeltaSeconds) OVERRIDE;	
+
+	/** loads weapon definitions with the map, so the first weapon spawned in a match doesn't hitch */
+	virtual void PostInitializeComponents() OVERRIDE;
+
+	/** returns budget manager for weapon impact effects in this world */
+	class FShooterImpactEffectManager& GetImpactEffectManager();
+
+	/** returns voice limiter for gameplay sounds in this world */
+	class FShooterAudioVoiceManager& GetAudioVoiceManager();
+
+	/** returns batched update manager for characters in this world */
+	class FShooterCharacterUpdateManager& GetCharacterUpdateManager();
+
+	/** returns animation manager for transient effect lights in this world */
+	class FShooterLightAnimationManager& GetLightAnimationManager();
+
+	/** returns HUD data shared by all local players, built once per tick */
+	class FShooterHUDSnapshot& GetHUDSnapshot();
+
+	/** returns most recent kills, formatted for display */
+	class FShooterKillFeed& GetKillFeed();
+
+	/** [server] adds kill to replicated stream and passes it to local players */
+	void AddKillEvent(class AShooterPlayerState* KillerPlayerState, class AShooterPlayerState* VictimPlayerState, const UDamageType* DamageType);
+
+protected:
+
+	friend struct FShooterKillEventTest;
+
+	/** sequence number of last kill event handled */
+	int32 LastKillEventId;
+
+	/** sequence number of kill event waiting for its player states to replicate, 0 if none */
+	int32 StalledKillEventId;
+
+	/** game time StalledKillEventId started waiting */
+	float StalledKillEventTime;
+
+	/** returns sequence number of newest kill event in the ring, 0 if empty */
+	int32 GetNewestKillEventId() const;
+
+	/** handles kill events newer than LastKillEventId, oldest first, stopping at one that isn't fully replicated yet */
+	void ProcessKillEvents();
+
+	/** passes kill to kill feed and death messages of local players */
+	void HandleKillEvent(const FShooterKillEvent& Event);
+
+	UFUNCTION()
+	void OnRep_KillEvents();
+
+	/** tracks window net accounting counts received RPCs in along with actor tick */
+	virtual void RegisterActorTickFunctions(bool bRegister) OVERRIDE;
+
+	/** impact effect budgets, created on first use */
+	TSharedPtr<class FShooterImpactEffectManager> ImpactEffectManager;
+
+	/** gameplay sound voice limits, created on first use */
+	TSharedPtr<class FShooterAudioVoiceManager> AudioVoiceManager;
+
+	/** batched character updates, created on first use */
+	TSharedPtr<class FShooterCharacterUpdateManager> CharacterUpdateManager;
+
+	/** effect light animations, created on first use */
+	TSharedPtr<class FShooterLightAnimationManager> LightAnimationManager;
+
+	/** shared HUD data, created on first use */
+	TSharedPtr<class FShooterHUDSnapshot> HUDSnapshot;
+
+	/** kill feed, created on first use */
+	TSharedPtr<class FShooterKillFeed> KillFeed;
 };
@@ -21,6 +21,19 @@ class AShooterPlayerState : public APlayerState
 
 	// End APlayerState interface
 
+	// Begin AActor interface
+
+	/** accounts changed replicated properties for net accounting */
+	virtual void PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker) OVERRIDE;
+
+	/** accounts sent RPC for net accounting */
+	virtual bool CallRemoteFunction(UFunction* Function, void* Parameters, struct FOutParmRec* OutParms, FFrame* Stack) OVERRIDE;
+
+	/** accounts received RPC for net accounting */
+	virtual void ProcessEvent(UFunction* Function, void* Parameters) OVERRIDE;
+
+	// End AActor interface
+
 	/**
 	 * Set new team and update pawn. Also updates player character team colors.
 	 *
@@ -55,14 +68,6 @@ class AShooterPlayerState : public APlayerState
 	/** gets truncated player name to fit in death log and scoreboards */
 	FString GetShortPlayerName() const;
 
-	/** Sends kill (excluding self) to clients */
-	UFUNCTION(Reliable, Client)
-	void InformAboutKill(class AShooterPlayerState* KillerPlayerState, const UDamageType* KillerDamageType, class AShooterPlayerState* KilledPlayerState);
-
-	/** broadcast death to local clients */
-	UFUNCTION(Reliable, NetMulticast)
-	void BroadcastDeath(class AShooterPlayerState* KillerPlayerState, const UDamageType* KillerDamageType, class AShooterPlayerState* KilledPlayerState);
-
 	/** replicate team colors. Updated the players mesh colors appropriately */
 	UFUNCTION()
 	void OnRep_TeamColor();
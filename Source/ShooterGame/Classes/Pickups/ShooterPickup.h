@@ -17,6 +17,21 @@ class AShooterPickup : public AActor
 	/** initial setup */
 	virtual void BeginPlay() OVERRIDE;
 
+	/** removes pickup from registry */
+	virtual void Destroyed() OVERRIDE;
+
+	/** returns class of item pickup gives, used to index it in pickup registry */
+	virtual UClass* GetPickupItemClass() const;
+
+	/** returns distance from pickup within which pawns may touch it */
+	float GetTouchRadius() const;
+
+	/** does pawn's capsule touch pickup? */
+	bool IsTouchedBy(const class AShooterCharacter* Pawn) const;
+
+	/** [server] respawns pickup and gives it to first of nearby pawns standing on it, called by FShooterPickupScheduler */
+	void RespawnForPawns(const TArray<class AShooterCharacter*>& NearbyPawns);
+
 protected:
 
 	/** FX component */
@@ -63,6 +78,9 @@ protected:
 	/** show and enable pickup */
 	virtual void RespawnPickup();
 
+	/** [server] updates pickup state in registry */
+	void UpdateRegistry();
+
 	/** show effects when pickup disappears */
 	virtual void OnPickedUp();
 
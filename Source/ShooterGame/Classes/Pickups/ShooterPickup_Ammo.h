@@ -13,6 +13,9 @@ class AShooterPickup_Ammo : public AShooterPickup
 
 	bool IsForWeapon(UClass* WeaponClass);
 
+	/** returns weapon type ammo is for */
+	virtual UClass* GetPickupItemClass() const OVERRIDE;
+
 protected:
 
 	/** how much ammo does it give? */
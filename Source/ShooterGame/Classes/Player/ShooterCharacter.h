@@ -11,7 +11,7 @@ class AShooterCharacter : public ACharacter
 	/** spawn inventory, setup initial variables */
 	virtual void PostInitializeComponents() OVERRIDE;
 
-	/** Update the character. (Running, health etc). */
+	/** Registers for batched updates if that wasn't possible yet, see FShooterCharacterUpdateManager. */
 	virtual void Tick(float DeltaSeconds) OVERRIDE;
 
 	/** cleanup inventory */
@@ -69,6 +69,9 @@ class AShooterCharacter : public ACharacter
 	 */
 	class AShooterWeapon* FindWeapon(TSubclassOf<class AShooterWeapon> WeaponClass);
 
+	/** recomputes effective stats of all weapons in inventory, call when owner's cheats or controller change */
+	void ResolveWeaponModifiers();
+
 	/** 
 	 * [server + local] equips weapon from inventory 
 	 *
@@ -91,13 +94,13 @@ class AShooterCharacter : public ACharacter
 	/** check if pawn can reload weapon */
 	bool CanReload() const;
 
-	/** [server + local] change targeting state */
+	/** [server + local] change targeting state, server gets local changes through saved moves of UShooterCharacterMovement */
 	void SetTargeting(bool bNewTargeting);
 
 	//////////////////////////////////////////////////////////////////////////
 	// Movement
 
-	/** [server + local] change running state */
+	/** [server + local] change running state, server gets local changes through saved moves of UShooterCharacterMovement */
 	void SetRunning(bool bNewRunning, bool bToggle);
 	
 	//////////////////////////////////////////////////////////////////////////
@@ -224,6 +227,12 @@ class AShooterCharacter : public ACharacter
 	UFUNCTION(BlueprintCallable, Category=Pawn)
 	bool IsRunning() const;
 
+	/** is running requested, whether or not pawn moves fast enough to run? */
+	bool WantsToRun() const;
+
+	/** is pawn moving in a direction it can run in? */
+	bool IsMovingForRun() const;
+
 	/** get camera view type */
 	UFUNCTION(BlueprintCallable, Category=Mesh)
 	virtual bool IsFirstPerson() const;
@@ -231,6 +240,21 @@ class AShooterCharacter : public ACharacter
 	/** get max health */
 	int32 GetMaxHealth() const;
 
+	/** [batched] stops toggled running when pawn no longer runs */
+	void UpdateRunningState();
+
+	/** [batched] applies cheat health regen for time elapsed since last update */
+	void UpdateHealthRegen(float DeltaSeconds);
+
+	/** [batched] starts, stops and adjusts low health warning loop */
+	void UpdateLowHealthWarning();
+
+	/** does running state, regen or low health warning still need batched updates? */
+	bool NeedsPeriodicUpdates() const;
+
+	/** has character update manager visit this character until it's idle again */
+	void RequestPeriodicUpdates();
+
 	/** check if pawn is still alive */
 	bool IsAlive() const;
 
@@ -300,6 +324,18 @@ protected:
 	/** when low health effects should start */
 	float LowHealthPercentage;
 
+	/** health from class defaults, cached on spawn */
+	int32 MaxHealth;
+
+	/** is character handled by the game state's character update manager? */
+	bool bRegisteredForUpdates;
+
+	/** hands periodic updates over to the character update manager */
+	void RegisterForUpdates();
+
+	/** stops periodic updates */
+	void UnregisterFromUpdates();
+
 	/** Base turn rate, in deg/sec. Other scaling may affect final turn rate. */
 	float BaseTurnRate;
 
@@ -372,12 +408,15 @@ public:
 	uint32 bIsDying:1;
 
 	// Current health of the Pawn
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Replicated, Category=Health)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, ReplicatedUsing=OnRep_Health, Category=Health)
 	float Health;
 
-	/** Take damage, handle death */
+	/** Take damage, queued with the game mode and resolved once per frame. Returns damage before game rules. */
 	virtual float TakeDamage(float Damage, struct FDamageEvent const& DamageEvent, class AController* EventInstigator, class AActor* DamageCauser) OVERRIDE;
 
+	/** applies all damage queued for this pawn during the frame, single hit or death for the largest contributor */
+	virtual void ApplyPendingDamage(TArray<struct FShooterPendingDamage>& PendingDamage);
+
 	/** Pawn suicide */
 	virtual void Suicide();
 
@@ -402,6 +441,13 @@ public:
 
 	/** Called on the actor right before replication occurs */
 	virtual void PreReplication( IRepChangedPropertyTracker & ChangedPropertyTracker ) OVERRIDE;
+
+	/** accounts sent RPC for net accounting */
+	virtual bool CallRemoteFunction(UFunction* Function, void* Parameters, struct FOutParmRec* OutParms, FFrame* Stack) OVERRIDE;
+
+	/** accounts received RPC for net accounting */
+	virtual void ProcessEvent(UFunction* Function, void* Parameters) OVERRIDE;
+
 protected:
 	/** notification when killed, for both the server and client. */
 	virtual void OnDeath(float KillingDamage, struct FDamageEvent const& DamageEvent, class APawn* InstigatingPawn, class AActor* DamageCauser);
@@ -419,6 +465,10 @@ protected:
 	UFUNCTION()
 	void OnRep_LastTakeHitInfo();
 
+	/** starts low health warning updates on client */
+	UFUNCTION()
+	void OnRep_Health();
+
 	//////////////////////////////////////////////////////////////////////////
 	// Inventory
 
@@ -438,14 +488,6 @@ protected:
 	/** equip weapon */
 	UFUNCTION(reliable, server, WithValidation)
 	void ServerEquipWeapon(class AShooterWeapon* NewWeapon);
-
-	/** update targeting state */
-	UFUNCTION(reliable, server, WithValidation)
-	void ServerSetTargeting(bool bNewTargeting);
-	
-	/** update targeting state */
-	UFUNCTION(reliable, server, WithValidation)
-	void ServerSetRunning(bool bNewRunning, bool bToggle);
 };
 
 
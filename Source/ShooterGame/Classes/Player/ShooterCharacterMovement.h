@@ -7,11 +7,66 @@
 #pragma once
 #include "ShooterCharacterMovement.generated.h"
 
+/**
+ * Saved move carrying running and targeting state, so speed changes are predicted, sent and replayed with the move
+ * instead of reaching the server on their own.
+ */
+class FSavedMove_Shooter : public FSavedMove_Character
+{
+public:
+
+	typedef FSavedMove_Character Super;
+
+	virtual void Clear() OVERRIDE;
+	virtual void SetMoveFor(ACharacter* Character, float InDeltaTime, FVector const& NewAccel, class FNetworkPredictionData_Client_Character& ClientData) OVERRIDE;
+	virtual void PrepMoveFor(ACharacter* Character) OVERRIDE;
+	virtual uint8 GetCompressedFlags() const OVERRIDE;
+	virtual bool CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* Character, float MaxDelta) const OVERRIDE;
+
+	/** was running requested during move? */
+	uint32 bSavedWantsToRun : 1;
+
+	/** was pawn targeting during move? */
+	uint32 bSavedIsTargeting : 1;
+};
+
+/** client prediction data allocating FSavedMove_Shooter */
+class FNetworkPredictionData_Client_Shooter : public FNetworkPredictionData_Client_Character
+{
+public:
+
+	typedef FNetworkPredictionData_Client_Character Super;
+
+	virtual FSavedMovePtr AllocateNewMove() OVERRIDE;
+};
+
 UCLASS()
 class UShooterCharacterMovement : public UCharacterMovementComponent
 {
 	GENERATED_UCLASS_BODY()
 
 	virtual float GetMaxSpeedModifier() const OVERRIDE;
+
+	virtual class FNetworkPredictionData_Client* GetPredictionData_Client() const OVERRIDE;
+
+	/** [local] use running and targeting state of saved move being replayed instead of current one */
+	void SetReplayedMoveState(bool bWantsToRun, bool bIsTargeting);
+
+	/** [local] go back to current running and targeting state for new moves */
+	void ClearReplayedMoveState();
+
+protected:
+
+	/** [server] applies running and targeting state sent with move */
+	virtual void UpdateFromCompressedFlags(uint8 Flags) OVERRIDE;
+
+	/** is saved move being replayed? */
+	uint32 bReplayingMove : 1;
+
+	/** running request of replayed move */
+	uint32 bReplayedWantsToRun : 1;
+
+	/** targeting state of replayed move */
+	uint32 bReplayedIsTargeting : 1;
 };
 
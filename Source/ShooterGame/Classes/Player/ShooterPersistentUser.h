@@ -3,6 +3,32 @@
 #pragma once
 #include "ShooterPersistentUser.generated.h"
 
+/** achievement progress that couldn't be written to the online service yet */
+USTRUCT()
+struct FShooterPendingAchievement
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** achievement id */
+	UPROPERTY()
+	FString Id;
+
+	/** progress, 0 to 100 */
+	UPROPERTY()
+	float Percent;
+
+	FShooterPendingAchievement()
+		: Percent(0.0f)
+	{
+	}
+
+	FShooterPendingAchievement(const FString& InId, float InPercent)
+		: Id(InId)
+		, Percent(InPercent)
+	{
+	}
+};
+
 UCLASS()
 class UShooterPersistentUser : public USaveGame
 {
@@ -85,6 +111,14 @@ public:
 
 	void SetBotsCount(int32 InCount);
 
+	/** Achievement progress kept by FShooterAchievementQueue until it's written */
+	FORCEINLINE const TArray<FShooterPendingAchievement>& GetPendingAchievements() const
+	{
+		return PendingAchievements;
+	}
+
+	void SetPendingAchievements(const TArray<FShooterPendingAchievement>& InPendingAchievements);
+
 	FORCEINLINE FString GetName() const
 	{
 		return SlotName;
@@ -142,6 +176,10 @@ protected:
 	UPROPERTY()
 	bool bInvertedYAxis;
 
+	/** Achievement progress not written to the online service yet */
+	UPROPERTY()
+	TArray<FShooterPendingAchievement> PendingAchievements;
+
 private:
 	/** Internal.  True if data is changed but hasn't been saved. */
 	bool bIsDirty;
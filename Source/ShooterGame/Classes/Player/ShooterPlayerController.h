@@ -22,6 +22,17 @@ public:
 	UFUNCTION(reliable, client)
 	void ClientSetSpectatorCamera(FVector CameraLocation, FRotator CameraRotation);
 
+	/** plays back how player died, sent once on death */
+	UFUNCTION(reliable, client)
+	void ClientPlayKillCam(const FShooterKillCamClip& Clip);
+
+	/** notify player about fragging someone, sent with the kill so no credit is lost to the kill event ring */
+	UFUNCTION(reliable, client)
+	void ClientOnKill();
+
+	/** returns kill-cam being played, NULL if there is none */
+	const class FShooterKillCamPlayback* GetKillCamPlayback() const;
+
 	/** notify player about started match */
 	UFUNCTION(reliable, client)
 	void ClientGameStarted();
@@ -157,6 +168,9 @@ public:
 
 	virtual bool SetPause(bool bPause, FCanUnpause CanUnpauseDelegate = FCanUnpause()) OVERRIDE;
 
+	/** advances kill-cam playback */
+	virtual void PlayerTick(float DeltaTime) OVERRIDE;
+
 	// End APlayerController interface
 
 	// begin AShooterPlayerController-specific
@@ -167,7 +181,7 @@ public:
 	void QueryAchievements();
 
 	/** 
-	 * Writes a single achievement (unless another write is in progress).
+	 * Queues achievement progress, merged with other updates and written in a batch by FShooterAchievementQueue.
 	 *
 	 * @param Id achievement id (string)
 	 * @param Percent number 1 to 100
@@ -191,11 +205,11 @@ public:
 protected:
 
 	/** infinite ammo cheat */
-	UPROPERTY(Transient, Replicated)
+	UPROPERTY(Transient, ReplicatedUsing=OnRep_WeaponCheats)
 	uint8 bInfiniteAmmo : 1;
 
 	/** infinite clip cheat */
-	UPROPERTY(Transient, Replicated)
+	UPROPERTY(Transient, ReplicatedUsing=OnRep_WeaponCheats)
 	uint8 bInfiniteClip : 1;
 
 	/** health regen cheat */
@@ -206,23 +220,48 @@ protected:
 	UPROPERTY(Transient, Replicated)
 	uint8 bGodMode : 1;
 
+	/** refreshes pawn's weapons when infinite ammo or clip cheat changes */
+	UFUNCTION()
+	void OnRep_WeaponCheats();
+
 	/** if set, gameplay related actions (movement, weapn usage, etc) are allowed */
 	uint8 bAllowGameActions : 1;
 
 	/** shooter in-game menu */
 	TSharedPtr<class FShooterIngameMenu> ShooterIngameMenu;
 
-	/** Achievements write object */
-	FOnlineAchievementsWritePtr WriteObject;
-
 	/** try to find spot for death cam */
 	bool FindDeathCameraSpot(FVector& CameraLocation, FRotator& CameraRotation);
 
+	/** kill-cam being played */
+	TSharedPtr<class FShooterKillCamPlayback> KillCamPlayback;
+
+	/** pawn that died, kill-cam stops once another one is possessed */
+	TWeakObjectPtr<APawn> KillCamPawn;
+
+	/** static death camera, taken over when kill-cam ends */
+	FVector DeathCameraLocation;
+
+	/** static death camera, taken over when kill-cam ends */
+	FRotator DeathCameraRotation;
+
+	/** ends kill-cam and moves to static death camera */
+	void StopKillCam();
+
 	//Begin AActor interface
 
 	/** after all game elements are created */
 	virtual void PostInitializeComponents() OVERRIDE;
 
+	/** accounts changed replicated properties for net accounting */
+	virtual void PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker) OVERRIDE;
+
+	/** accounts sent RPC for net accounting */
+	virtual bool CallRemoteFunction(UFunction* Function, void* Parameters, struct FOutParmRec* OutParms, FFrame* Stack) OVERRIDE;
+
+	/** accounts received RPC for net accounting */
+	virtual void ProcessEvent(UFunction* Function, void* Parameters) OVERRIDE;
+
 	//End AActor interface
 
 	//Begin AController interface
@@ -36,15 +36,60 @@ class UShooterGameUserSettings : public UGameUserSettings
 	// interface UGameUserSettings
 	virtual void SetToDefaults() OVERRIDE;
 
+	/** is quality picked from benchmark results? */
+	bool IsAutoQuality() const
+	{
+		return GraphicsQuality == 2;
+	}
+
+	/** returns scalability level applied by last ApplySettings */
+	int32 GetAppliedQualityLevel() const
+	{
+		return AppliedQualityLevel;
+	}
+
+	/** starts benchmark if auto quality is selected and it never ran on this machine */
+	void InitAutoQuality();
+
+	/** 
+	 * Stores frame times measured at AppliedQualityLevel and picks the highest level expected to hit the target frame time.
+	 * Called by benchmark on completion and when sustained frame times drift away from the target.
+	 */
+	void SetBenchmarkResults(float GameThreadMs, float RenderThreadMs, float GPUMs);
+
 private:
+
+	/** returns highest scalability level expected to hit target frame time */
+	int32 PickAutoQualityLevel() const;
+
 	/**
 	 * Graphics Quality
 	 *	0 = Low
 	 *	1 = High
+	 *	2 = Auto, from benchmark
 	 */
 	UPROPERTY(config)
 	int32 GraphicsQuality;
 
+	/** benchmarked game thread time, scaled to highest quality level (ms), 0 if never run */
+	UPROPERTY(config)
+	float BenchmarkGameThreadMs;
+
+	/** benchmarked render thread time, scaled to highest quality level (ms) */
+	UPROPERTY(config)
+	float BenchmarkRenderThreadMs;
+
+	/** benchmarked GPU time, scaled to highest quality level (ms) */
+	UPROPERTY(config)
+	float BenchmarkGPUMs;
+
+	/** scalability level picked from benchmark */
+	UPROPERTY(config)
+	int32 AutoQualityLevel;
+
+	/** scalability level currently in effect */
+	int32 AppliedQualityLevel;
+
 	/** is lan match? */
 	UPROPERTY(config)
 	bool bIsLanMatch;
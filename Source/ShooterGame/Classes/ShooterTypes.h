@@ -202,4 +202,214 @@ public:
 	{
 		EnsureReplicationByte++;
 	}
-};
\ No newline at end of file
+};
+
+/** damage dealt to a pawn during the current frame, aggregated per victim and instigator */
+struct FShooterPendingDamage
+{
+	/** pawn receiving the damage */
+	TWeakObjectPtr<class AShooterCharacter> Victim;
+
+	/** controller responsible for the damage */
+	TWeakObjectPtr<class AController> EventInstigator;
+
+	/** actor that caused the most recent hit */
+	TWeakObjectPtr<class AActor> DamageCauser;
+
+	/** accumulated damage, game rules are applied once on flush */
+	float Damage;
+
+	/** number of hits merged into this entry */
+	int32 NumHits;
+
+	/** most recent damage event */
+	FTakeHitInfo HitInfo;
+
+	FShooterPendingDamage()
+		: Damage(0.f)
+		, NumHits(0)
+	{}
+};
+
+/** pawn shown in kill-cam clip */
+USTRUCT()
+struct FShooterKillCamActor
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** player the pawn belonged to */
+	UPROPERTY()
+	class AShooterPlayerState* PlayerState;
+
+	/** pawn of killer */
+	UPROPERTY()
+	uint8 bKiller : 1;
+
+	/** pawn of player receiving the clip */
+	UPROPERTY()
+	uint8 bVictim : 1;
+
+	FShooterKillCamActor()
+		: PlayerState(NULL)
+		, bKiller(false)
+		, bVictim(false)
+	{}
+};
+
+/** recorded transform of single pawn in single kill-cam frame */
+USTRUCT()
+struct FShooterKillCamSample
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** index in clip actors */
+	UPROPERTY()
+	uint8 ActorIndex;
+
+	/** index of frame */
+	UPROPERTY()
+	uint8 FrameIndex;
+
+	/** compressed aim yaw */
+	UPROPERTY()
+	uint8 Yaw;
+
+	/** compressed aim pitch */
+	UPROPERTY()
+	uint8 Pitch;
+
+	/** location relative to clip origin */
+	UPROPERTY()
+	FVector_NetQuantize Location;
+
+	FShooterKillCamSample()
+		: ActorIndex(0)
+		, FrameIndex(0)
+		, Yaw(0)
+		, Pitch(0)
+	{}
+};
+
+/** shot fired during kill-cam clip */
+USTRUCT()
+struct FShooterKillCamShot
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** index in clip actors of shooter */
+	UPROPERTY()
+	uint8 ActorIndex;
+
+	/** frame shot was fired in */
+	UPROPERTY()
+	uint8 FrameIndex;
+
+	/** impact or end of tracer, relative to clip origin */
+	UPROPERTY()
+	FVector_NetQuantize End;
+
+	FShooterKillCamShot()
+		: ActorIndex(0)
+		, FrameIndex(0)
+	{}
+};
+
+/** slice of server kill-cam buffer around a death, sent once to the victim */
+USTRUCT()
+struct FShooterKillCamClip
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** death location, all locations are relative to it */
+	UPROPERTY()
+	FVector_NetQuantize Origin;
+
+	/** time between frames */
+	UPROPERTY()
+	float FrameInterval;
+
+	/** number of frames */
+	UPROPERTY()
+	uint8 NumFrames;
+
+	/** pawns in clip */
+	UPROPERTY()
+	TArray<FShooterKillCamActor> Actors;
+
+	/** pawn transforms, ordered by frame */
+	UPROPERTY()
+	TArray<FShooterKillCamSample> Samples;
+
+	/** shots, ordered by frame */
+	UPROPERTY()
+	TArray<FShooterKillCamShot> Shots;
+
+	FShooterKillCamClip()
+		: Origin(ForceInitToZero)
+		, FrameInterval(0.0f)
+		, NumFrames(0)
+	{}
+};
+
+/** single kill in the replicated kill event stream of the game state */
+USTRUCT()
+struct FShooterKillEvent
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** sequence number, 0 for unused slots */
+	UPROPERTY()
+	int32 EventId;
+
+	/** player scoring kill, NULL if killed by the world */
+	UPROPERTY()
+	class AShooterPlayerState* Killer;
+
+	/** there is a killer, tells world kills from a killer clients haven't resolved yet */
+	UPROPERTY()
+	bool bHasKiller;
+
+	/** killed player */
+	UPROPERTY()
+	class AShooterPlayerState* Victim;
+
+	/** what killed the player */
+	UPROPERTY()
+	TSubclassOf<UDamageType> DamageType;
+
+	/** server game time of kill */
+	UPROPERTY()
+	float Time;
+
+	FShooterKillEvent()
+		: EventId(0)
+		, Killer(NULL)
+		, bHasKiller(false)
+		, Victim(NULL)
+		, DamageType(NULL)
+		, Time(0.0f)
+	{}
+};
+
+/** pawn within radius of an explosion */
+struct FShooterExplosionHit
+{
+	/** pawn inside falloff */
+	class AShooterCharacter* Victim;
+
+	/** damage after falloff */
+	float Damage;
+
+	/** point of capsule closest to explosion */
+	FVector Location;
+
+	/** world geometry blocks the blast */
+	bool bOccluded;
+
+	FShooterExplosionHit()
+		: Victim(NULL)
+		, Damage(0.f)
+		, Location(ForceInitToZero)
+		, bOccluded(false)
+	{}
+};
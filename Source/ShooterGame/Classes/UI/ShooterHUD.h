@@ -19,43 +19,6 @@ struct FHitData
 	}
 };
 
-struct FDeathMessage
-{
-	/** Name of player scoring kill. */
-	FString KillerDesc;
-
-	/** Name of killed player. */
-	FString VictimDesc;
-
-	/** Killer is local player. */
-	uint8 bKillerIsOwner : 1;
-	
-	/** Victim is local player. */
-	uint8 bVictimIsOwner : 1;
-
-	/** Team number of the killer. */
-	int32 KillerTeamNum;
-
-	/** Team number of the victim. */
-	int32 VictimTeamNum; 
-
-	/** timestamp for removing message */
-	float HideTime;
-
-	/** What killed the player. */
-	TWeakObjectPtr<class UShooterDamageType> DamageType;
-
-	/** Initialise defaults. */
-	FDeathMessage()
-		: bKillerIsOwner(false)
-		, bVictimIsOwner(false)
-		, KillerTeamNum(0)
-		, VictimTeamNum(0)		
-		, HideTime(0.f)
-	{
-	}
-};
-
 UCLASS()
 class AShooterHUD : public AHUD
 {
@@ -273,9 +236,6 @@ protected:
 	/** Runtime data for hit indicator. */
 	FHitData HitNotifyData[8];
 
-	/** Active death messages. */
-	TArray<FDeathMessage> DeathMessages;
-
 	/** State of match. */
 	EShooterMatchState::Type MatchState;
 
@@ -300,13 +260,6 @@ protected:
 	/** Called every time game is started. */
 	virtual void PostInitializeComponents() OVERRIDE;
 
-	/** 
-	 * Converts floating point seconds to MM:SS string.
-	 *
-	 * @param TimeSeconds		The time to get a string for.
-	 */
-	FString GetTimeString(float TimeSeconds);
-
 	/** Draws weapon HUD. */
 	void DrawWeaponHUD();
 
@@ -335,6 +288,12 @@ protected:
 	 */
 	float DrawRecentlyKilledPlayer();
 
+	/** Draws recorded pawns and shots of kill-cam being played. */
+	void DrawKillCam();
+
+	/** Draws hot path counters overlay, toggled with Shooter.ShowCounters. */
+	void DrawStatCounters();
+
 	/** Temporary helper for drawing text-in-a-box. */
 	void DrawDebugInfoString(const FString& Text, float PosX, float PosY, bool bAlignLeft, bool bAlignTop, const FColor& TextColor);
 
@@ -59,6 +59,168 @@ struct FWeaponData
 	}
 };
 
+/** authoritative ammo, replicated to owning client along with the last of its actions it includes */
+USTRUCT()
+struct FWeaponAmmoState
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** total ammo */
+	UPROPERTY()
+	int32 Ammo;
+
+	/** ammo in clip */
+	UPROPERTY()
+	int32 AmmoInClip;
+
+	/** last shot of owning client counted in ammo */
+	UPROPERTY()
+	int32 ShotSequence;
+
+	/** last reload request of owning client that was finished, rejected or interrupted */
+	UPROPERTY()
+	int32 ReloadSequence;
+
+	/** defaults */
+	FWeaponAmmoState()
+		: Ammo(0)
+		, AmmoInClip(0)
+		, ShotSequence(0)
+		, ReloadSequence(0)
+	{
+	}
+};
+
+/** ammo change predicted by owning client, replayed on top of server ammo until server resolves it */
+struct FWeaponAmmoPrediction
+{
+	/** reload instead of single shot */
+	bool bReload;
+
+	/** predicted reload finished locally and refilled the clip */
+	bool bApplied;
+
+	/** shot or reload sequence number */
+	int32 Sequence;
+
+	FWeaponAmmoPrediction()
+		: bReload(false)
+		, bApplied(false)
+		, Sequence(0)
+	{}
+};
+
+/** result of single shot, sent by owning client to server in batches */
+USTRUCT()
+struct FWeaponShotResult
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** index of shot in burst */
+	UPROPERTY()
+	uint16 ShotIndex;
+
+	/** shot hit something blocking */
+	UPROPERTY()
+	uint32 bBlockingHit:1;
+
+	/** direction of shot */
+	UPROPERTY()
+	FVector_NetQuantizeNormal ShootDir;
+
+	/** actor that was hit, not set for world geometry and misses */
+	UPROPERTY()
+	TWeakObjectPtr<class AActor> HitActor;
+
+	/** impact location */
+	UPROPERTY()
+	FVector_NetQuantize ImpactPoint;
+
+	/** impact normal */
+	UPROPERTY()
+	FVector_NetQuantizeNormal ImpactNormal;
+
+	/** defaults */
+	FWeaponShotResult()
+		: ShotIndex(0)
+		, bBlockingHit(false)
+		, ShootDir(ForceInitToZero)
+		, ImpactPoint(ForceInitToZero)
+		, ImpactNormal(ForceInitToZero)
+	{
+	}
+};
+
+/** change to weapon stats from cheats, game rules, pickups or buffs */
+USTRUCT(BlueprintType)
+struct FWeaponModifier
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** who added it, used to replace or remove it */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category=Modifier)
+	FName Source;
+
+	/** inifite ammo for reloads */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category=Modifier)
+	bool bInfiniteAmmo;
+
+	/** infinite ammo in clip, no reload required */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category=Modifier)
+	bool bInfiniteClip;
+
+	/** multiplier of time between shots */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category=Modifier)
+	float TimeBetweenShotsScale;
+
+	/** multiplier of damage dealt */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category=Modifier)
+	float DamageScale;
+
+	/** multiplier of weapon spread */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category=Modifier)
+	float SpreadScale;
+
+	/** defaults */
+	FWeaponModifier()
+		: bInfiniteAmmo(false)
+		, bInfiniteClip(false)
+		, TimeBetweenShotsScale(1.0f)
+		, DamageScale(1.0f)
+		, SpreadScale(1.0f)
+	{
+	}
+};
+
+/** weapon stats with all modifiers applied, read by the fire path */
+struct FWeaponEffectiveStats
+{
+	/** inifite ammo for reloads */
+	bool bInfiniteAmmo;
+
+	/** infinite ammo in clip, no reload required */
+	bool bInfiniteClip;
+
+	/** time between two consecutive shots */
+	float TimeBetweenShots;
+
+	/** multiplier of damage dealt */
+	float DamageScale;
+
+	/** multiplier of weapon spread */
+	float SpreadScale;
+
+	/** defaults */
+	FWeaponEffectiveStats()
+		: bInfiniteAmmo(false)
+		, bInfiniteClip(false)
+		, TimeBetweenShots(0.0f)
+		, DamageScale(1.0f)
+		, SpreadScale(1.0f)
+	{
+	}
+};
+
 USTRUCT()
 struct FWeaponAnim
 {
@@ -83,6 +245,9 @@ class AShooterWeapon : public AActor
 
 	virtual void Destroyed() OVERRIDE;
 
+	/** replaces config with the one from definition, or from class defaults if Definition is NULL */
+	virtual void ApplyDefinition(const class UShooterWeaponDefinition* Definition);
+
 	//////////////////////////////////////////////////////////////////////////
 	// Ammo
 	
@@ -241,10 +406,33 @@ class AShooterWeapon : public AActor
 	bool bHideCrosshairWhileNotAiming;
 
 	/** check if weapon has infinite ammo (include owner's cheats) */
-	bool HasInfiniteAmmo() const;
+	bool HasInfiniteAmmo() const
+	{
+		return EffectiveStats.bInfiniteAmmo;
+	}
 
 	/** check if weapon has infinite clip (include owner's cheats) */
-	bool HasInfiniteClip() const;
+	bool HasInfiniteClip() const
+	{
+		return EffectiveStats.bInfiniteClip;
+	}
+
+	/** get stats with modifiers applied */
+	const FWeaponEffectiveStats& GetEffectiveStats() const
+	{
+		return EffectiveStats;
+	}
+
+	/** [server] adds modifier, replacing one from the same source */
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category="Game|Weapon")
+	void AddModifier(const FWeaponModifier& Modifier);
+
+	/** [server] removes modifier of given source */
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category="Game|Weapon")
+	void RemoveModifier(FName Source);
+
+	/** recomputes effective stats from config and modifiers, on server owner's cheats are kept as a modifier first; call when any of them changes */
+	void ResolveModifiers();
 
 	/** set the weapon's owning pawn */
 	void SetOwningPawn(AShooterCharacter* AShooterCharacter);
@@ -257,6 +445,9 @@ class AShooterWeapon : public AActor
 
 protected:
 
+	/** development console commands that drive the fire and ammo protocol of a live weapon */
+	friend struct FShooterWeaponTest;
+
 	/** pawn owner */
 	UPROPERTY(Transient, ReplicatedUsing=OnRep_MyPawn)
 	class AShooterCharacter* MyPawn;
@@ -309,6 +500,10 @@ protected:
 	UPROPERTY(EditDefaultsOnly, Category=Sound)
 	USoundCue* FireLoopSound;
 
+	/** how far bots hear shots, multiplier of their hearing range */
+	UPROPERTY(EditDefaultsOnly, Category=Sound)
+	float FireLoudness;
+
 	/** finished burst sound (bLoopedFireSound set) */
 	UPROPERTY(EditDefaultsOnly, Category=Sound)
 	USoundCue* FireFinishSound;
@@ -380,29 +575,131 @@ protected:
 	/** how much time weapon needs to be equipped */
 	float EquipDuration;
 
-	/** current total ammo */
-	UPROPERTY(Transient, Replicated)
+	/** current total ammo, predicted on owning client */
 	int32 CurrentAmmo;
 
-	/** current ammo - inside clip */
-	UPROPERTY(Transient, Replicated)
+	/** current ammo - inside clip, predicted on owning client */
 	int32 CurrentAmmoInClip;
 
+	/** server ammo for owning client */
+	UPROPERTY(Transient, ReplicatedUsing=OnRep_AmmoState)
+	FWeaponAmmoState AmmoState;
+
+	/** modifiers from game rules, pickups and buffs */
+	UPROPERTY(Transient, ReplicatedUsing=OnRep_Modifiers)
+	TArray<FWeaponModifier> Modifiers;
+
+	/** stats with modifiers applied, updated in ResolveModifiers */
+	FWeaponEffectiveStats EffectiveStats;
+
+	/** owner's bot controller, resolved with modifiers */
+	TWeakObjectPtr<class AShooterAIController> OwnerBotController;
+
+	/** owning player's state for shot stats, resolved with modifiers */
+	TWeakObjectPtr<class AShooterPlayerState> OwnerPlayerState;
+
+	/** [local] ammo changes server hasn't resolved yet, oldest first */
+	TArray<FWeaponAmmoPrediction> AmmoPredictions;
+
+	/** [local] sequence number of next predicted shot */
+	int32 NextShotSequence;
+
+	/** [local + server] sequence number of last reload request */
+	int32 ReloadSequence;
+
 	/** burst counter, used for replicating fire events to remote clients */
 	UPROPERTY(Transient, ReplicatedUsing=OnRep_BurstCounter)
 	int32 BurstCounter;
 
 	//////////////////////////////////////////////////////////////////////////
-	// Input - server side
+	// Fire burst protocol
+
+	/** [local] id of current burst, wraps around */
+	uint8 FireBurstId;
+
+	/** [local + server] seed of current burst, per shot seeds are derived from it */
+	int32 FireBurstSeed;
+
+	/** [local] index of next shot in burst */
+	int32 NextShotIndex;
+
+	/** [local] result of shot being fired, filled by FireWeapon */
+	FWeaponShotResult PendingShot;
+
+	/** [local] shots server hasn't acknowledged yet, oldest first */
+	TArray<FWeaponShotResult> UnackedShots;
+
+	/** [local] shots added since last batch was sent */
+	int32 NumUnsentShots;
+
+	/** [server] is burst of owning client open? */
+	uint32 bServerBurstActive : 1;
 
+	/** [server] time burst started */
+	float ServerBurstStartTime;
+
+	/** [server] delay client waited before first shot of burst */
+	float ServerFirstShotDelay;
+
+	/** [server] index of last processed shot in burst */
+	int32 LastServerShotIndex;
+
+	/** [server] sequence number of first shot in burst */
+	int32 ServerFirstShotSequence;
+
+	/** [server] last shot owning client fired before its latest reload, shots up to it that arrive later are stale */
+	int32 ServerReloadShotSequence;
+
+	/** [local] starts new burst */
+	void BeginFireBurst();
+
+	/** [local] queues result of shot just fired and sends batch when due */
+	void QueueShotResult();
+
+	/** [local] sends unacknowledged shots, keeps resending until server acknowledges them */
+	void SendShotBatch();
+
+	/** [local + server] returns random seed of shot in current burst */
+	int32 GetShotRandomSeed(int32 ShotIndex) const;
+
+	/**
+	 * [server] processes new shots of owning client in order, stops at first shot that came too early for weapon's effective cadence.
+	 * Early shots wait for a resend, except in the final batch of burst where nothing follows and they are dropped.
+	 */
+	void ServerProcessShots(uint8 BurstId, const TArray<FWeaponShotResult>& Shots, bool bFinalBatch = false);
+
+	/** [server] consumes ammo and updates fire FX for single shot of owning client */
+	virtual void ServerProcessShot(const FWeaponShotResult& Shot);
+
+	/** [server] records shot for kill-cams */
+	void RecordKillCamShot(const FWeaponShotResult& Shot);
+
+	/** [server] lets bots in hearing range know about shot */
+	void ReportFireNoise();
+
+	/** burst start: seed of per shot randomness, delay before first shot and ammo sequence number of first shot */
 	UFUNCTION(reliable, server, WithValidation)
-	void ServerStartFire();
+	void ServerStartFire(uint8 BurstId, int32 BurstSeed, float FirstShotDelay, int32 FirstShotSequence);
 
+	/** burst end: carries shots not acknowledged yet */
 	UFUNCTION(reliable, server, WithValidation)
-	void ServerStopFire();
+	void ServerStopFire(uint8 BurstId, const TArray<FWeaponShotResult>& Shots);
+
+	/** batch of shot results, resent until acknowledged */
+	UFUNCTION(unreliable, server, WithValidation)
+	void ServerFireShots(uint8 BurstId, const TArray<FWeaponShotResult>& Shots);
+
+	/** acknowledges shots up to index */
+	UFUNCTION(unreliable, client)
+	void ClientAckShots(uint8 BurstId, int32 LastShotIndex);
+
 
+	//////////////////////////////////////////////////////////////////////////
+	// Input - server side
+
+	/** reload request along with last shot fired before it, unreliable shot batches may still arrive after it */
 	UFUNCTION(reliable, server, WithValidation)
-	void ServerStartReload();
+	void ServerStartReload(int32 Sequence, int32 LastShotSequence);
 
 	UFUNCTION(reliable, server, WithValidation)
 	void ServerStopReload();
@@ -411,6 +708,15 @@ protected:
 	//////////////////////////////////////////////////////////////////////////
 	// Replication & effects
 
+	/** accounts changed replicated properties for net accounting */
+	virtual void PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker) OVERRIDE;
+
+	/** accounts sent RPC for net accounting */
+	virtual bool CallRemoteFunction(UFunction* Function, void* Parameters, struct FOutParmRec* OutParms, FFrame* Stack) OVERRIDE;
+
+	/** accounts received RPC for net accounting */
+	virtual void ProcessEvent(UFunction* Function, void* Parameters) OVERRIDE;
+
 	UFUNCTION()
 	void OnRep_MyPawn();
 
@@ -420,6 +726,25 @@ protected:
 	UFUNCTION()
 	void OnRep_Reload();
 
+	/** [local] reconciles predicted ammo with server ammo */
+	UFUNCTION()
+	void OnRep_AmmoState();
+
+	UFUNCTION()
+	void OnRep_Modifiers();
+
+	/** [server] keeps modifier with source "Cheats" in sync with owner's infinite ammo and clip cheats */
+	void UpdateCheatModifier(const class AShooterPlayerController* MyPC);
+
+	/** [local] records predicted ammo change */
+	void AddAmmoPrediction(bool bReload, int32 Sequence);
+
+	/** takes single round from ammo counts */
+	void ConsumeRound(int32& Ammo, int32& AmmoInClip) const;
+
+	/** refills clip in ammo counts */
+	void RefillClip(int32& Ammo, int32& AmmoInClip) const;
+
 	/** Called in network play to do the cosmetic fx for firing */
 	virtual void SimulateWeaponFire();
 
@@ -433,10 +758,6 @@ protected:
 	/** [local] weapon specific fire implementation */
 	virtual void FireWeapon() PURE_VIRTUAL(AShooterWeapon::FireWeapon,);
 
-	/** [server] fire & update ammo */
-	UFUNCTION(reliable, server, WithValidation)
-	void ServerHandleFiring();
-
 	/** [local + server] handle weapon fire */
 	void HandleFiring();
 
@@ -0,0 +1,34 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterWeaponDefinition.generated.h"
+
+/**
+ * Tuning of single weapon class, kept in a data asset so balancing doesn't touch weapon blueprints.
+ * Definitions are collected by FShooterWeaponRegistry from the path in [ShooterGame.WeaponDefinitions] of the Game ini
+ * and replace the config of WeaponClass and its subclasses when weapons spawn.
+ */
+UCLASS(const, BlueprintType, DependsOn=(AShooterWeapon_Instant, AShooterWeapon_Projectile))
+class UShooterWeaponDefinition : public UDataAsset
+{
+	GENERATED_UCLASS_BODY()
+
+	/** weapon class tuned by this definition */
+	UPROPERTY(EditDefaultsOnly, Category=Definition)
+	TSubclassOf<class AShooterWeapon> WeaponClass;
+
+	/** ammo and fire rate */
+	UPROPERTY(EditDefaultsOnly, Category=Config)
+	FWeaponData WeaponConfig;
+
+	/** accuracy and damage, used by instant hit weapons */
+	UPROPERTY(EditDefaultsOnly, Category=Config)
+	FInstantWeaponData InstantConfig;
+
+	/** projectile and explosion, used by projectile weapons */
+	UPROPERTY(EditDefaultsOnly, Category=Config)
+	FProjectileWeaponData ProjectileConfig;
+
+	/** instant hit damage multiplier (Y) at fraction of weapon range (X), no falloff if not set */
+	UPROPERTY(EditDefaultsOnly, Category=Config)
+	UCurveFloat* DamageFalloff;
+};
@@ -82,6 +82,9 @@ class AShooterWeapon_Instant : public AShooterWeapon
 	/** get current spread */
 	float GetCurrentSpread() const;
 
+	/** replaces instant hit config along with weapon config and looks up its runtime table */
+	virtual void ApplyDefinition(const class UShooterWeaponDefinition* Definition) OVERRIDE;
+
 protected:
 
 	virtual EAmmoType GetAmmoType() const OVERRIDE
@@ -109,19 +112,23 @@ protected:
 	UPROPERTY(Transient, ReplicatedUsing=OnRep_HitNotify)
 	FInstantHitInfo HitNotify;
 
-	/** current spread from continuous firing */
-	float CurrentFiringSpread;
+	/** index of runtime table with precomputed spread and damage, set in ApplyDefinition */
+	int32 InstantTableIndex;
+
+	/** shots fired in current burst, selects spread step */
+	int32 BurstShotCount;
+
+	/** time HitNotify was last updated */
+	float LastHitNotifyTime;
 
 	//////////////////////////////////////////////////////////////////////////
 	// Weapon usage
 
-	/** server notified of hit from client to verify */
-	UFUNCTION(reliable, server, WithValidation)
-	void ServerNotifyHit(const FHitResult Impact, FVector_NetQuantizeNormal ShootDir, int32 RandomSeed, float ReticleSpread);
+	/** [server] verifies hit or shows trail FX of miss in shot of owning client */
+	virtual void ServerProcessShot(const FWeaponShotResult& Shot) OVERRIDE;
 
-	/** server notified of miss to show trail FX */
-	UFUNCTION(unreliable, server, WithValidation)
-	void ServerNotifyMiss(FVector_NetQuantizeNormal ShootDir, int32 RandomSeed, float ReticleSpread);
+	/** [server] verifies hit reported by owning client */
+	void ServerConfirmHit(const FHitResult& Impact, const FVector& ShootDir, int32 RandomSeed, float ReticleSpread);
 
 	/** process the instant hit and notify the server if necessary */
 	void ProcessInstantHit(const FHitResult& Impact, const FVector& Origin, const FVector& ShootDir, int32 RandomSeed, float ReticleSpread);
@@ -133,7 +140,16 @@ protected:
 	bool ShouldDealDamage(AActor* TestActor) const;
 
 	/** handle damage */
-	void DealDamage(const FHitResult& Impact, const FVector& ShootDir);
+	void DealDamage(const FHitResult& Impact, const FVector& Origin, const FVector& ShootDir);
+
+	/** get runtime table of this weapon */
+	const struct FShooterInstantWeaponTable& GetInstantTable() const;
+
+	/** get current spread cone half-angle (radians) */
+	float GetCurrentConeHalfAngle() const;
+
+	/** advances spread to next step of burst */
+	void AdvanceBurstSpread();
 
 	/** [local] weapon specific fire implementation */
 	virtual void FireWeapon() OVERRIDE;
@@ -148,6 +164,9 @@ protected:
 	UFUNCTION()
 	void OnRep_HitNotify();
 
+	/** [server] updates HitNotify for remote clients, throttled while server sheds cosmetics */
+	void NotifyRemoteHit(const FVector& Origin, int32 RandomSeed, float ReticleSpread);
+
 	/** called in network play to do the cosmetic fx  */
 	void SimulateInstantHit(const FVector& Origin, int32 RandomSeed, float ReticleSpread);
 
@@ -47,6 +47,9 @@ class AShooterWeapon_Projectile : public AShooterWeapon
 	/** apply config on projectile */
 	void ApplyWeaponConfig(FProjectileWeaponData& Data);
 
+	/** replaces projectile config along with weapon config */
+	virtual void ApplyDefinition(const class UShooterWeaponDefinition* Definition) OVERRIDE;
+
 protected:
 
 	virtual EAmmoType GetAmmoType() const OVERRIDE
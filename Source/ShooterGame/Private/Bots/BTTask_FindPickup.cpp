@@ -1,6 +1,7 @@
 // Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
 
 #include "ShooterGame.h"
+#include "Pickups/ShooterPickupRegistry.h"
 
 UBTTask_FindPickup::UBTTask_FindPickup(const class FPostConstructInitializeProperties& PCIP) 
 	: Super(PCIP)
@@ -23,23 +24,8 @@ EBTNodeResult::Type UBTTask_FindPickup::ExecuteTask(UBehaviorTreeComponent* Owne
 		return EBTNodeResult::Failed;
 	}
 
-	const FVector MyLoc = MyBot->GetActorLocation();
-	AShooterPickup_Ammo* BestPickup = NULL;
-	float BestDistSq = MAX_FLT;
-
-	for (int32 i = 0; i < GameMode->LevelPickups.Num(); ++i)
-	{
-		AShooterPickup_Ammo* AmmoPickup = Cast<AShooterPickup_Ammo>(GameMode->LevelPickups[i]);
-		if (AmmoPickup && AmmoPickup->IsForWeapon(AShooterWeapon_Instant::StaticClass()) && AmmoPickup->CanBePickedUp(MyBot))
-		{
-			const float DistSq = (AmmoPickup->GetActorLocation() - MyLoc).SizeSquared();
-			if (BestDistSq == -1 || DistSq < BestDistSq)
-			{
-				BestDistSq = DistSq;
-				BestPickup = AmmoPickup;
-			}
-		}
-	}
+	// closest ammo for instant hit weapons the bot can still take
+	AShooterPickup* BestPickup = GameMode->GetPickupRegistry().FindNearestAvailable(AShooterPickup_Ammo::StaticClass(), AShooterWeapon_Instant::StaticClass(), MyBot->GetActorLocation(), MyBot);
 
 	if (BestPickup)
 	{
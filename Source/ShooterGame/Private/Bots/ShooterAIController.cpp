@@ -1,6 +1,9 @@
 // Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
 
 #include "ShooterGame.h"
+#include "ShooterStatCounters.h"
+#include "Online/ShooterServerBudget.h"
+#include "ShooterPerceptionBus.h"
 
 AShooterAIController::AShooterAIController(const class FPostConstructInitializeProperties& PCIP) : Super(PCIP)
 {
@@ -9,6 +12,10 @@ AShooterAIController::AShooterAIController(const class FPostConstructInitializeP
  	BehaviorComp = PCIP.CreateDefaultSubobject<UBehaviorTreeComponent>(this, TEXT("BehaviorComp"));
 
 	bWantsPlayerState = true;
+
+	NextEnemySearchTime = 0.0f;
+	NextShootCheckTime = 0.0f;
+	NextEnemyPollTime = 0.0f;
 }
 
 void AShooterAIController::Possess(APawn* InPawn)
@@ -27,6 +34,24 @@ void AShooterAIController::Possess(APawn* InPawn)
 
 		BehaviorComp->StartTree(Bot->BotBehavior);
 	}
+
+	AShooterGameMode* GameMode = Cast<AShooterGameMode>(GetWorld()->GetAuthGameMode());
+	if (GameMode)
+	{
+		GameMode->GetPerceptionBus().Subscribe(this);
+	}
+	NextEnemyPollTime = 0.0f;
+}
+
+void AShooterAIController::Destroyed()
+{
+	AShooterGameMode* GameMode = Cast<AShooterGameMode>(GetWorld()->GetAuthGameMode());
+	if (GameMode)
+	{
+		GameMode->GetPerceptionBus().Unsubscribe(this);
+	}
+
+	Super::Destroyed();
 }
 
 void AShooterAIController::BeginInactiveState()
@@ -45,14 +70,43 @@ void AShooterAIController::Respawn()
 	GetWorld()->GetAuthGameMode()->RestartPlayer(this);
 }
 
+bool AShooterAIController::CanThink(float& NextThinkTime)
+{
+	AShooterGameMode* GameMode = Cast<AShooterGameMode>(GetWorld()->GetAuthGameMode());
+	if (GameMode == NULL || !GameMode->GetServerBudget().ShouldShed(EShooterShedWork::BotThink))
+	{
+		return true;
+	}
+
+	const float CurrentTime = GetWorld()->GetTimeSeconds();
+	if (CurrentTime < NextThinkTime)
+	{
+		return false;
+	}
+
+	// spread bots out so they don't all think on the same frame
+	NextThinkTime = CurrentTime + GameMode->GetServerBudget().GetBotThinkInterval() * FMath::FRandRange(0.75f, 1.25f);
+	return true;
+}
+
 void AShooterAIController::FindClosestEnemy()
 {
 	APawn* MyBot = GetPawn();
-	if (MyBot == NULL)
+	if (MyBot == NULL || !CanThink(NextEnemySearchTime))
 	{
 		return;
 	}
 
+	// gunfire, explosions and damage bring closer enemies through OnStimulus, so a live enemy is only re-checked now and then
+	AShooterGameMode* GameMode = Cast<AShooterGameMode>(GetWorld()->GetAuthGameMode());
+	const float CurrentTime = GetWorld()->GetTimeSeconds();
+	AShooterCharacter* CurrentEnemy = GetEnemy();
+	if (CurrentEnemy && CurrentEnemy->IsAlive() && CurrentTime < NextEnemyPollTime)
+	{
+		return;
+	}
+	NextEnemyPollTime = CurrentTime + (GameMode ? GameMode->GetPerceptionBus().GetEnemyPollInterval() : 0.0f);
+
 	const FVector MyLoc = MyBot->GetActorLocation();
 	float BestDistSq = MAX_FLT;
 	AShooterCharacter* BestPawn = NULL;
@@ -77,6 +131,34 @@ void AShooterAIController::FindClosestEnemy()
 	}
 }
 
+void AShooterAIController::OnStimulus(const FShooterStimulus& Stimulus)
+{
+	APawn* MyBot = GetPawn();
+	AShooterCharacter* Source = Cast<AShooterCharacter>(Stimulus.Instigator.Get());
+	if (MyBot == NULL || Source == NULL || !Source->IsAlive() || !Source->IsEnemyFor(this))
+	{
+		return;
+	}
+
+	// getting hit always turns bot towards attacker, noises only if they are closer than current enemy
+	AShooterCharacter* CurrentEnemy = GetEnemy();
+	if (CurrentEnemy == Source)
+	{
+		return;
+	}
+
+	if (CurrentEnemy && CurrentEnemy->IsAlive() && Stimulus.Type != EShooterStimulus::Damage)
+	{
+		const FVector MyLoc = MyBot->GetActorLocation();
+		if ((CurrentEnemy->GetActorLocation() - MyLoc).SizeSquared() <= (Source->GetActorLocation() - MyLoc).SizeSquared())
+		{
+			return;
+		}
+	}
+
+	SetEnemy(Source);
+}
+
 void AShooterAIController::ShootEnemy()
 {
 	AShooterBot* MyBot = Cast<AShooterBot>(GetPawn());
@@ -90,6 +172,13 @@ void AShooterAIController::ShootEnemy()
 	AShooterCharacter* Enemy = GetEnemy();
 	if ( Enemy && ( Enemy->IsAlive() )&& (MyWeapon->GetCurrentAmmo() > 0) && ( MyWeapon->CanFire() == true ) )
 	{
+		// only the line of sight check is throttled, keep doing whatever was decided last time
+		if (!CanThink(NextShootCheckTime))
+		{
+			return;
+		}
+
+		SHOOTER_COUNTER_INC(BotLineOfSight);
 		if (LineOfSightTo(Enemy, MyBot->GetActorLocation()))
 		{
 			bCanShoot = true;
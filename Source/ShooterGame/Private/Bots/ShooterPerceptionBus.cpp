@@ -0,0 +1,199 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "ShooterPerceptionBus.h"
+#include "ShooterPawnSpatialIndex.h"
+#include "ShooterConfigSection.h"
+#include "ShooterDevHelper.h"
+
+#if !UE_BUILD_SHIPPING
+static void TestPerception()
+{
+	UWorld* World = ShooterDevHelper::GetWorld();
+	AShooterGameMode* Game = World ? World->GetAuthGameMode<AShooterGameMode>() : NULL;
+	AShooterCharacter* Pawn = ShooterDevHelper::GetTestPawn(World);
+	if (Game == NULL || Pawn == NULL)
+	{
+		UE_LOG(LogShooter, Warning, TEXT("TestPerception: needs a game with authority and a live pawn"));
+		return;
+	}
+
+	FShooterPerceptionBus& Bus = Game->GetPerceptionBus();
+
+	FShooterStimulus Stimulus;
+	Stimulus.Type = EShooterStimulus::Gunfire;
+	Stimulus.Location = Pawn->GetActorLocation();
+	Stimulus.Instigator = Pawn;
+
+	TArray<AShooterAIController*> Listeners;
+	Bus.GatherListeners(World, Game->GetPawnSpatialIndex(), Stimulus, Listeners);
+
+	// brute force over every bot in the level
+	int32 NumExpected = 0;
+	int32 NumMissing = 0;
+	for (FConstControllerIterator It = World->GetControllerIterator(); It; ++It)
+	{
+		AShooterAIController* Bot = Cast<AShooterAIController>(*It);
+		AShooterCharacter* BotPawn = Bot ? Cast<AShooterCharacter>(Bot->GetPawn()) : NULL;
+		if (BotPawn == NULL || BotPawn == Pawn || !BotPawn->IsAlive())
+		{
+			continue;
+		}
+
+		const float HearingRange = Bus.GetHearingRange(Bot) * Stimulus.Loudness;
+		if (FVector::DistSquared(BotPawn->GetActorLocation(), Stimulus.Location) <= FMath::Square(HearingRange))
+		{
+			NumExpected++;
+			NumMissing += Listeners.Contains(Bot) ? 0 : 1;
+		}
+	}
+
+	UE_LOG(LogShooter, Log, TEXT("TestPerception: gunfire of %s is heard by %d bots, scan of all bots finds %d%s"), *Pawn->GetName(),
+		Listeners.Num(), NumExpected, (NumMissing == 0 && NumExpected == Listeners.Num()) ? TEXT("") : TEXT(" - MISMATCH"));
+}
+
+static FAutoConsoleCommand CmdTestPerception(
+	TEXT("Shooter.TestPerception"),
+	TEXT("Gathers the bots that would hear gunfire at the local pawn and checks them against a scan of every bot in the level"),
+	FConsoleCommandDelegate::CreateStatic(TestPerception)
+	);
+#endif
+
+FShooterPerceptionBus::FShooterPerceptionBus()
+	: DefaultHearingRange(4000.0f)
+	, EnemyPollInterval(2.0f)
+	, MaxHearingRange(0.0f)
+{
+	Loudness[EShooterStimulus::Gunfire] = 1.0f;
+	Loudness[EShooterStimulus::Explosion] = 1.5f;
+	Loudness[EShooterStimulus::Damage] = 0.25f;
+
+	const FShooterConfigSection Config(TEXT("ShooterGame.Perception"));
+	Config.Get(TEXT("HearingRange"), DefaultHearingRange);
+	Config.Get(TEXT("GunfireLoudness"), Loudness[EShooterStimulus::Gunfire]);
+	Config.Get(TEXT("ExplosionLoudness"), Loudness[EShooterStimulus::Explosion]);
+	Config.Get(TEXT("DamageLoudness"), Loudness[EShooterStimulus::Damage]);
+	Config.Get(TEXT("EnemyPollInterval"), EnemyPollInterval);
+}
+
+void FShooterPerceptionBus::Subscribe(AShooterAIController* Bot, float HearingRange)
+{
+	Subscribers.Add(Bot, HearingRange > 0.0f ? HearingRange : DefaultHearingRange);
+	UpdateMaxHearingRange();
+}
+
+void FShooterPerceptionBus::Unsubscribe(AShooterAIController* Bot)
+{
+	Subscribers.Remove(Bot);
+	UpdateMaxHearingRange();
+}
+
+void FShooterPerceptionBus::UpdateMaxHearingRange()
+{
+	MaxHearingRange = 0.0f;
+	for (auto It = Subscribers.CreateIterator(); It; ++It)
+	{
+		if (!It.Key().IsValid())
+		{
+			It.RemoveCurrent();
+			continue;
+		}
+
+		MaxHearingRange = FMath::Max(MaxHearingRange, It.Value());
+	}
+}
+
+float FShooterPerceptionBus::GetHearingRange(const AShooterAIController* Bot) const
+{
+	const float* HearingRange = Subscribers.Find(const_cast<AShooterAIController*>(Bot));
+	return HearingRange ? *HearingRange : 0.0f;
+}
+
+void FShooterPerceptionBus::Post(const FShooterStimulus& Stimulus)
+{
+	if (Subscribers.Num() == 0)
+	{
+		return;
+	}
+
+	// automatic weapons post every shot, one stimulus per instigator and kind is enough for a frame
+	for (int32 i = 0; i < Pending.Num(); i++)
+	{
+		FShooterStimulus& Existing = Pending[i];
+		if (Existing.Type == Stimulus.Type && Existing.Instigator == Stimulus.Instigator && Existing.Target == Stimulus.Target)
+		{
+			Existing.Location = Stimulus.Location;
+			Existing.Loudness = FMath::Max(Existing.Loudness, Stimulus.Loudness);
+			return;
+		}
+	}
+
+	Pending.Add(Stimulus);
+}
+
+void FShooterPerceptionBus::Post(EShooterStimulus::Type Type, const FVector& Location, APawn* Instigator, AController* Target, float LoudnessScale)
+{
+	FShooterStimulus Stimulus;
+	Stimulus.Type = Type;
+	Stimulus.Location = Location;
+	Stimulus.Loudness = Loudness[Type] * LoudnessScale;
+	Stimulus.Instigator = Instigator;
+	Stimulus.Target = Target;
+	Post(Stimulus);
+}
+
+void FShooterPerceptionBus::Tick(UWorld* World, FShooterPawnSpatialIndex& PawnIndex)
+{
+	if (Pending.Num() == 0)
+	{
+		return;
+	}
+
+	// bots can post stimuli while reacting, those go out next tick
+	TArray<FShooterStimulus> Delivering;
+	Exchange(Delivering, Pending);
+
+	TArray<AShooterAIController*> Listeners;
+	for (int32 i = 0; i < Delivering.Num(); i++)
+	{
+		Listeners.Reset();
+		GatherListeners(World, PawnIndex, Delivering[i], Listeners);
+
+		for (int32 ListenerIdx = 0; ListenerIdx < Listeners.Num(); ListenerIdx++)
+		{
+			Listeners[ListenerIdx]->OnStimulus(Delivering[i]);
+		}
+	}
+}
+
+void FShooterPerceptionBus::GatherListeners(UWorld* World, FShooterPawnSpatialIndex& PawnIndex, const FShooterStimulus& Stimulus, TArray<AShooterAIController*>& OutListeners) const
+{
+	const APawn* InstigatorPawn = Stimulus.Instigator.Get();
+
+	// target hears it regardless of range
+	AShooterAIController* TargetBot = Cast<AShooterAIController>(Stimulus.Target.Get());
+	if (TargetBot && TargetBot->GetPawn() && TargetBot->GetPawn() != InstigatorPawn && Subscribers.Contains(TargetBot))
+	{
+		OutListeners.Add(TargetBot);
+	}
+
+	// only pawns within the largest hearing range can hear it, exact range of each bot is checked below
+	TArray<AShooterCharacter*> Candidates;
+	PawnIndex.QuerySphere(World, Stimulus.Location, MaxHearingRange * Stimulus.Loudness, Candidates);
+
+	for (int32 i = 0; i < Candidates.Num(); i++)
+	{
+		AShooterCharacter* Candidate = Candidates[i];
+		AShooterAIController* Bot = Cast<AShooterAIController>(Candidate->Controller);
+		if (Bot == NULL || Bot == TargetBot || Candidate == InstigatorPawn)
+		{
+			continue;
+		}
+
+		const float* HearingRange = Subscribers.Find(Bot);
+		if (HearingRange && (Stimulus.Location - Candidate->GetActorLocation()).SizeSquared() <= FMath::Square(*HearingRange * Stimulus.Loudness))
+		{
+			OutListeners.Add(Bot);
+		}
+	}
+}
@@ -0,0 +1,106 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+/** kinds of events bots can perceive */
+namespace EShooterStimulus
+{
+	enum Type
+	{
+		Gunfire,
+		Explosion,
+		Damage,
+	};
+}
+
+/** single event posted to the perception bus */
+struct FShooterStimulus
+{
+	/** kind of event */
+	EShooterStimulus::Type Type;
+
+	/** where it happened */
+	FVector Location;
+
+	/** multiplier of subscriber's hearing range */
+	float Loudness;
+
+	/** pawn that caused it */
+	TWeakObjectPtr<APawn> Instigator;
+
+	/** controller always notified regardless of range, e.g. victim of damage */
+	TWeakObjectPtr<AController> Target;
+
+	FShooterStimulus()
+		: Type(EShooterStimulus::Gunfire)
+		, Location(FVector::ZeroVector)
+		, Loudness(1.0f)
+	{
+	}
+};
+
+/**
+ * Server side event bus bots perceive gunfire, explosions and damage through.
+ * Gameplay code posts stimuli, they are coalesced per instigator and kind and delivered once per frame
+ * to every subscribed bot within its hearing range scaled by loudness, so bots can poll for enemies far less often.
+ * Listeners of each stimulus are found through the pawn spatial index, so delivery cost follows bots nearby rather than all bots.
+ * Tuned in [ShooterGame.Perception] of the Game ini.
+ *
+ * Outside of shipping builds "Shooter.TestPerception" checks the listeners of gunfire at the local pawn against a scan of all bots.
+ */
+class FShooterPerceptionBus
+{
+public:
+
+	FShooterPerceptionBus();
+
+	/** subscribes bot, HearingRange defaults to the configured one if not positive */
+	void Subscribe(class AShooterAIController* Bot, float HearingRange = 0.0f);
+
+	/** unsubscribes bot */
+	void Unsubscribe(class AShooterAIController* Bot);
+
+	/** queues stimulus for delivery on next tick */
+	void Post(const FShooterStimulus& Stimulus);
+
+	/** posts stimulus of given kind, using configured loudness scaled by LoudnessScale */
+	void Post(EShooterStimulus::Type Type, const FVector& Location, APawn* Instigator, AController* Target = NULL, float LoudnessScale = 1.0f);
+
+	/** delivers queued stimuli to subscribers */
+	void Tick(UWorld* World, class FShooterPawnSpatialIndex& PawnIndex);
+
+	/** gathers subscribers which perceive stimulus, Target first if subscribed */
+	void GatherListeners(UWorld* World, class FShooterPawnSpatialIndex& PawnIndex, const FShooterStimulus& Stimulus, TArray<class AShooterAIController*>& OutListeners) const;
+
+	/** returns hearing range of bot at loudness 1, 0 if not subscribed */
+	float GetHearingRange(const class AShooterAIController* Bot) const;
+
+	/** returns min time between enemy searches of bot that already has a live enemy */
+	float GetEnemyPollInterval() const
+	{
+		return EnemyPollInterval;
+	}
+
+private:
+
+	/** updates MaxHearingRange, dropping destroyed bots */
+	void UpdateMaxHearingRange();
+
+	/** hearing range of bots subscribing without one */
+	float DefaultHearingRange;
+
+	/** loudness of each kind of stimulus */
+	float Loudness[EShooterStimulus::Damage + 1];
+
+	/** min time between enemy searches of bot that already has a live enemy */
+	float EnemyPollInterval;
+
+	/** hearing range at loudness 1 of each subscribed bot */
+	TMap<TWeakObjectPtr<class AShooterAIController>, float> Subscribers;
+
+	/** largest hearing range of subscribed bots, bounds the query of each stimulus */
+	float MaxHearingRange;
+
+	/** stimuli posted since last tick */
+	TArray<FShooterStimulus> Pending;
+};
@@ -1,14 +1,12 @@
 // Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
 
 #include "ShooterGame.h"
+#include "Sound/ShooterAudioVoiceManager.h"
+#include "ShooterLightAnimationManager.h"
 
 AShooterExplosionEffect::AShooterExplosionEffect(const class FPostConstructInitializeProperties& PCIP) : Super(PCIP)
 {
-	ExplosionLightComponentName = TEXT("ExplosionLight");
-
-	PrimaryActorTick.bCanEverTick = true;
-
-	ExplosionLight = PCIP.CreateDefaultSubobject<UPointLightComponent>(this, ExplosionLightComponentName);
+	ExplosionLight = PCIP.CreateDefaultSubobject<UPointLightComponent>(this, TEXT("ExplosionLight"));
 	ExplosionLight->AttenuationRadius = 400.0;
 	ExplosionLight->Intensity = 500.0f;
 	ExplosionLight->bUseInverseSquaredFalloff = false;
@@ -17,6 +15,7 @@ AShooterExplosionEffect::AShooterExplosionEffect(const class FPostConstructIniti
 	ExplosionLight->bVisible = true;
 
 	ExplosionLightFadeOut = 0.2f;
+	ExplosionLightCurve = NULL;
 }
 
 void AShooterExplosionEffect::BeginPlay()
@@ -28,9 +27,22 @@ void AShooterExplosionEffect::BeginPlay()
 		UGameplayStatics::SpawnEmitterAtLocation(this, ExplosionFX, GetActorLocation(), GetActorRotation());
 	}
 
-	if (ExplosionSound)
+	AShooterGameState* const MyGameState = Cast<AShooterGameState>(GetWorld()->GameState);
+	if (MyGameState)
+	{
+		MyGameState->GetLightAnimationManager().AddLight(ExplosionLight, ExplosionLight->Intensity, ExplosionLightFadeOut, ExplosionLightCurve);
+	}
+	else
 	{
-		UGameplayStatics::PlaySoundAtLocation(this, ExplosionSound, GetActorLocation());
+		ExplosionLight->SetVisibility(false);
+	}
+
+	// light is animated by the manager, actor only needs to live as long as the light
+	SetLifeSpan(FMath::Max(ExplosionLightFadeOut, KINDA_SMALL_NUMBER));
+
+	if (ExplosionSound && MyGameState)
+	{
+		MyGameState->GetAudioVoiceManager().PlaySoundAtLocation(GetWorld(), EShooterSoundCategory::Explosion, ExplosionSound, GetActorLocation());
 	}
 
 	if (Decal.DecalMaterial)
@@ -43,24 +55,4 @@ void AShooterExplosionEffect::BeginPlay()
 			SurfaceHit.ImpactPoint, RandomDecalRotation, EAttachLocation::KeepWorldPosition,
 			Decal.LifeSpan);
 	}
-}
-
-void AShooterExplosionEffect::Tick(float DeltaSeconds)
-{
-	Super::Tick(DeltaSeconds);
-
-	const float TimeAlive = GetWorld()->GetTimeSeconds() - CreationTime;
-	const float TimeRemaining = FMath::Max(0.0f, ExplosionLightFadeOut - TimeAlive);
-
-	if (TimeRemaining > 0)
-	{
-		const float FadeAlpha = 1.0f - FMath::Square(TimeRemaining / ExplosionLightFadeOut);
-
-		UPointLightComponent* DefLight = Cast<UPointLightComponent>(GetClass()->GetDefaultSubobjectByName(ExplosionLightComponentName));
-		ExplosionLight->SetBrightness(DefLight->Intensity * FadeAlpha);
-	}
-	else
-	{
-		Destroy();
-	}
-}
+}
\ No newline at end of file
@@ -1,6 +1,8 @@
 // Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
 
 #include "ShooterGame.h"
+#include "ShooterImpactEffectManager.h"
+#include "Sound/ShooterAudioVoiceManager.h"
 
 AShooterImpactEffect::AShooterImpactEffect(const class FPostConstructInitializeProperties& PCIP) : Super(PCIP)
 {
@@ -11,32 +13,43 @@ void AShooterImpactEffect::PostInitializeComponents()
 {
 	Super::PostInitializeComponents();
 
+	AShooterGameState* const MyGameState = Cast<AShooterGameState>(GetWorld()->GameState);
+	if (MyGameState == NULL)
+	{
+		return;
+	}
+
+	FShooterImpactEffectManager& EffectManager = MyGameState->GetImpactEffectManager();
+	const FVector ImpactLocation = GetActorLocation();
+
 	UPhysicalMaterial* HitPhysMat = SurfaceHit.PhysMaterial.Get();
 	EPhysicalSurface HitSurfaceType = UPhysicalMaterial::DetermineSurfaceType(HitPhysMat);
 
 	// show particles
 	UParticleSystem* ImpactFX = GetImpactFX(HitSurfaceType);
-	if (ImpactFX)
+	if (ImpactFX && EffectManager.RequestEffect(GetWorld(), EShooterImpactEffectType::Emitter, ImpactLocation))
 	{
-		UGameplayStatics::SpawnEmitterAtLocation(this, ImpactFX, GetActorLocation(), GetActorRotation());
+		UParticleSystemComponent* ImpactPSC = UGameplayStatics::SpawnEmitterAtLocation(this, ImpactFX, ImpactLocation, GetActorRotation());
+		EffectManager.AddEffect(EShooterImpactEffectType::Emitter, ImpactPSC);
 	}
 
-	// play sound
+	// play sound, voice manager owns the limit for impact sounds
 	USoundCue* ImpactSound = GetImpactSound(HitSurfaceType);
 	if (ImpactSound)
 	{
-		UGameplayStatics::PlaySoundAtLocation(this, ImpactSound, GetActorLocation());
+		MyGameState->GetAudioVoiceManager().PlaySoundAtLocation(GetWorld(), EShooterSoundCategory::Impact, ImpactSound, ImpactLocation);
 	}
 
-	if (DefaultDecal.DecalMaterial)
+	if (DefaultDecal.DecalMaterial && EffectManager.RequestEffect(GetWorld(), EShooterImpactEffectType::Decal, SurfaceHit.ImpactPoint))
 	{
 		FRotator RandomDecalRotation = SurfaceHit.ImpactNormal.Rotation();
 		RandomDecalRotation.Roll = FMath::FRandRange(-180.0f, 180.0f);
 
-		UGameplayStatics::SpawnDecalAttached(DefaultDecal.DecalMaterial, FVector(DefaultDecal.DecalSize, DefaultDecal.DecalSize, 1.0f),
+		UDecalComponent* ImpactDecal = UGameplayStatics::SpawnDecalAttached(DefaultDecal.DecalMaterial, FVector(DefaultDecal.DecalSize, DefaultDecal.DecalSize, 1.0f),
 			SurfaceHit.Component.Get(), SurfaceHit.BoneName,
 			SurfaceHit.ImpactPoint, RandomDecalRotation, EAttachLocation::KeepWorldPosition,
 			DefaultDecal.LifeSpan);
+		EffectManager.AddEffect(EShooterImpactEffectType::Decal, ImpactDecal);
 	}
 }
 
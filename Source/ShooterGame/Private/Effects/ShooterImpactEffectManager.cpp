@@ -0,0 +1,154 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "ShooterImpactEffectManager.h"
+#include "ShooterConfigSection.h"
+
+FShooterImpactEffectManager::FShooterImpactEffectManager()
+	: CachedFrame(MAX_uint64)
+{
+	static const TCHAR* TypeNames[EShooterImpactEffectType::MAX] = { TEXT("Emitter"), TEXT("Decal") };
+	static const int32 DefaultMaxPerFrame[EShooterImpactEffectType::MAX] = { 8, 8 };
+	static const int32 DefaultMaxActive[EShooterImpactEffectType::MAX] = { 48, 64 };
+	static const float DefaultCullDistance[EShooterImpactEffectType::MAX] = { 8000.0f, 6000.0f };
+
+	const FShooterConfigSection Config(TEXT("ShooterGame.ImpactEffects"));
+	for (int32 i = 0; i < EShooterImpactEffectType::MAX; i++)
+	{
+		FEffectBudget& Budget = Budgets[i];
+		Budget.MaxPerFrame = DefaultMaxPerFrame[i];
+		Budget.MaxActive = DefaultMaxActive[i];
+		Budget.CullDistance = DefaultCullDistance[i];
+		Budget.SpawnedThisFrame = 0;
+
+		Config.Get(*FString::Printf(TEXT("Max%sPerFrame"), TypeNames[i]), Budget.MaxPerFrame);
+		Config.Get(*FString::Printf(TEXT("Max%sActive"), TypeNames[i]), Budget.MaxActive);
+		Config.Get(*FString::Printf(TEXT("%sCullDistance"), TypeNames[i]), Budget.CullDistance);
+	}
+}
+
+void FShooterImpactEffectManager::ConditionalBeginFrame(UWorld* World)
+{
+	if (CachedFrame == GFrameCounter)
+	{
+		return;
+	}
+
+	CachedFrame = GFrameCounter;
+	for (int32 i = 0; i < EShooterImpactEffectType::MAX; i++)
+	{
+		Budgets[i].SpawnedThisFrame = 0;
+	}
+
+	ViewLocations.Reset();
+	ViewDirections.Reset();
+	for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+	{
+		APlayerController* PC = *It;
+		if (PC && PC->IsLocalController())
+		{
+			FVector ViewLocation;
+			FRotator ViewRotation;
+			PC->GetPlayerViewPoint(ViewLocation, ViewRotation);
+
+			ViewLocations.Add(ViewLocation);
+			ViewDirections.Add(ViewRotation.Vector());
+		}
+	}
+}
+
+void FShooterImpactEffectManager::PruneActive(UWorld* World, EShooterImpactEffectType::Type Type)
+{
+	TArray<FActiveEffect>& Active = Budgets[Type].Active;
+
+	for (int32 i = Active.Num() - 1; i >= 0; i--)
+	{
+		UActorComponent* Component = Active[i].Component.Get();
+		UParticleSystemComponent* PSC = Cast<UParticleSystemComponent>(Component);
+		if (Component == NULL || Component->IsPendingKill() || (PSC && !PSC->IsActive()))
+		{
+			Active.RemoveAt(i);
+		}
+	}
+}
+
+float FShooterImpactEffectManager::GetRelevance(EShooterImpactEffectType::Type Type, const FVector& Location) const
+{
+	const float CullDistance = Budgets[Type].CullDistance;
+	float BestRelevance = 0.0f;
+
+	for (int32 i = 0; i < ViewLocations.Num(); i++)
+	{
+		const FVector ToEffect = Location - ViewLocations[i];
+		const float Dist = ToEffect.Size();
+		if (Dist >= CullDistance)
+		{
+			continue;
+		}
+
+		float Relevance = 1.0f - Dist / CullDistance;
+
+		// effects behind the camera matter much less
+		if ((ToEffect | ViewDirections[i]) < 0.0f)
+		{
+			Relevance *= 0.25f;
+		}
+
+		BestRelevance = FMath::Max(BestRelevance, Relevance);
+	}
+
+	return BestRelevance;
+}
+
+bool FShooterImpactEffectManager::RequestEffect(UWorld* World, EShooterImpactEffectType::Type Type, const FVector& Location)
+{
+	if (World == NULL)
+	{
+		return false;
+	}
+
+	ConditionalBeginFrame(World);
+
+	const float Relevance = GetRelevance(Type, Location);
+	if (Relevance <= 0.0f)
+	{
+		return false;
+	}
+
+	// the more relevant the impact, the more of this frame's budget it can use
+	FEffectBudget& Budget = Budgets[Type];
+	if (Budget.SpawnedThisFrame >= FMath::CeilToInt(Budget.MaxPerFrame * Relevance))
+	{
+		return false;
+	}
+
+	PruneActive(World, Type);
+	if (Budget.Active.Num() >= Budget.MaxActive)
+	{
+		if (Type != EShooterImpactEffectType::Decal)
+		{
+			return false;
+		}
+
+		// recycle oldest decal
+		UActorComponent* OldestDecal = Budget.Active[0].Component.Get();
+		if (OldestDecal)
+		{
+			OldestDecal->DestroyComponent();
+		}
+		Budget.Active.RemoveAt(0);
+	}
+
+	Budget.SpawnedThisFrame++;
+	return true;
+}
+
+void FShooterImpactEffectManager::AddEffect(EShooterImpactEffectType::Type Type, UActorComponent* Component)
+{
+	if (Component)
+	{
+		FActiveEffect Effect;
+		Effect.Component = Component;
+		Budgets[Type].Active.Add(Effect);
+	}
+}
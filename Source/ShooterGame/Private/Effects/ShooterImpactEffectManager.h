@@ -0,0 +1,83 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+namespace EShooterImpactEffectType
+{
+	enum Type
+	{
+		Emitter,
+		Decal,
+		MAX,
+	};
+}
+
+/**
+ * Global budget for weapon impact effects, one per world (owned by the game state).
+ * Each effect type has a per-frame spawn limit, a cap on active instances and a cull distance.
+ * Relevance to local views decides which impacts make it into the budget, oldest decals are recycled.
+ * Impact sounds are limited by FShooterAudioVoiceManager only, so they aren't capped twice.
+ *
+ * Limits are read from [ShooterGame.ImpactEffects] in Game ini.
+ */
+class FShooterImpactEffectManager
+{
+public:
+
+	FShooterImpactEffectManager();
+
+	/** checks budget and relevance for new effect at given location, counts it against per-frame budget when allowed */
+	bool RequestEffect(UWorld* World, EShooterImpactEffectType::Type Type, const FVector& Location);
+
+	/** tracks spawned emitter or decal against total cap */
+	void AddEffect(EShooterImpactEffectType::Type Type, UActorComponent* Component);
+
+private:
+
+	/** active effect instance */
+	struct FActiveEffect
+	{
+		/** spawned component */
+		TWeakObjectPtr<UActorComponent> Component;
+	};
+
+	/** limits and bookkeeping for single effect type */
+	struct FEffectBudget
+	{
+		/** max spawned in single frame */
+		int32 MaxPerFrame;
+
+		/** max alive at once */
+		int32 MaxActive;
+
+		/** effects further from all local views are culled */
+		float CullDistance;
+
+		/** spawned in current frame */
+		int32 SpawnedThisFrame;
+
+		/** alive effects, oldest first */
+		TArray<FActiveEffect> Active;
+	};
+
+	/** refreshes local views and resets per-frame counters on first request of a frame */
+	void ConditionalBeginFrame(UWorld* World);
+
+	/** removes finished effects */
+	void PruneActive(UWorld* World, EShooterImpactEffectType::Type Type);
+
+	/** 0..1 relevance of location to local views, 0 means cull */
+	float GetRelevance(EShooterImpactEffectType::Type Type, const FVector& Location) const;
+
+	/** budgets per effect type */
+	FEffectBudget Budgets[EShooterImpactEffectType::MAX];
+
+	/** local player view locations for current frame */
+	TArray<FVector> ViewLocations;
+
+	/** local player view directions for current frame */
+	TArray<FVector> ViewDirections;
+
+	/** frame number views were gathered in */
+	uint64 CachedFrame;
+};
@@ -0,0 +1,131 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "ShooterLightAnimationManager.h"
+#include "ShooterConfigSection.h"
+
+FShooterLightAnimationManager::FShooterLightAnimationManager()
+	: MaxActiveLights(8)
+{
+	FShooterConfigSection(TEXT("ShooterGame.EffectLights")).Get(TEXT("MaxActiveLights"), MaxActiveLights);
+}
+
+float FShooterLightAnimationManager::EvaluateCurve(const FAnimatedLight& AnimatedLight, float Alpha)
+{
+	UCurveFloat* Curve = AnimatedLight.Curve.Get();
+	if (Curve)
+	{
+		return Curve->GetFloatValue(Alpha);
+	}
+
+	return 1.0f - FMath::Square(1.0f - Alpha);
+}
+
+float FShooterLightAnimationManager::GetImportance(UWorld* World, const FAnimatedLight& AnimatedLight, const TArray<FVector>& ViewLocations) const
+{
+	UPointLightComponent* Light = AnimatedLight.Light.Get();
+	if (Light == NULL)
+	{
+		return 0.0f;
+	}
+
+	float ClosestDistSq = MAX_FLT;
+	for (int32 i = 0; i < ViewLocations.Num(); i++)
+	{
+		ClosestDistSq = FMath::Min(ClosestDistSq, FVector::DistSquared(ViewLocations[i], Light->GetComponentLocation()));
+	}
+
+	// bright, fresh lights near the camera matter most
+	const float TimeLeft = AnimatedLight.Duration - (World->GetTimeSeconds() - AnimatedLight.StartTime);
+	const float DistanceScale = ClosestDistSq < MAX_FLT ? FMath::Max(1.0f, FMath::Sqrt(ClosestDistSq) / 1000.0f) : 1.0f;
+	return AnimatedLight.PeakIntensity * FMath::Max(0.0f, TimeLeft / AnimatedLight.Duration) / DistanceScale;
+}
+
+bool FShooterLightAnimationManager::AddLight(UPointLightComponent* Light, float PeakIntensity, float Duration, UCurveFloat* Curve)
+{
+	if (Light == NULL || Duration <= 0.0f)
+	{
+		return false;
+	}
+
+	UWorld* World = Light->GetWorld();
+
+	FAnimatedLight NewLight;
+	NewLight.Light = Light;
+	NewLight.Curve = Curve;
+	NewLight.PeakIntensity = PeakIntensity;
+	NewLight.StartTime = World->GetTimeSeconds();
+	NewLight.Duration = Duration;
+
+	if (Lights.Num() >= MaxActiveLights)
+	{
+		TArray<FVector> ViewLocations;
+		for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+		{
+			APlayerController* PC = *It;
+			if (PC && PC->IsLocalController())
+			{
+				FVector ViewLocation;
+				FRotator ViewRotation;
+				PC->GetPlayerViewPoint(ViewLocation, ViewRotation);
+				ViewLocations.Add(ViewLocation);
+			}
+		}
+
+		int32 WorstIndex = INDEX_NONE;
+		float WorstImportance = GetImportance(World, NewLight, ViewLocations);
+		for (int32 i = 0; i < Lights.Num(); i++)
+		{
+			const float Importance = GetImportance(World, Lights[i], ViewLocations);
+			if (Importance < WorstImportance)
+			{
+				WorstImportance = Importance;
+				WorstIndex = i;
+			}
+		}
+
+		if (WorstIndex == INDEX_NONE)
+		{
+			Light->SetVisibility(false);
+			return false;
+		}
+
+		UPointLightComponent* WorstLight = Lights[WorstIndex].Light.Get();
+		if (WorstLight)
+		{
+			WorstLight->SetVisibility(false);
+		}
+		Lights.RemoveAtSwap(WorstIndex);
+	}
+
+	Light->SetBrightness(PeakIntensity * EvaluateCurve(NewLight, 0.0f));
+	Lights.Add(NewLight);
+	return true;
+}
+
+void FShooterLightAnimationManager::Tick(UWorld* World)
+{
+	const float CurrentTime = World->GetTimeSeconds();
+
+	for (int32 i = Lights.Num() - 1; i >= 0; i--)
+	{
+		const FAnimatedLight& AnimatedLight = Lights[i];
+		UPointLightComponent* Light = AnimatedLight.Light.Get();
+		if (Light == NULL || Light->IsPendingKill())
+		{
+			Lights.RemoveAtSwap(i);
+			continue;
+		}
+
+		const float Alpha = (CurrentTime - AnimatedLight.StartTime) / AnimatedLight.Duration;
+		if (Alpha >= 1.0f)
+		{
+			Light->SetVisibility(false);
+			Lights.RemoveAtSwap(i);
+		}
+		else
+		{
+			Light->SetBrightness(AnimatedLight.PeakIntensity * EvaluateCurve(AnimatedLight, Alpha));
+		}
+	}
+}
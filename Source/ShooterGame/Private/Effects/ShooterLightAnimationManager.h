@@ -0,0 +1,62 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+/**
+ * Animates transient effect lights (explosions etc.) in a single pass, one per world (owned by the game state).
+ * Caps number of active dynamic lights, dropping the least important one when full.
+ *
+ * Cap is read from [ShooterGame.EffectLights] in Game ini.
+ */
+class FShooterLightAnimationManager
+{
+public:
+
+	FShooterLightAnimationManager();
+
+	/**
+	 * Starts animating light, returns false when it was dropped because of the cap.
+	 *
+	 * @param	Light			light to animate, hidden when animation ends
+	 * @param	PeakIntensity	intensity for curve value of 1
+	 * @param	Duration		animation length in seconds
+	 * @param	Curve			intensity over normalized time, default fade in curve if not set
+	 */
+	bool AddLight(UPointLightComponent* Light, float PeakIntensity, float Duration, UCurveFloat* Curve = NULL);
+
+	/** updates all lights */
+	void Tick(UWorld* World);
+
+private:
+
+	/** single animated light */
+	struct FAnimatedLight
+	{
+		/** light component */
+		TWeakObjectPtr<UPointLightComponent> Light;
+
+		/** intensity curve, optional */
+		TWeakObjectPtr<UCurveFloat> Curve;
+
+		/** intensity for curve value of 1 */
+		float PeakIntensity;
+
+		/** world time when animation started */
+		float StartTime;
+
+		/** animation length */
+		float Duration;
+	};
+
+	/** curve value at normalized time */
+	static float EvaluateCurve(const FAnimatedLight& AnimatedLight, float Alpha);
+
+	/** how much light matters to local views, higher is more important */
+	float GetImportance(UWorld* World, const FAnimatedLight& AnimatedLight, const TArray<FVector>& ViewLocations) const;
+
+	/** max lights animated at once */
+	int32 MaxActiveLights;
+
+	/** currently animated lights */
+	TArray<FAnimatedLight> Lights;
+};
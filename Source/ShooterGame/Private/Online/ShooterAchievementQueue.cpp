@@ -0,0 +1,410 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "ShooterAchievementQueue.h"
+#include "ShooterConfigSection.h"
+#include "ShooterDevHelper.h"
+
+#if !UE_BUILD_SHIPPING
+static void FlushAchievements()
+{
+	FShooterAchievementQueue::Get().FlushAll();
+	FShooterAchievementQueue::Get().Dump();
+}
+
+static FAutoConsoleCommand CmdFlushAchievements(
+	TEXT("Shooter.FlushAchievements"),
+	TEXT("Writes pending achievement progress now and logs the state of the achievement queue"),
+	FConsoleCommandDelegate::CreateStatic(FlushAchievements)
+	);
+
+struct FShooterAchievementQueueTest
+{
+	/** returns saved progress of achievement, negative if none is saved */
+	static float GetSaved(const UShooterPersistentUser* PersistentUser, const FString& Id)
+	{
+		const TArray<FShooterPendingAchievement>& Saved = PersistentUser->GetPendingAchievements();
+		for (int32 i = 0; i < Saved.Num(); i++)
+		{
+			if (Saved[i].Id == Id)
+			{
+				return Saved[i].Percent;
+			}
+		}
+
+		return -1.0f;
+	}
+
+	/** merges progress of test achievement, fails its write and checks merged progress was saved, then drops it again */
+	static void AchievementQueue()
+	{
+		UWorld* World = ShooterDevHelper::GetWorld();
+		AShooterPlayerController* PC = World ? Cast<AShooterPlayerController>(World->GetFirstPlayerController()) : NULL;
+		ULocalPlayer* LocalPlayer = PC ? Cast<ULocalPlayer>(PC->Player) : NULL;
+		UShooterPersistentUser* PersistentUser = PC ? PC->GetPersistentUser() : NULL;
+		if (LocalPlayer == NULL || PersistentUser == NULL)
+		{
+			UE_LOG(LogOnline, Warning, TEXT("TestAchievementQueue: needs a local player with a persistent user"));
+			return;
+		}
+
+		FShooterAchievementQueue& Queue = FShooterAchievementQueue::Get();
+		FShooterAchievementQueue::FUserQueue& User = Queue.FindOrAddUser(LocalPlayer->ControllerId);
+		if (User.WriteObject.IsValid())
+		{
+			UE_LOG(LogOnline, Warning, TEXT("TestAchievementQueue: write in flight for controller %d, try again later"), LocalPlayer->ControllerId);
+			return;
+		}
+
+		const FString Id(TEXT("ShooterTest_AchievementQueue"));
+		const float RetryDelay = User.RetryDelay;
+
+		Queue.UpdateProgress(LocalPlayer->ControllerId, PersistentUser, Id, 25.0f);
+		Queue.UpdateProgress(LocalPlayer->ControllerId, PersistentUser, Id, 60.0f);
+		Queue.UpdateProgress(LocalPlayer->ControllerId, PersistentUser, Id, 40.0f);
+
+		// still coalescing, a tick mustn't save
+		User.FlushDelay = FMath::Max(User.FlushDelay, 1.0f);
+		Queue.Tick(0.0f);
+		const float SavedBeforeWrite = GetSaved(PersistentUser, Id);
+
+		// write the way StartWrite does, then have it fail
+		User.WriteObject = MakeShareable(new FOnlineAchievementsWrite());
+		User.InFlight = User.Pending;
+		User.Pending.Empty();
+		User.WriteObject->WriteState = EOnlineAsyncTaskState::Failed;
+		Queue.Tick(0.0f);
+		const float SavedAfterFailure = GetSaved(PersistentUser, Id);
+
+		// drop test achievement so it's never written or retried
+		User.Pending.Remove(Id);
+		User.RetryDelay = RetryDelay;
+		Queue.SavePending(User);
+
+		const bool bPassed = SavedBeforeWrite < 0.0f && SavedAfterFailure == 60.0f && GetSaved(PersistentUser, Id) < 0.0f;
+		UE_LOG(LogOnline, Log, TEXT("TestAchievementQueue: progress 25, 60, 40 saved as %.0f while coalescing, %.0f after failed write (expected none, 60)%s"),
+			SavedBeforeWrite, SavedAfterFailure, bPassed ? TEXT("") : TEXT(" - MISMATCH"));
+	}
+};
+
+static FAutoConsoleCommand CmdTestAchievementQueue(
+	TEXT("Shooter.TestAchievementQueue"),
+	TEXT("Queues progress of a test achievement for the first local player, fails its write and checks the merged progress was saved"),
+	FConsoleCommandDelegate::CreateStatic(FShooterAchievementQueueTest::AchievementQueue)
+	);
+#endif
+
+FShooterAchievementQueue& FShooterAchievementQueue::Get()
+{
+	static FShooterAchievementQueue Instance;
+	return Instance;
+}
+
+FShooterAchievementQueue::FShooterAchievementQueue()
+	: CoalesceDelay(1.0f)
+	, InitialRetryDelay(5.0f)
+	, MaxRetryDelay(120.0f)
+{
+	const FShooterConfigSection Config(TEXT("ShooterGame.Achievements"));
+	Config.Get(TEXT("CoalesceDelay"), CoalesceDelay);
+	Config.Get(TEXT("RetryDelay"), InitialRetryDelay);
+	Config.Get(TEXT("MaxRetryDelay"), MaxRetryDelay);
+	MaxRetryDelay = FMath::Max(MaxRetryDelay, InitialRetryDelay);
+
+	FWorldDelegates::OnWorldCleanup.AddRaw(this, &FShooterAchievementQueue::HandleWorldCleanup);
+}
+
+FShooterAchievementQueue::~FShooterAchievementQueue()
+{
+	FWorldDelegates::OnWorldCleanup.RemoveRaw(this, &FShooterAchievementQueue::HandleWorldCleanup);
+}
+
+void FShooterAchievementQueue::HandleWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources)
+{
+	SaveAll();
+}
+
+FShooterAchievementQueue::FUserQueue& FShooterAchievementQueue::FindOrAddUser(int32 UserIndex)
+{
+	for (int32 i = 0; i < Users.Num(); i++)
+	{
+		if (Users[i].UserIndex == UserIndex)
+		{
+			return Users[i];
+		}
+	}
+
+	FUserQueue& User = Users[Users.AddDefaulted()];
+	User.UserIndex = UserIndex;
+	User.RetryDelay = InitialRetryDelay;
+	return User;
+}
+
+void FShooterAchievementQueue::AddUser(int32 UserIndex, UShooterPersistentUser* PersistentUser)
+{
+	SetPersistentUser(FindOrAddUser(UserIndex), PersistentUser);
+}
+
+void FShooterAchievementQueue::SetPersistentUser(FUserQueue& User, UShooterPersistentUser* PersistentUser)
+{
+	if (PersistentUser == NULL || User.PersistentUser.Get() == PersistentUser)
+	{
+		return;
+	}
+
+	// different profile signed in on this controller, queued progress belongs to the previous one
+	// and is retried when it signs in again, a write still in flight for it is no longer tracked
+	if (User.PersistentUser.IsValid())
+	{
+		SavePending(User);
+
+		User.Pending.Empty();
+		User.InFlight.Empty();
+		User.Written.Empty();
+		User.WriteObject.Reset();
+		User.RetryDelay = InitialRetryDelay;
+	}
+	User.PersistentUser = PersistentUser;
+
+	// progress queued before there was a persistent user still needs saving, what's loaded is saved already
+	const bool bHadPending = User.Pending.Num() > 0;
+	const TArray<FShooterPendingAchievement>& Saved = PersistentUser->GetPendingAchievements();
+	User.bHasSaved = Saved.Num() > 0;
+	for (int32 i = 0; i < Saved.Num(); i++)
+	{
+		MergePending(User, Saved[i].Id, Saved[i].Percent);
+	}
+	User.bSaveNeeded = bHadPending;
+
+	if (User.bHasSaved)
+	{
+		UE_LOG(LogOnline, Log, TEXT("Retrying %d achievement updates saved before they were written"), Saved.Num());
+		User.FlushDelay = 0.0f;
+	}
+}
+
+bool FShooterAchievementQueue::MergePending(FUserQueue& User, const FString& Id, float Percent)
+{
+	const float* Written = User.Written.Find(Id);
+	const float* InFlight = User.InFlight.Find(Id);
+	if ((Written && *Written >= Percent) || (InFlight && *InFlight >= Percent))
+	{
+		return false;
+	}
+
+	float* Pending = User.Pending.Find(Id);
+	if (Pending == NULL)
+	{
+		// nothing queued yet, start coalescing
+		if (User.Pending.Num() == 0 && !User.WriteObject.IsValid())
+		{
+			User.FlushDelay = CoalesceDelay;
+		}
+		User.Pending.Add(Id, Percent);
+	}
+	else if (*Pending < Percent)
+	{
+		*Pending = Percent;
+	}
+	else
+	{
+		return false;
+	}
+
+	User.bSaveNeeded = true;
+	return true;
+}
+
+void FShooterAchievementQueue::UpdateProgress(int32 UserIndex, UShooterPersistentUser* PersistentUser, const FString& Id, float Percent)
+{
+	FUserQueue& User = FindOrAddUser(UserIndex);
+	SetPersistentUser(User, PersistentUser);
+	MergePending(User, Id, FMath::Clamp(Percent, 0.0f, 100.0f));
+}
+
+void FShooterAchievementQueue::SetKnownProgress(int32 UserIndex, const FString& Id, float Percent)
+{
+	FUserQueue& User = FindOrAddUser(UserIndex);
+
+	float& Written = User.Written.FindOrAdd(Id);
+	Written = FMath::Max(Written, Percent);
+
+	const float* Pending = User.Pending.Find(Id);
+	if (Pending && *Pending <= Written)
+	{
+		User.Pending.Remove(Id);
+		User.bSaveNeeded = true;
+	}
+}
+
+void FShooterAchievementQueue::FlushAll()
+{
+	for (int32 i = 0; i < Users.Num(); i++)
+	{
+		Users[i].FlushDelay = 0.0f;
+	}
+}
+
+void FShooterAchievementQueue::SaveAll()
+{
+	for (int32 i = 0; i < Users.Num(); i++)
+	{
+		if (Users[i].bSaveNeeded)
+		{
+			SavePending(Users[i]);
+		}
+	}
+}
+
+void FShooterAchievementQueue::StartWrite(FUserQueue& User)
+{
+	TSharedPtr<FUniqueNetId> UserId;
+	IOnlineAchievementsPtr Achievements;
+
+	IOnlineSubsystem* OnlineSub = IOnlineSubsystem::Get();
+	if (OnlineSub)
+	{
+		IOnlineIdentityPtr Identity = OnlineSub->GetIdentityInterface();
+		if (Identity.IsValid())
+		{
+			UserId = Identity->GetUniquePlayerId(User.UserIndex);
+		}
+		Achievements = OnlineSub->GetAchievementsInterface();
+	}
+
+	if (!UserId.IsValid() || !Achievements.IsValid())
+	{
+		UE_LOG(LogOnline, Log, TEXT("No achievements interface or user id for controller %d, keeping %d achievement updates"), User.UserIndex, User.Pending.Num());
+		HandleWriteFailure(User);
+		return;
+	}
+
+	User.WriteObject = MakeShareable(new FOnlineAchievementsWrite());
+	for (TMap<FString, float>::TConstIterator It(User.Pending); It; ++It)
+	{
+		User.WriteObject->SetFloatStat(*It.Key(), It.Value());
+	}
+	User.InFlight = User.Pending;
+	User.Pending.Empty();
+
+	// saved once per batch rather than once per update, so a burst of updates costs one save
+	if (User.bSaveNeeded)
+	{
+		SavePending(User);
+	}
+
+	UE_LOG(LogOnline, Verbose, TEXT("Writing %d achievement updates for controller %d"), User.InFlight.Num(), User.UserIndex);
+
+	FOnlineAchievementsWriteRef WriteObjectRef = User.WriteObject.ToSharedRef();
+	Achievements->WriteAchievements(*UserId.Get(), WriteObjectRef);
+}
+
+void FShooterAchievementQueue::HandleWriteFailure(FUserQueue& User)
+{
+	for (TMap<FString, float>::TConstIterator It(User.InFlight); It; ++It)
+	{
+		float& Pending = User.Pending.FindOrAdd(It.Key());
+		Pending = FMath::Max(Pending, It.Value());
+	}
+	User.InFlight.Empty();
+	User.WriteObject.Reset();
+
+	User.FlushDelay = User.RetryDelay;
+	User.RetryDelay = FMath::Min(User.RetryDelay * 2.0f, MaxRetryDelay);
+
+	// retried after a restart if it keeps failing until then
+	SavePending(User);
+}
+
+void FShooterAchievementQueue::SavePending(FUserQueue& User)
+{
+	UShooterPersistentUser* PersistentUser = User.PersistentUser.Get();
+	if (PersistentUser == NULL)
+	{
+		return;
+	}
+
+	TArray<FShooterPendingAchievement> Saved;
+	Saved.Reserve(User.Pending.Num() + User.InFlight.Num());
+	for (TMap<FString, float>::TConstIterator It(User.Pending); It; ++It)
+	{
+		Saved.Add(FShooterPendingAchievement(It.Key(), It.Value()));
+	}
+	for (TMap<FString, float>::TConstIterator It(User.InFlight); It; ++It)
+	{
+		if (!User.Pending.Contains(It.Key()))
+		{
+			Saved.Add(FShooterPendingAchievement(It.Key(), It.Value()));
+		}
+	}
+
+	PersistentUser->SetPendingAchievements(Saved);
+	PersistentUser->SaveIfDirty();
+
+	User.bSaveNeeded = false;
+	User.bHasSaved = Saved.Num() > 0;
+}
+
+bool FShooterAchievementQueue::Tick(float DeltaSeconds)
+{
+	for (int32 UserIdx = 0; UserIdx < Users.Num(); UserIdx++)
+	{
+		FUserQueue& User = Users[UserIdx];
+
+		if (User.WriteObject.IsValid())
+		{
+			const EOnlineAsyncTaskState::Type WriteState = User.WriteObject->WriteState;
+			if (WriteState == EOnlineAsyncTaskState::Done)
+			{
+				for (TMap<FString, float>::TConstIterator It(User.InFlight); It; ++It)
+				{
+					float& Written = User.Written.FindOrAdd(It.Key());
+					Written = FMath::Max(Written, It.Value());
+				}
+				User.InFlight.Empty();
+				User.WriteObject.Reset();
+				User.RetryDelay = InitialRetryDelay;
+
+				// saved progress went out, cleared with the next save so it isn't retried after restart
+				User.bSaveNeeded |= User.bHasSaved;
+			}
+			else if (WriteState == EOnlineAsyncTaskState::Failed)
+			{
+				UE_LOG(LogOnline, Warning, TEXT("Achievements write failed for controller %d, retrying in %.0fs"), User.UserIndex, User.RetryDelay);
+				HandleWriteFailure(User);
+			}
+			continue;
+		}
+
+		if (User.Pending.Num() > 0)
+		{
+			User.FlushDelay -= DeltaSeconds;
+			if (User.FlushDelay <= 0.0f)
+			{
+				StartWrite(User);
+			}
+		}
+	}
+
+	return true;
+}
+
+void FShooterAchievementQueue::Dump() const
+{
+	for (int32 UserIdx = 0; UserIdx < Users.Num(); UserIdx++)
+	{
+		const FUserQueue& User = Users[UserIdx];
+		UE_LOG(LogOnline, Log, TEXT("Achievements of controller %d: %d pending (write in %.1fs), %d in flight, %d written, %s"),
+			User.UserIndex, User.Pending.Num(), FMath::Max(User.FlushDelay, 0.0f), User.InFlight.Num(), User.Written.Num(),
+			User.bHasSaved ? TEXT("saved locally") : TEXT("nothing saved"));
+
+		for (TMap<FString, float>::TConstIterator It(User.Pending); It; ++It)
+		{
+			UE_LOG(LogOnline, Log, TEXT("  pending %s %.0f%%"), *It.Key(), It.Value());
+		}
+		for (TMap<FString, float>::TConstIterator It(User.InFlight); It; ++It)
+		{
+			UE_LOG(LogOnline, Log, TEXT("  in flight %s %.0f%%"), *It.Key(), It.Value());
+		}
+	}
+}
@@ -0,0 +1,132 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "OnlineAchievementsInterface.h"
+
+/**
+ * Queues achievement progress of local players and writes it through the online achievements interface.
+ * Updates of the same achievement are merged keeping the highest progress, anything already written or in flight
+ * is dropped, and whatever is pending after a short coalescing delay goes out as a single batched write per player.
+ * Progress not written yet is saved in the player's persistent user when its write starts, when a write fails,
+ * when another profile signs in on the controller and when a world is cleaned up for travel or exit, and retried
+ * after a restart; progress still coalescing when the game crashes is lost. Failed writes, or writes that can't start
+ * because the subsystem has no achievements (e.g. the null one), keep their progress pending and retry with back off.
+ * Lives outside of the world so progress reported right before map travel isn't lost with the player controller.
+ * Tuned in [ShooterGame.Achievements] of the Game ini.
+ *
+ * Outside of shipping builds "Shooter.TestAchievementQueue" merges progress of a test achievement, fails its write
+ * and checks the merged progress was saved.
+ */
+class FShooterAchievementQueue : public FTickerObjectBase
+{
+public:
+
+	/** returns the queue */
+	static FShooterAchievementQueue& Get();
+
+	/** starts tracking local player, picking up progress saved by failed writes */
+	void AddUser(int32 UserIndex, class UShooterPersistentUser* PersistentUser);
+
+	/** queues progress (0 to 100) of achievement */
+	void UpdateProgress(int32 UserIndex, class UShooterPersistentUser* PersistentUser, const FString& Id, float Percent);
+
+	/** records progress read back from the online service, so it isn't written again */
+	void SetKnownProgress(int32 UserIndex, const FString& Id, float Percent);
+
+	/** starts writes of everything pending on next tick */
+	void FlushAll();
+
+	/** saves progress of every user that changed since last save */
+	void SaveAll();
+
+	/** logs pending, in flight and written progress of every user */
+	void Dump() const;
+
+	/** starts and polls writes */
+	virtual bool Tick(float DeltaSeconds) OVERRIDE;
+
+private:
+
+	friend struct FShooterAchievementQueueTest;
+
+	FShooterAchievementQueue();
+
+	~FShooterAchievementQueue();
+
+	/** saves progress before travel or exit takes the world down */
+	void HandleWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources);
+
+	/** achievement progress of local player */
+	struct FUserQueue
+	{
+		/** controller id of local player */
+		int32 UserIndex;
+
+		/** record pending progress is saved in */
+		TWeakObjectPtr<class UShooterPersistentUser> PersistentUser;
+
+		/** progress waiting for next write */
+		TMap<FString, float> Pending;
+
+		/** progress of write in flight */
+		TMap<FString, float> InFlight;
+
+		/** progress the online service already has */
+		TMap<FString, float> Written;
+
+		/** write in flight */
+		FOnlineAchievementsWritePtr WriteObject;
+
+		/** time left until pending progress is written */
+		float FlushDelay;
+
+		/** back off used if next write fails */
+		float RetryDelay;
+
+		/** pending progress changed since it was last saved */
+		bool bSaveNeeded;
+
+		/** persistent user holds pending progress */
+		bool bHasSaved;
+
+		FUserQueue()
+			: UserIndex(0)
+			, FlushDelay(0.0f)
+			, RetryDelay(0.0f)
+			, bSaveNeeded(false)
+			, bHasSaved(false)
+		{
+		}
+	};
+
+	/** returns queue of local player, adds one if missing */
+	FUserQueue& FindOrAddUser(int32 UserIndex);
+
+	/** switches queue to persistent user, loading progress it has pending */
+	void SetPersistentUser(FUserQueue& User, class UShooterPersistentUser* PersistentUser);
+
+	/** merges progress into pending, returns false if it's not ahead of anything known */
+	bool MergePending(FUserQueue& User, const FString& Id, float Percent);
+
+	/** writes everything pending in one batch */
+	void StartWrite(FUserQueue& User);
+
+	/** moves write back to pending and schedules retry */
+	void HandleWriteFailure(FUserQueue& User);
+
+	/** saves pending and in flight progress in persistent user */
+	void SavePending(FUserQueue& User);
+
+	/** delay between first queued update and write, lets bursts end up in one batch */
+	float CoalesceDelay;
+
+	/** delay before first retry of failed write */
+	float InitialRetryDelay;
+
+	/** retry delay doubles after each failure up to this */
+	float MaxRetryDelay;
+
+	/** queues of local players */
+	TArray<FUserQueue> Users;
+};
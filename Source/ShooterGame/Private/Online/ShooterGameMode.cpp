@@ -3,6 +3,85 @@
 #include "ShooterGame.h"
 #include "ShooterGameKing.h"
 #include "ShooterSpectatorPawn.h"
+#include "ShooterPawnSpatialIndex.h"
+#include "Online/ShooterServerBudget.h"
+#include "Online/ShooterKillCamRecorder.h"
+#include "Pickups/ShooterPickupRegistry.h"
+#include "Pickups/ShooterPickupScheduler.h"
+#include "Bots/ShooterPerceptionBus.h"
+#include "Online/ShooterNetAccounting.h"
+#include "ShooterDevHelper.h"
+
+#if !UE_BUILD_SHIPPING
+static void TestDamageQueue(const TArray<FString>& Args)
+{
+	UWorld* World = ShooterDevHelper::GetWorld();
+	AShooterGameMode* Game = World ? World->GetAuthGameMode<AShooterGameMode>() : NULL;
+	AShooterCharacter* Victim = ShooterDevHelper::GetTestPawn(World);
+	if (Game == NULL || Victim == NULL)
+	{
+		UE_LOG(LogShooter, Warning, TEXT("TestDamageQueue: needs a game with authority and a live pawn"));
+		return;
+	}
+
+	const int32 NumHits = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 3;
+	const float HitDamage = Args.Num() > 1 ? FCString::Atof(*Args[1]) : 10.0f;
+
+	// resolve what gameplay queued so far, so the flush below only sees the test hits
+	Game->FlushPendingDamage();
+
+	const float HealthBefore = Victim->Health;
+	FDamageEvent DamageEvent(UDamageType::StaticClass());
+	for (int32 i = 0; i < NumHits; i++)
+	{
+		Victim->TakeDamage(HitDamage, DamageEvent, NULL, NULL);
+	}
+	const float HealthQueued = Victim->Health;
+
+	Game->FlushPendingDamage();
+
+	UE_LOG(LogShooter, Log, TEXT("TestDamageQueue: %d hits of %.1f on %s, health %.1f, %.1f after queuing (expected unchanged), %.1f after flush (expected %.1f in one hit)%s"),
+		NumHits, HitDamage, *Victim->GetName(), HealthBefore, HealthQueued, Victim->Health, HealthBefore - NumHits * HitDamage,
+		Victim->IsAlive() ? TEXT("") : TEXT(", killed"));
+}
+
+static FAutoConsoleCommand CmdTestDamageQueue(
+	TEXT("Shooter.TestDamageQueue"),
+	TEXT("Queues hits on a pawn in one frame and logs its health before and after they are resolved, optional arguments: hits, damage per hit"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(TestDamageQueue)
+	);
+
+static void TestExplosion(const TArray<FString>& Args)
+{
+	UWorld* World = ShooterDevHelper::GetWorld();
+	AShooterGameMode* Game = World ? World->GetAuthGameMode<AShooterGameMode>() : NULL;
+	AShooterCharacter* Pawn = ShooterDevHelper::GetTestPawn(World);
+	if (Game == NULL || Pawn == NULL)
+	{
+		UE_LOG(LogShooter, Warning, TEXT("TestExplosion: needs a game with authority and a live pawn"));
+		return;
+	}
+
+	const float Radius = Args.Num() > 0 ? FCString::Atof(*Args[0]) : 300.0f;
+	const float BaseDamage = Args.Num() > 1 ? FCString::Atof(*Args[1]) : 100.0f;
+	const FVector Origin = Pawn->GetActorLocation() + Pawn->GetActorRotation().Vector() * (Radius * 0.5f);
+
+	TArray<FShooterExplosionHit> Hits;
+	Game->GatherExplosionHits(BaseDamage, Origin, Radius, NULL, Hits);
+
+	UE_LOG(LogShooter, Log, TEXT("TestExplosion: %.0f damage within %.0f at %s, %d pawns in falloff"), BaseDamage, Radius, *Origin.ToString(), Hits.Num());
+	for (int32 i = 0; i < Hits.Num(); i++)
+	{
+		UE_LOG(LogShooter, Log, TEXT("  %s: %.1f damage%s"), *Hits[i].Victim->GetName(), Hits[i].Damage, Hits[i].bOccluded ? TEXT(", occluded") : TEXT(""));
+	}
+}
+
+static FAutoConsoleCommand CmdTestExplosion(
+	TEXT("Shooter.TestExplosion"),
+	TEXT("Logs pawns an explosion in front of a pawn would damage, without applying it, optional arguments: radius, damage"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(TestExplosion)
+	);
+#endif
 
 AShooterGameMode::AShooterGameMode(const class FPostConstructInitializeProperties& PCIP) : Super(PCIP)
 {
@@ -24,6 +103,9 @@ AShooterGameMode::AShooterGameMode(const class FPostConstructInitializePropertie
 
 	// need to tick when paused to check king state.
 	SetTickableWhenPaused(true);	
+
+	// tick after timers and physics, so all damage dealt this frame is flushed in one go
+	PrimaryActorTick.TickGroup = TG_PostUpdateWork;
 }
 
 FString AShooterGameMode::GetBotsCountOptionName()
@@ -148,6 +230,9 @@ void AShooterGameMode::FinishMatch()
 
 		// set up to restart the match
 		MyGameState->RemainingTime = TimeBetweenMatches;
+
+		GetServerBudget().LogSummary();
+		FShooterNetAccounting::Get().FlushToCSV(GetWorld()->GetMapName());
 	}
 }
 
@@ -315,13 +400,36 @@ void AShooterGameMode::Killed(AController* Killer, AController* KilledPlayer, AP
 	if (KillerPlayerState && KillerPlayerState != VictimPlayerState)
 	{
 		KillerPlayerState->ScoreKill(VictimPlayerState, KillScore);
-		KillerPlayerState->InformAboutKill(KillerPlayerState, DamageType, VictimPlayerState);
+
+		// kill credit goes straight to the killer, the kill event ring can be overrun between net updates
+		AShooterPlayerController* const KillerPC = Cast<AShooterPlayerController>(Killer);
+		if (KillerPC)
+		{
+			KillerPC->ClientOnKill();
+		}
 	}
 
 	if (VictimPlayerState)
 	{
 		VictimPlayerState->ScoreDeath(KillerPlayerState, DeathScore);
-		VictimPlayerState->BroadcastDeath(KillerPlayerState, DamageType, VictimPlayerState);
+
+		// kill feed and death messages go out through the game state's kill event stream
+		AShooterGameState* const MyGameState = Cast<AShooterGameState>(GameState);
+		if (MyGameState)
+		{
+			MyGameState->AddKillEvent(KillerPlayerState, VictimPlayerState, DamageType);
+		}
+	}
+
+	// send kill-cam once, instead of keeping the killer relevant to the dead player
+	AShooterPlayerController* VictimPC = Cast<AShooterPlayerController>(KilledPlayer);
+	if (VictimPC && KilledPawn)
+	{
+		FShooterKillCamClip Clip;
+		if (GetKillCamRecorder().BuildClip(KilledPawn, Killer ? Killer->GetPawn() : NULL, Clip))
+		{
+			VictimPC->ClientPlayKillCam(Clip);
+		}
 	}
 }
 
@@ -351,6 +459,228 @@ float AShooterGameMode::ModifyDamage(float Damage, AActor* DamagedActor, struct
 	return ActualDamage;
 }
 
+void AShooterGameMode::QueueDamage(AShooterCharacter* Victim, float Damage, struct FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser)
+{
+	for (int32 i = 0; i < PendingDamage.Num(); i++)
+	{
+		FShooterPendingDamage& Entry = PendingDamage[i];
+		if (Entry.Victim.Get() == Victim && Entry.EventInstigator.Get() == EventInstigator)
+		{
+			// same victim and instigator this frame, accumulate
+			Entry.Damage += Damage;
+			Entry.DamageCauser = DamageCauser;
+			Entry.HitInfo.SetDamageEvent(DamageEvent);
+			Entry.NumHits++;
+			return;
+		}
+	}
+
+	FShooterPendingDamage NewEntry;
+	NewEntry.Victim = Victim;
+	NewEntry.EventInstigator = EventInstigator;
+	NewEntry.DamageCauser = DamageCauser;
+	NewEntry.Damage = Damage;
+	NewEntry.NumHits = 1;
+	NewEntry.HitInfo.SetDamageEvent(DamageEvent);
+	PendingDamage.Add(NewEntry);
+}
+
+void AShooterGameMode::FlushPendingDamage()
+{
+	if (PendingDamage.Num() == 0)
+	{
+		return;
+	}
+
+	// damage dealt while resolving (e.g. from death effects) goes to the next frame
+	TArray<FShooterPendingDamage> FrameDamage;
+	Exchange(FrameDamage, PendingDamage);
+
+	TArray<FShooterPendingDamage> VictimDamage;
+	for (int32 i = 0; i < FrameDamage.Num(); i++)
+	{
+		AShooterCharacter* Victim = FrameDamage[i].Victim.Get();
+		if (Victim == NULL || FrameDamage[i].NumHits == 0)
+		{
+			continue;
+		}
+
+		VictimDamage.Reset();
+		for (int32 j = i; j < FrameDamage.Num(); j++)
+		{
+			FShooterPendingDamage& Entry = FrameDamage[j];
+			if (Entry.NumHits > 0 && Entry.Victim.Get() == Victim)
+			{
+				// friendly fire and self damage rules, once per instigator
+				Entry.Damage = ModifyDamage(Entry.Damage, Victim, Entry.HitInfo.GetDamageEvent(), Entry.EventInstigator.Get(), Entry.DamageCauser.Get());
+				VictimDamage.Add(Entry);
+				Entry.NumHits = 0;
+			}
+		}
+
+		Victim->ApplyPendingDamage(VictimDamage);
+	}
+}
+
+FShooterPawnSpatialIndex& AShooterGameMode::GetPawnSpatialIndex()
+{
+	if (!PawnSpatialIndex.IsValid())
+	{
+		PawnSpatialIndex = MakeShareable(new FShooterPawnSpatialIndex());
+	}
+
+	return *PawnSpatialIndex;
+}
+
+FShooterServerBudget& AShooterGameMode::GetServerBudget()
+{
+	if (!ServerBudget.IsValid())
+	{
+		ServerBudget = MakeShareable(new FShooterServerBudget());
+	}
+
+	return *ServerBudget;
+}
+
+FShooterKillCamRecorder& AShooterGameMode::GetKillCamRecorder()
+{
+	if (!KillCamRecorder.IsValid())
+	{
+		KillCamRecorder = MakeShareable(new FShooterKillCamRecorder());
+	}
+
+	return *KillCamRecorder;
+}
+
+FShooterPickupRegistry& AShooterGameMode::GetPickupRegistry()
+{
+	if (!PickupRegistry.IsValid())
+	{
+		PickupRegistry = MakeShareable(new FShooterPickupRegistry());
+	}
+
+	return *PickupRegistry;
+}
+
+FShooterPickupScheduler& AShooterGameMode::GetPickupScheduler()
+{
+	if (!PickupScheduler.IsValid())
+	{
+		PickupScheduler = MakeShareable(new FShooterPickupScheduler());
+	}
+
+	return *PickupScheduler;
+}
+
+FShooterPerceptionBus& AShooterGameMode::GetPerceptionBus()
+{
+	if (!PerceptionBus.IsValid())
+	{
+		PerceptionBus = MakeShareable(new FShooterPerceptionBus());
+	}
+
+	return *PerceptionBus;
+}
+
+void AShooterGameMode::GatherExplosionHits(float BaseDamage, const FVector& Origin, float Radius, AActor* DamageCauser, TArray<FShooterExplosionHit>& OutHits)
+{
+	static FName ExplosionDamageTag = FName(TEXT("ExplosionDamage"));
+
+	if (Radius <= 0.0f || BaseDamage <= 0.0f)
+	{
+		return;
+	}
+
+	TArray<AShooterCharacter*> Candidates;
+	GetPawnSpatialIndex().QuerySphere(GetWorld(), Origin, Radius, Candidates);
+
+	// falloff against the capsule first, so only pawns that would take damage get traced
+	for (int32 i = 0; i < Candidates.Num(); i++)
+	{
+		AShooterCharacter* Victim = Candidates[i];
+		UCapsuleComponent* Capsule = Victim->CapsuleComponent;
+
+		// closest point on capsule surface
+		const FVector Center = Victim->GetActorLocation();
+		const float CapsuleRadius = Capsule->GetScaledCapsuleRadius();
+		const FVector AxisOffset(0.0f, 0.0f, FMath::Max(0.0f, Capsule->GetScaledCapsuleHalfHeight() - CapsuleRadius));
+		const FVector AxisPoint = FMath::ClosestPointOnSegment(Origin, Center - AxisOffset, Center + AxisOffset);
+		const float AxisDist = (Origin - AxisPoint).Size();
+		const float Dist = FMath::Max(0.0f, AxisDist - CapsuleRadius);
+
+		const float Damage = BaseDamage * (1.0f - Dist / Radius);
+		if (Damage <= 0.0f)
+		{
+			continue;
+		}
+
+		FShooterExplosionHit Hit;
+		Hit.Victim = Victim;
+		Hit.Damage = Damage;
+		Hit.Location = Dist > 0.0f ? AxisPoint + (Origin - AxisPoint) * (CapsuleRadius / AxisDist) : Origin;
+		OutHits.Add(Hit);
+	}
+
+	if (OutHits.Num() == 0)
+	{
+		return;
+	}
+
+	// occlusion of all hits in one pass from the shared origin, pawns don't shield each other, only world geometry blocks the blast
+	FCollisionQueryParams TraceParams(ExplosionDamageTag, false, DamageCauser);
+	for (int32 i = 0; i < Candidates.Num(); i++)
+	{
+		TraceParams.AddIgnoredActor(Candidates[i]);
+	}
+
+	UWorld* World = GetWorld();
+	for (int32 i = 0; i < OutHits.Num(); i++)
+	{
+		// blast went off inside the capsule, nothing can be in between
+		FShooterExplosionHit& Hit = OutHits[i];
+		if (Hit.Location != Origin)
+		{
+			Hit.bOccluded = World->LineTraceTest(Origin, Hit.Victim->GetActorLocation(), ECC_Visibility, TraceParams);
+		}
+	}
+}
+
+void AShooterGameMode::ApplyExplosionDamage(float BaseDamage, const FVector& Origin, float Radius, TSubclassOf<UDamageType> DamageTypeClass, AActor* DamageCauser, AController* EventInstigator)
+{
+	TArray<FShooterExplosionHit> Hits;
+	GatherExplosionHits(BaseDamage, Origin, Radius, DamageCauser, Hits);
+	if (Hits.Num() == 0)
+	{
+		return;
+	}
+
+	FRadialDamageEvent DamageEvent;
+	DamageEvent.DamageTypeClass = DamageTypeClass ? *DamageTypeClass : UDamageType::StaticClass();
+	DamageEvent.Origin = Origin;
+
+	// falloff is resolved here, so the event describes full damage within radius and the engine won't scale it again
+	DamageEvent.Params.BaseDamage = BaseDamage;
+	DamageEvent.Params.MinimumDamage = 0.0f;
+	DamageEvent.Params.InnerRadius = Radius;
+	DamageEvent.Params.OuterRadius = Radius;
+	DamageEvent.Params.DamageFalloff = 1.0f;
+
+	for (int32 i = 0; i < Hits.Num(); i++)
+	{
+		const FShooterExplosionHit& Hit = Hits[i];
+		if (Hit.bOccluded)
+		{
+			continue;
+		}
+
+		AShooterCharacter* Victim = Hit.Victim;
+		DamageEvent.ComponentHits.Reset();
+		DamageEvent.ComponentHits.Add(FHitResult(Victim, Victim->CapsuleComponent, Hit.Location, (Origin - Victim->GetActorLocation()).SafeNormal()));
+
+		Victim->TakeDamage(Hit.Damage, DamageEvent, EventInstigator, DamageCauser);
+	}
+}
+
 bool AShooterGameMode::CanDealDamage(class AShooterPlayerState* DamageInstigator, class AShooterPlayerState* DamagedPlayer) const
 {
 	return true;
@@ -381,14 +711,24 @@ AActor* AShooterGameMode::ChoosePlayerStart(AController* Player)
 	TArray<APlayerStart*> PreferredSpawns;
 	TArray<APlayerStart*> FallbackSpawns;
 
-	for (int32 i = 0; i < PlayerStarts.Num(); i++)
+	// overloaded server doesn't check every start, it walks them from a random one and takes the first free
+	// one instead, the check for pawns standing on the start still runs for every start it looks at
+	const bool bShedSpawnScoring = GetServerBudget().ShouldShed(EShooterShedWork::SpawnScoring);
+	const int32 NumStarts = PlayerStarts.Num();
+	const int32 FirstStartIdx = (bShedSpawnScoring && NumStarts > 0) ? FMath::RandHelper(NumStarts) : 0;
+
+	for (int32 i = 0; i < NumStarts; i++)
 	{
-		APlayerStart* TestSpawn = PlayerStarts[i];
+		APlayerStart* TestSpawn = PlayerStarts[(FirstStartIdx + i) % NumStarts];
 		if (IsSpawnpointAllowed(TestSpawn, Player))
 		{
 			if (IsSpawnpointPreferred(TestSpawn, Player))
 			{
 				PreferredSpawns.Add(TestSpawn);
+				if (bShedSpawnScoring)
+				{
+					break;
+				}
 			}
 			else
 			{
@@ -490,7 +830,32 @@ void AShooterGameMode::ConformToKingState()
 
 void AShooterGameMode::Tick( float DeltaSeconds )
 {
+	FlushPendingDamage();
 	ConformToKingState();
+
+	if (!GetWorld()->IsPaused())
+	{
+		GetKillCamRecorder().Tick(GetWorld());
+		GetPickupScheduler().Tick(GetWorld(), GetPawnSpatialIndex());
+		GetPerceptionBus().Tick(GetWorld(), GetPawnSpatialIndex());
+
+		// last, so the frame it times includes the work above
+		GetServerBudget().Tick(DeltaSeconds);
+	}
+}
+
+void AShooterGameMode::RegisterActorTickFunctions(bool bRegister)
+{
+	Super::RegisterActorTickFunctions(bRegister);
+
+	if (bRegister)
+	{
+		GetServerBudget().RegisterFrameStart(GetLevel());
+	}
+	else if (ServerBudget.IsValid())
+	{
+		ServerBudget->UnregisterFrameStart();
+	}
 }
 
 void AShooterGameMode::SpawnBotsForGame()
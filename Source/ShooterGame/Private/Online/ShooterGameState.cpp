@@ -1,13 +1,77 @@
 // Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
 
 #include "ShooterGame.h"
+#include "ShooterStatCounters.h"
 #include "ShooterGameKing.h"
+#include "Effects/ShooterImpactEffectManager.h"
+#include "Sound/ShooterAudioVoiceManager.h"
+#include "Player/ShooterCharacterUpdateManager.h"
+#include "Effects/ShooterLightAnimationManager.h"
+#include "UI/ShooterHUDSnapshot.h"
+#include "ShooterKillFeed.h"
+#include "Weapons/ShooterWeaponRegistry.h"
+#include "ShooterNetAccounting.h"
+#include "ShooterDevHelper.h"
+
+/** seconds a kill event waits for its player states to replicate before it's handled without them */
+static const float KillEventReplicationTimeout = 5.0f;
+
+#if !UE_BUILD_SHIPPING
+struct FShooterKillEventTest
+{
+	/** adds suicide of local player with killer not replicated yet, checks it holds up the stream until killer shows up */
+	static void KillEvents()
+	{
+		UWorld* World = ShooterDevHelper::GetWorld();
+		AShooterGameState* GameState = World ? Cast<AShooterGameState>(World->GameState) : NULL;
+		AShooterCharacter* Pawn = ShooterDevHelper::GetTestPawn(World);
+		AShooterPlayerState* PlayerState = Pawn ? Cast<AShooterPlayerState>(Pawn->PlayerState) : NULL;
+		if (GameState == NULL || PlayerState == NULL)
+		{
+			UE_LOG(LogShooter, Warning, TEXT("TestKillEvents: needs a pawn with a player state"));
+			return;
+		}
+
+		// on a server the event replicates like any other once resolved below
+		const int32 EventId = GameState->GetNewestKillEventId() + 1;
+		FShooterKillEvent& Event = GameState->KillEvents[(EventId - 1) % ARRAY_COUNT(GameState->KillEvents)];
+		Event.EventId = EventId;
+		Event.Killer = NULL;
+		Event.bHasKiller = true;
+		Event.Victim = PlayerState;
+		Event.DamageType = UDamageType::StaticClass();
+		Event.Time = World->GetTimeSeconds() - 1.0f;
+
+		GameState->ProcessKillEvents();
+		const bool bHeld = GameState->LastKillEventId == EventId - 1 && GameState->StalledKillEventId == EventId;
+
+		Event.Killer = PlayerState;
+		GameState->ProcessKillEvents();
+		const FShooterKillFeed& KillFeed = GameState->GetKillFeed();
+		const bool bHandled = GameState->LastKillEventId == EventId && GameState->StalledKillEventId == 0 && KillFeed.GetNewestEventId() == EventId;
+		const bool bServerTime = bHandled && KillFeed.GetEntry(0).Time == Event.Time;
+
+		UE_LOG(LogShooter, Log, TEXT("TestKillEvents: event %d %s while killer is missing, %s once it resolves, feed entry %s server time%s"), EventId,
+			bHeld ? TEXT("held") : TEXT("NOT held"), bHandled ? TEXT("handled") : TEXT("NOT handled"), bServerTime ? TEXT("has") : TEXT("doesn't have"),
+			(bHeld && bHandled && bServerTime) ? TEXT("") : TEXT(" - MISMATCH"));
+	}
+};
+
+static FAutoConsoleCommand CmdTestKillEvents(
+	TEXT("Shooter.TestKillEvents"),
+	TEXT("Adds a kill of the local player whose killer hasn't replicated yet, logs that the kill feed waits for it and then uses the server kill time"),
+	FConsoleCommandDelegate::CreateStatic(FShooterKillEventTest::KillEvents)
+	);
+#endif
 
 AShooterGameState::AShooterGameState(const class FPostConstructInitializeProperties& PCIP) : Super(PCIP)
 {
 	NumTeams = 0;
 	RemainingTime = 0;
 	bTimerPaused = false;
+	LastKillEventId = 0;
+	StalledKillEventId = 0;
+	StalledKillEventTime = 0.0f;
 
 	// need to tick when paused to check king state.
 	PrimaryActorTick.bCanEverTick = true;
@@ -16,6 +80,28 @@ AShooterGameState::AShooterGameState(const class FPostConstructInitializePropert
 	CurrentState = EShooterGameState::EPlaying;
 }
 
+void AShooterGameState::PostInitializeComponents()
+{
+	Super::PostInitializeComponents();
+
+	// game state comes up with the map on server and clients, before weapons spawn
+	FShooterWeaponRegistry::Get();
+}
+
+void AShooterGameState::RegisterActorTickFunctions(bool bRegister)
+{
+	Super::RegisterActorTickFunctions(bRegister);
+
+	if (bRegister)
+	{
+		FShooterNetAccounting::Get().RegisterReceiveWindow(GetLevel());
+	}
+	else
+	{
+		FShooterNetAccounting::Get().UnregisterReceiveWindow(GetLevel());
+	}
+}
+
 void AShooterGameState::GetLifetimeReplicatedProps( TArray< FLifetimeProperty > & OutLifetimeProps ) const
 {
 	Super::GetLifetimeReplicatedProps( OutLifetimeProps );
@@ -24,10 +110,12 @@ void AShooterGameState::GetLifetimeReplicatedProps( TArray< FLifetimeProperty >
 	DOREPLIFETIME( AShooterGameState, RemainingTime );
 	DOREPLIFETIME( AShooterGameState, bTimerPaused );
 	DOREPLIFETIME( AShooterGameState, TeamScores );
+	DOREPLIFETIME( AShooterGameState, KillEvents );
 }
 
 void AShooterGameState::GetRankedMap(int32 TeamIndex, RankedPlayerMap& OutRankedMap) const
 {
+	SHOOTER_COUNTER_INC(RankedMapRebuild);
 	OutRankedMap.Empty();
 
 	//first, we need to go over all the PlayerStates, grab their score, and rank them
@@ -87,4 +175,183 @@ void AShooterGameState::ConformToKingState()
 void AShooterGameState::Tick( float DeltaSeconds )
 {
 	ConformToKingState();
-}
\ No newline at end of file
+
+	if (CharacterUpdateManager.IsValid() && !GetWorld()->IsPaused())
+	{
+		CharacterUpdateManager->Tick(GetWorld(), DeltaSeconds);
+	}
+
+	if (LightAnimationManager.IsValid())
+	{
+		LightAnimationManager->Tick(GetWorld());
+	}
+
+	// retry kill event whose player states hadn't replicated yet
+	if (StalledKillEventId != 0)
+	{
+		ProcessKillEvents();
+	}
+
+	if (HUDSnapshot.IsValid())
+	{
+		HUDSnapshot->Update(this);
+	}
+}
+
+FShooterImpactEffectManager& AShooterGameState::GetImpactEffectManager()
+{
+	if (!ImpactEffectManager.IsValid())
+	{
+		ImpactEffectManager = MakeShareable(new FShooterImpactEffectManager());
+	}
+
+	return *ImpactEffectManager;
+}
+
+FShooterAudioVoiceManager& AShooterGameState::GetAudioVoiceManager()
+{
+	if (!AudioVoiceManager.IsValid())
+	{
+		AudioVoiceManager = MakeShareable(new FShooterAudioVoiceManager());
+	}
+
+	return *AudioVoiceManager;
+}
+
+FShooterCharacterUpdateManager& AShooterGameState::GetCharacterUpdateManager()
+{
+	if (!CharacterUpdateManager.IsValid())
+	{
+		CharacterUpdateManager = MakeShareable(new FShooterCharacterUpdateManager());
+	}
+
+	return *CharacterUpdateManager;
+}
+
+FShooterLightAnimationManager& AShooterGameState::GetLightAnimationManager()
+{
+	if (!LightAnimationManager.IsValid())
+	{
+		LightAnimationManager = MakeShareable(new FShooterLightAnimationManager());
+	}
+
+	return *LightAnimationManager;
+}
+
+FShooterHUDSnapshot& AShooterGameState::GetHUDSnapshot()
+{
+	if (!HUDSnapshot.IsValid())
+	{
+		HUDSnapshot = MakeShareable(new FShooterHUDSnapshot());
+		HUDSnapshot->Update(this);
+	}
+
+	return *HUDSnapshot;
+}
+
+FShooterKillFeed& AShooterGameState::GetKillFeed()
+{
+	if (!KillFeed.IsValid())
+	{
+		KillFeed = MakeShareable(new FShooterKillFeed());
+	}
+
+	return *KillFeed;
+}
+
+void AShooterGameState::AddKillEvent(AShooterPlayerState* KillerPlayerState, AShooterPlayerState* VictimPlayerState, const UDamageType* DamageType)
+{
+	const int32 EventId = GetNewestKillEventId() + 1;
+
+	FShooterKillEvent& Event = KillEvents[(EventId - 1) % ARRAY_COUNT(KillEvents)];
+	Event.EventId = EventId;
+	Event.Killer = KillerPlayerState;
+	Event.bHasKiller = KillerPlayerState != NULL;
+	Event.Victim = VictimPlayerState;
+	Event.DamageType = DamageType ? DamageType->GetClass() : NULL;
+	Event.Time = GetWorld()->GetTimeSeconds();
+
+	// listen server and standalone players don't get OnRep
+	ProcessKillEvents();
+}
+
+void AShooterGameState::OnRep_KillEvents()
+{
+	ProcessKillEvents();
+}
+
+int32 AShooterGameState::GetNewestKillEventId() const
+{
+	int32 NewestEventId = 0;
+	for (int32 i = 0; i < ARRAY_COUNT(KillEvents); i++)
+	{
+		NewestEventId = FMath::Max(NewestEventId, KillEvents[i].EventId);
+	}
+
+	return NewestEventId;
+}
+
+void AShooterGameState::ProcessKillEvents()
+{
+	const int32 NewestEventId = GetNewestKillEventId();
+	const float GameTime = GetWorld()->GetTimeSeconds();
+
+	// events older than the ring were overwritten before they got here, late joiners only see what's in the ring
+	const int32 FirstEventId = FMath::Max(LastKillEventId + 1, NewestEventId - (int32)ARRAY_COUNT(KillEvents) + 1);
+	for (int32 EventId = FirstEventId; EventId <= NewestEventId; EventId++)
+	{
+		const FShooterKillEvent& Event = KillEvents[(EventId - 1) % ARRAY_COUNT(KillEvents)];
+
+		// slot still holding an older event hasn't replicated yet, and player states referenced by a new one
+		// can arrive after it; wait for them, unless they never do (e.g. player left) and the event would hold up the rest
+		const bool bReplicated = Event.EventId >= EventId && Event.Victim && (Event.Killer || !Event.bHasKiller);
+		if (!bReplicated && Event.EventId <= EventId)
+		{
+			if (StalledKillEventId != EventId)
+			{
+				StalledKillEventId = EventId;
+				StalledKillEventTime = GameTime;
+			}
+
+			if (GameTime - StalledKillEventTime < KillEventReplicationTimeout)
+			{
+				return;
+			}
+		}
+
+		// newer event in slot means this one was overwritten
+		if (Event.EventId == EventId)
+		{
+			HandleKillEvent(Event);
+		}
+
+		LastKillEventId = EventId;
+	}
+
+	LastKillEventId = FMath::Max(LastKillEventId, NewestEventId);
+	StalledKillEventId = 0;
+}
+
+void AShooterGameState::HandleKillEvent(const FShooterKillEvent& Event)
+{
+	if (Event.Victim == NULL)
+	{
+		return;
+	}
+
+	if (Event.Killer)
+	{
+		GetKillFeed().Add(Event, Event.Time);
+	}
+
+	const UDamageType* DamageType = Event.DamageType ? GetDefault<UDamageType>(Event.DamageType) : NULL;
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		// all local players get death messages so they can update their huds
+		AShooterPlayerController* TestPC = Cast<AShooterPlayerController>(*It);
+		if (TestPC && TestPC->IsLocalController())
+		{
+			TestPC->OnDeathMessage(Event.Killer, Event.Victim, DamageType);
+		}
+	}
+}
@@ -0,0 +1,260 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "ShooterKillCamRecorder.h"
+#include "ShooterConfigSection.h"
+#include "ShooterDevHelper.h"
+
+/** rough serialized sizes of clip parts, quantized vectors are counted at their worst */
+static const int32 KillCamActorBytes = 5;
+static const int32 KillCamSampleBytes = 14;
+static const int32 KillCamShotBytes = 12;
+static const int32 KillCamHeaderBytes = 24;
+
+/** returns estimated serialized size of clip */
+static int32 EstimateClipBytes(const FShooterKillCamClip& Clip)
+{
+	return KillCamHeaderBytes + Clip.Actors.Num() * KillCamActorBytes + Clip.Samples.Num() * KillCamSampleBytes + Clip.Shots.Num() * KillCamShotBytes;
+}
+
+#if !UE_BUILD_SHIPPING
+static void TestKillCam()
+{
+	UWorld* World = ShooterDevHelper::GetWorld();
+	AShooterGameMode* GameMode = World ? Cast<AShooterGameMode>(World->GetAuthGameMode()) : NULL;
+	AShooterCharacter* Pawn = ShooterDevHelper::GetTestPawn(World);
+	if (GameMode == NULL || Pawn == NULL)
+	{
+		UE_LOG(LogShooter, Log, TEXT("TestKillCam: needs a pawn on the server"));
+		return;
+	}
+
+	FShooterKillCamClip Clip;
+	if (!GameMode->GetKillCamRecorder().BuildClip(Pawn, NULL, Clip))
+	{
+		UE_LOG(LogShooter, Log, TEXT("TestKillCam: nothing recorded yet"));
+		return;
+	}
+
+	UE_LOG(LogShooter, Log, TEXT("TestKillCam: clip of %s has %d pawns, %d frames, %d samples, %d shots, about %d bytes"),
+		*Pawn->GetName(), Clip.Actors.Num(), Clip.NumFrames, Clip.Samples.Num(), Clip.Shots.Num(), EstimateClipBytes(Clip));
+}
+
+static FAutoConsoleCommand CmdTestKillCam(
+	TEXT("Shooter.TestKillCam"),
+	TEXT("Builds a kill-cam clip around the local pawn from the server buffer and logs its size"),
+	FConsoleCommandDelegate::CreateStatic(TestKillCam)
+	);
+#endif
+
+FShooterKillCamRecorder::FShooterKillCamRecorder()
+	: bEnabled(true)
+	, Duration(4.0f)
+	, SampleInterval(0.2f)
+	, Radius(4000.0f)
+	, MaxPawns(8)
+	, MaxShots(64)
+	, MaxClipBytes(3328)
+	, TracerLength(5000.0f)
+	, NextFrame(0)
+	, NumFrames(0)
+	, LastSampleTime(-1.0f)
+{
+	const FShooterConfigSection Config(TEXT("ShooterGame.KillCam"));
+	Config.Get(TEXT("bEnabled"), bEnabled);
+	Config.Get(TEXT("Duration"), Duration);
+	Config.Get(TEXT("SampleInterval"), SampleInterval);
+	Config.Get(TEXT("Radius"), Radius);
+	Config.Get(TEXT("MaxPawns"), MaxPawns);
+	Config.Get(TEXT("MaxShots"), MaxShots);
+	Config.Get(TEXT("MaxClipBytes"), MaxClipBytes);
+	Config.Get(TEXT("TracerLength"), TracerLength);
+
+	// frame and actor indices are sent as bytes
+	SampleInterval = FMath::Max(SampleInterval, 0.02f);
+	MaxPawns = FMath::Clamp(MaxPawns, 2, 255);
+	MaxShots = FMath::Clamp(MaxShots, 0, 1024);
+	MaxClipBytes = FMath::Max(MaxClipBytes, 512);
+	Frames.AddZeroed(FMath::Clamp(FMath::CeilToInt(Duration / SampleInterval) + 1, 2, 255));
+
+	// full history of MaxPawns has to fit the pawns' three quarters of the budget, MaxShots the rest
+	const int32 PawnBytes = Frames.Num() * KillCamSampleBytes + KillCamActorBytes;
+	const int32 PawnBudget = (MaxClipBytes - KillCamHeaderBytes) * 3 / 4;
+	if (MaxPawns * PawnBytes > PawnBudget)
+	{
+		UE_LOG(LogShooter, Warning, TEXT("Kill-cam: MaxClipBytes %d holds %d seconds of only %d pawns (%d bytes each), raise it to %d for MaxPawns %d"),
+			MaxClipBytes, FMath::RoundToInt(Duration), PawnBudget / PawnBytes, PawnBytes, KillCamHeaderBytes + (MaxPawns * PawnBytes * 4 + 2) / 3, MaxPawns);
+	}
+	else if (KillCamHeaderBytes + MaxPawns * PawnBytes + MaxShots * KillCamShotBytes > MaxClipBytes)
+	{
+		UE_LOG(LogShooter, Warning, TEXT("Kill-cam: MaxClipBytes %d leaves room for %d of MaxShots %d once MaxPawns %d are in"),
+			MaxClipBytes, (MaxClipBytes - KillCamHeaderBytes - MaxPawns * PawnBytes) / KillCamShotBytes, MaxShots, MaxPawns);
+	}
+}
+
+void FShooterKillCamRecorder::Tick(UWorld* World)
+{
+	const float Now = World->GetTimeSeconds();
+	if (!bEnabled || (LastSampleTime >= 0.0f && Now - LastSampleTime < SampleInterval))
+	{
+		return;
+	}
+	LastSampleTime = Now;
+
+	FFrame& Frame = Frames[NextFrame];
+	Frame.Time = Now;
+	Frame.Pawns.Reset();
+
+	for (FConstPawnIterator It = World->GetPawnIterator(); It; ++It)
+	{
+		AShooterCharacter* Pawn = Cast<AShooterCharacter>(*It);
+		if (Pawn && Pawn->IsAlive())
+		{
+			FPawnRecord Record;
+			Record.Pawn = Pawn;
+			Record.Location = Pawn->GetActorLocation();
+			Record.Rotation = Pawn->GetBaseAimRotation();
+			Frame.Pawns.Add(Record);
+		}
+	}
+
+	NextFrame = (NextFrame + 1) % Frames.Num();
+	NumFrames = FMath::Min(NumFrames + 1, Frames.Num());
+
+	// drop shots older than the oldest frame
+	const float OldestTime = GetFrame(0).Time;
+	int32 NumExpired = 0;
+	while (NumExpired < Shots.Num() && Shots[NumExpired].Time < OldestTime)
+	{
+		NumExpired++;
+	}
+	if (NumExpired > 0)
+	{
+		Shots.RemoveAt(0, NumExpired);
+	}
+}
+
+void FShooterKillCamRecorder::RecordShot(UWorld* World, AShooterCharacter* Shooter, const FVector& End)
+{
+	if (bEnabled && Shooter)
+	{
+		FShotRecord Shot;
+		Shot.Shooter = Shooter;
+		Shot.Time = World->GetTimeSeconds();
+		Shot.End = End;
+		Shots.Add(Shot);
+	}
+}
+
+bool FShooterKillCamRecorder::BuildClip(APawn* Victim, APawn* Killer, FShooterKillCamClip& OutClip) const
+{
+	if (!bEnabled || Victim == NULL || NumFrames < 2)
+	{
+		return false;
+	}
+
+	const FVector Origin = Victim->GetActorLocation();
+	const float RadiusSq = FMath::Square(Radius);
+
+	// pick pawns: victim and killer first, then whoever came closest to the victim
+	TArray<TWeakObjectPtr<AShooterCharacter> > Selected;
+	Selected.Add(Cast<AShooterCharacter>(Victim));
+	if (Killer && Killer != Victim && Cast<AShooterCharacter>(Killer))
+	{
+		Selected.Add(Cast<AShooterCharacter>(Killer));
+	}
+
+	TMap<TWeakObjectPtr<AShooterCharacter>, float> ClosestDistSq;
+	for (int32 FrameIdx = 0; FrameIdx < NumFrames; FrameIdx++)
+	{
+		const FFrame& Frame = GetFrame(FrameIdx);
+		for (int32 i = 0; i < Frame.Pawns.Num(); i++)
+		{
+			const FPawnRecord& Record = Frame.Pawns[i];
+			const float DistSq = (Record.Location - Origin).SizeSquared();
+			if (DistSq <= RadiusSq && !Selected.Contains(Record.Pawn))
+			{
+				float* Closest = ClosestDistSq.Find(Record.Pawn);
+				if (Closest == NULL || DistSq < *Closest)
+				{
+					ClosestDistSq.Add(Record.Pawn, DistSq);
+				}
+			}
+		}
+	}
+
+	// a quarter of the byte budget is kept for shots, pawns and frames share the rest
+	const int32 PawnBudget = (MaxClipBytes - KillCamHeaderBytes) * 3 / 4;
+	const int32 MaxBudgetPawns = FMath::Max(PawnBudget / (NumFrames * KillCamSampleBytes + KillCamActorBytes), Selected.Num());
+
+	ClosestDistSq.ValueSort(TLess<float>());
+	for (auto It = ClosestDistSq.CreateConstIterator(); It && Selected.Num() < FMath::Min(MaxPawns, MaxBudgetPawns); ++It)
+	{
+		Selected.Add(It.Key());
+	}
+
+	// victim and killer alone can still be over budget, drop oldest frames then
+	const int32 NumClipFrames = FMath::Clamp((PawnBudget / Selected.Num() - KillCamActorBytes) / KillCamSampleBytes, 2, NumFrames);
+	const int32 FirstFrame = NumFrames - NumClipFrames;
+
+	OutClip = FShooterKillCamClip();
+	OutClip.Origin = Origin;
+	OutClip.FrameInterval = SampleInterval;
+	OutClip.NumFrames = NumClipFrames;
+
+	for (int32 i = 0; i < Selected.Num(); i++)
+	{
+		AShooterCharacter* Pawn = Selected[i].Get();
+
+		FShooterKillCamActor Actor;
+		Actor.PlayerState = Pawn ? Cast<AShooterPlayerState>(Pawn->PlayerState) : NULL;
+		Actor.bVictim = (Pawn == Victim);
+		Actor.bKiller = (Pawn == Killer);
+		OutClip.Actors.Add(Actor);
+	}
+
+	for (int32 FrameIdx = FirstFrame; FrameIdx < NumFrames; FrameIdx++)
+	{
+		const FFrame& Frame = GetFrame(FrameIdx);
+		for (int32 i = 0; i < Frame.Pawns.Num(); i++)
+		{
+			const FPawnRecord& Record = Frame.Pawns[i];
+			const int32 ActorIdx = Selected.Find(Record.Pawn);
+			if (ActorIdx != INDEX_NONE)
+			{
+				FShooterKillCamSample Sample;
+				Sample.ActorIndex = ActorIdx;
+				Sample.FrameIndex = FrameIdx - FirstFrame;
+				Sample.Yaw = FRotator::CompressAxisToByte(Record.Rotation.Yaw);
+				Sample.Pitch = FRotator::CompressAxisToByte(Record.Rotation.Pitch);
+				Sample.Location = Record.Location - Origin;
+				OutClip.Samples.Add(Sample);
+			}
+		}
+	}
+
+	// newest shots matter most, keep the tail if over budget
+	const float OldestTime = GetFrame(FirstFrame).Time;
+	for (int32 i = 0; i < Shots.Num(); i++)
+	{
+		const FShotRecord& Record = Shots[i];
+		const int32 ActorIdx = Selected.Find(Record.Shooter);
+		if (ActorIdx != INDEX_NONE && Record.Time >= OldestTime)
+		{
+			FShooterKillCamShot Shot;
+			Shot.ActorIndex = ActorIdx;
+			Shot.FrameIndex = FMath::Clamp(FMath::RoundToInt((Record.Time - OldestTime) / SampleInterval), 0, NumClipFrames - 1);
+			Shot.End = Record.End - Origin;
+			OutClip.Shots.Add(Shot);
+		}
+	}
+
+	const int32 UsedBytes = KillCamHeaderBytes + OutClip.Actors.Num() * KillCamActorBytes + OutClip.Samples.Num() * KillCamSampleBytes;
+	const int32 MaxClipShots = FMath::Min(MaxShots, FMath::Max(MaxClipBytes - UsedBytes, 0) / KillCamShotBytes);
+	if (OutClip.Shots.Num() > MaxClipShots)
+	{
+		OutClip.Shots.RemoveAt(0, OutClip.Shots.Num() - MaxClipShots);
+	}
+
+	return OutClip.Samples.Num() > 0;
+}
@@ -0,0 +1,112 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+/**
+ * Rolling server-side buffer of pawn transforms and shots for kill-cams.
+ * Live pawns are sampled at a fixed rate for the last few seconds; on death, pawns near the victim and the killer
+ * are cut out of the buffer into a compact FShooterKillCamClip that is sent to the victim once and played back locally.
+ * Clips are kept within a byte budget by dropping the farthest pawns, then the oldest frames, then the oldest shots.
+ *
+ * Tuned in [ShooterGame.KillCam] of the Game ini. Pawns get three quarters of MaxClipBytes and a pawn costs 5 bytes plus 14 per frame,
+ * so the defaults (4 s at 5 Hz is 21 frames, 299 bytes per pawn) fit MaxPawns=8 in 2392 of the 2478 bytes pawns get out of
+ * MaxClipBytes=3328, and MaxShots=64 at 12 bytes each in the rest. A warning is logged when configured limits don't fit together.
+ * Outside of shipping builds "Shooter.TestKillCam" logs the clip the local pawn would get right now.
+ */
+class FShooterKillCamRecorder
+{
+public:
+
+	FShooterKillCamRecorder();
+
+	/** is recording on? */
+	bool IsEnabled() const
+	{
+		return bEnabled;
+	}
+
+	/** samples live pawns if sample interval elapsed */
+	void Tick(UWorld* World);
+
+	/** records shot fired by pawn */
+	void RecordShot(UWorld* World, class AShooterCharacter* Shooter, const FVector& End);
+
+	/** returns length of tracer for shots without known impact */
+	float GetTracerLength() const
+	{
+		return TracerLength;
+	}
+
+	/** cuts clip of victim's death out of the buffer, returns false if there is nothing to show */
+	bool BuildClip(class APawn* Victim, class APawn* Killer, FShooterKillCamClip& OutClip) const;
+
+private:
+
+	/** recorded state of single pawn */
+	struct FPawnRecord
+	{
+		TWeakObjectPtr<class AShooterCharacter> Pawn;
+		FVector Location;
+		FRotator Rotation;
+	};
+
+	/** all pawns at single point in time */
+	struct FFrame
+	{
+		float Time;
+		TArray<FPawnRecord> Pawns;
+	};
+
+	/** shot fired by pawn */
+	struct FShotRecord
+	{
+		TWeakObjectPtr<class AShooterCharacter> Shooter;
+		float Time;
+		FVector End;
+	};
+
+	/** returns frame by age, 0 being the oldest */
+	const FFrame& GetFrame(int32 Index) const
+	{
+		return Frames[(NextFrame - NumFrames + Index + Frames.Num()) % Frames.Num()];
+	}
+
+	/** is recording on? */
+	bool bEnabled;
+
+	/** length of recorded history */
+	float Duration;
+
+	/** time between samples */
+	float SampleInterval;
+
+	/** max distance from victim of pawns included in clip */
+	float Radius;
+
+	/** max pawns in clip */
+	int32 MaxPawns;
+
+	/** max shots in clip */
+	int32 MaxShots;
+
+	/** max estimated size of clip sent over the network */
+	int32 MaxClipBytes;
+
+	/** length of tracer for shots without known impact */
+	float TracerLength;
+
+	/** ring buffer of frames */
+	TArray<FFrame> Frames;
+
+	/** slot of next frame in ring buffer */
+	int32 NextFrame;
+
+	/** frames recorded so far, up to ring buffer size */
+	int32 NumFrames;
+
+	/** time of last sample */
+	float LastSampleTime;
+
+	/** shots, oldest first */
+	TArray<FShotRecord> Shots;
+};
@@ -0,0 +1,30 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "ShooterKillFeed.h"
+
+FShooterKillFeed::FShooterKillFeed()
+	: NumAdded(0)
+{
+}
+
+void FShooterKillFeed::Add(const FShooterKillEvent& Event, float ServerTime)
+{
+	check(Event.Killer && Event.Victim);
+
+	FShooterKillFeedEntry& Entry = Entries[NumAdded % MaxEntries];
+	NumAdded++;
+
+	Entry.EventId = Event.EventId;
+	Entry.KillerDesc = Event.Killer->GetShortPlayerName();
+	Entry.VictimDesc = Event.Victim->GetShortPlayerName();
+	Entry.KillerText = FText::FromString(Entry.KillerDesc);
+	Entry.VictimText = FText::FromString(Entry.VictimDesc);
+	Entry.KillerPlayerState = Event.Killer;
+	Entry.VictimPlayerState = Event.Victim;
+	Entry.KillerTeamNum = Event.Killer->GetTeamNum();
+	Entry.VictimTeamNum = Event.Victim->GetTeamNum();
+	Entry.DamageType = Event.DamageType ? Cast<UShooterDamageType>(Event.DamageType->GetDefaultObject()) : NULL;
+	Entry.Time = ServerTime;
+	Entry.MeasuredFont = NULL;
+}
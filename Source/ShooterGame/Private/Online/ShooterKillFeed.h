@@ -0,0 +1,113 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+/** kill feed entry, formatted once when the kill comes in */
+struct FShooterKillFeedEntry
+{
+	/** sequence number of kill event */
+	int32 EventId;
+
+	/** name of player scoring kill */
+	FString KillerDesc;
+
+	/** name of killed player */
+	FString VictimDesc;
+
+	/** KillerDesc for drawing */
+	FText KillerText;
+
+	/** VictimDesc for drawing */
+	FText VictimText;
+
+	/** player scoring kill, compared against local player when drawing */
+	TWeakObjectPtr<class AShooterPlayerState> KillerPlayerState;
+
+	/** killed player, compared against local player when drawing */
+	TWeakObjectPtr<class AShooterPlayerState> VictimPlayerState;
+
+	/** team number of the killer */
+	int32 KillerTeamNum;
+
+	/** team number of the victim */
+	int32 VictimTeamNum;
+
+	/** what killed the player */
+	TWeakObjectPtr<class UShooterDamageType> DamageType;
+
+	/** server game time of kill */
+	float Time;
+
+	/** font names were measured with, NULL until first drawn */
+	const UFont* MeasuredFont;
+
+	/** size of KillerDesc in MeasuredFont */
+	FVector2D KillerSize;
+
+	/** size of VictimDesc in MeasuredFont */
+	FVector2D VictimSize;
+
+	FShooterKillFeedEntry()
+		: EventId(0)
+		, KillerTeamNum(0)
+		, VictimTeamNum(0)
+		, Time(0.0f)
+		, MeasuredFont(NULL)
+		, KillerSize(0.0f, 0.0f)
+		, VictimSize(0.0f, 0.0f)
+	{
+	}
+};
+
+/**
+ * Most recent kills of the match, fed by AShooterGameState from its replicated kill event stream.
+ * Entries live in a fixed ring and are formatted once on arrival, so the HUD, spectators and stats export
+ * read them without shifting arrays or rebuilding strings every frame.
+ */
+class FShooterKillFeed
+{
+public:
+
+	enum
+	{
+		/** entries kept, oldest is overwritten once full */
+		MaxEntries = 5,
+	};
+
+	FShooterKillFeed();
+
+	/** formats kill and adds it as newest entry */
+	void Add(const struct FShooterKillEvent& Event, float ServerTime);
+
+	/** returns number of entries */
+	int32 Num() const
+	{
+		return FMath::Min(NumAdded, (int32)MaxEntries);
+	}
+
+	/** returns entry by age, 0 is the newest */
+	FShooterKillFeedEntry& GetEntry(int32 Age)
+	{
+		return Entries[(NumAdded - 1 - Age) % MaxEntries];
+	}
+
+	/** returns entry by age, 0 is the newest */
+	const FShooterKillFeedEntry& GetEntry(int32 Age) const
+	{
+		return Entries[(NumAdded - 1 - Age) % MaxEntries];
+	}
+
+	/** returns sequence number of newest entry, 0 if empty */
+	int32 GetNewestEventId() const
+	{
+		return NumAdded > 0 ? GetEntry(0).EventId : 0;
+	}
+
+private:
+
+	/** ring of entries */
+	FShooterKillFeedEntry Entries[MaxEntries];
+
+	/** number of entries added so far */
+	int32 NumAdded;
+};
@@ -0,0 +1,572 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "ShooterNetAccounting.h"
+#include "ShooterConfigSection.h"
+#include "ShooterDevHelper.h"
+
+/** rough cost of field handle and bunch bookkeeping of single RPC */
+static const int32 RPCHeaderBits = 24;
+
+/** rough cost of handle of single property update */
+static const int32 PropertyHeaderBits = 8;
+
+static void ToggleNetAccounting(const TArray<FString>& Args)
+{
+	FShooterNetAccounting& Accounting = FShooterNetAccounting::Get();
+	Accounting.SetEnabled(Args.Num() > 0 ? FCString::Atoi(*Args[0]) != 0 : !Accounting.IsEnabled());
+}
+
+static void DumpNetAccounting()
+{
+	FShooterNetAccounting::Get().DumpToLog();
+}
+
+static FAutoConsoleCommand CmdToggleNetAccounting(
+	TEXT("Shooter.NetAccounting"),
+	TEXT("Turns per RPC and property bandwidth accounting on (1) or off (0), toggles without argument"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(ToggleNetAccounting)
+	);
+
+static FAutoConsoleCommand CmdDumpNetAccounting(
+	TEXT("Shooter.DumpNetAccounting"),
+	TEXT("Writes per connection RPC and property bandwidth totals to the log"),
+	FConsoleCommandDelegate::CreateStatic(DumpNetAccounting)
+	);
+
+#if !UE_BUILD_SHIPPING
+static void TestNetAccounting()
+{
+	AShooterCharacter* Pawn = ShooterDevHelper::GetTestPawn(ShooterDevHelper::GetWorld());
+	UFunction* Function = Pawn ? Pawn->FindFunction(TEXT("ServerSetRunning")) : NULL;
+	if (Function == NULL)
+	{
+		UE_LOG(LogShooter, Log, TEXT("TestNetAccounting: no pawn"));
+		return;
+	}
+
+	FShooterNetAccounting& Accounting = FShooterNetAccounting::Get();
+	const bool bWasEnabled = Accounting.IsEnabled();
+	const bool bWasOpen = Accounting.IsReceiveWindowOpen();
+	Accounting.SetEnabled(true);
+
+	// same call once as if game code ran it during the tick, once as if the net driver delivered it
+	TArray<uint8> Parameters;
+	Parameters.AddZeroed(Function->ParmsSize);
+
+	UE_LOG(LogShooter, Log, TEXT("TestNetAccounting: %s on %s, owner connection %s"), *Function->GetName(), *Pawn->GetName(),
+		Pawn->GetNetConnection() ? TEXT("remote") : TEXT("none (nothing counts as received)"));
+
+	Accounting.SetReceiveWindow(false);
+	Accounting.AccountReceivedCall(Pawn, Function, Parameters.GetData());
+	UE_LOG(LogShooter, Log, TEXT("TestNetAccounting: after local call"));
+	Accounting.DumpToLog();
+
+	Accounting.SetReceiveWindow(true);
+	Accounting.AccountReceivedCall(Pawn, Function, Parameters.GetData());
+	UE_LOG(LogShooter, Log, TEXT("TestNetAccounting: after call in receive window"));
+	Accounting.DumpToLog();
+
+	Accounting.SetReceiveWindow(bWasOpen);
+	Accounting.SetEnabled(bWasEnabled);
+}
+
+static FAutoConsoleCommand CmdTestNetAccounting(
+	TEXT("Shooter.TestNetAccounting"),
+	TEXT("Accounts a server RPC of the local pawn as run locally and as received, writes totals after each to the log"),
+	FConsoleCommandDelegate::CreateStatic(TestNetAccounting)
+	);
+#endif
+
+void FShooterNetReceiveTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+{
+	// net driver is done dispatching, anything run from here on is game code
+	FShooterNetAccounting::Get().SetReceiveWindow(false);
+}
+
+FString FShooterNetReceiveTickFunction::DiagnosticMessage()
+{
+	return TEXT("FShooterNetAccounting receive window");
+}
+
+FShooterNetAccounting::FScopedSend::FScopedSend(AActor* InActor, UFunction* InFunction)
+	: Actor(InActor)
+	, Function(InFunction)
+{
+	UNetDriver* NetDriver = FShooterNetAccounting::Get().IsEnabled() && Actor->GetWorld() ? Actor->GetWorld()->GetNetDriver() : NULL;
+	if (NetDriver == NULL)
+	{
+		return;
+	}
+
+	if (Function->FunctionFlags & FUNC_NetMulticast)
+	{
+		Connections.Append(NetDriver->ClientConnections);
+	}
+	else if (UNetConnection* Connection = Actor->GetNetConnection())
+	{
+		Connections.Add(Connection);
+	}
+
+	for (int32 i = 0; i < Connections.Num(); i++)
+	{
+		StartBits.Add(GetBitsWritten(Connections[i]));
+	}
+}
+
+FShooterNetAccounting::FScopedSend::~FScopedSend()
+{
+	FShooterNetAccounting& Accounting = FShooterNetAccounting::Get();
+	int64 MaxBits = 0;
+	for (int32 i = 0; i < Connections.Num(); i++)
+	{
+		// multicasts skip connections that aren't relevant
+		const int64 Bits = GetBitsWritten(Connections[i]) - StartBits[i];
+		if (Bits > 0)
+		{
+			Accounting.AddEntry(Connections[i], Function->GetFName(), false, false, false, Bits);
+			MaxBits = FMath::Max(MaxBits, Bits);
+		}
+	}
+
+	// same payload goes to every connection, also count it once
+	if ((Function->FunctionFlags & FUNC_NetMulticast) && MaxBits > 0)
+	{
+		Accounting.AddMulticastPayload(Function->GetFName(), MaxBits);
+	}
+}
+
+FShooterNetAccounting& FShooterNetAccounting::Get()
+{
+	static FShooterNetAccounting Instance;
+	return Instance;
+}
+
+FShooterNetAccounting::FShooterNetAccounting()
+	: bEnabled(false)
+	, CsvFile(TEXT("Profiling/NetAccounting.csv"))
+	, bReceiveWindowOpen(true)
+{
+	const FShooterConfigSection Config(TEXT("ShooterGame.NetAccounting"));
+	Config.Get(TEXT("bEnabled"), bEnabled);
+	Config.Get(TEXT("CsvFile"), CsvFile);
+
+	bEnabled |= FParse::Param(FCommandLine::Get(), TEXT("NetAccounting"));
+
+	ReceiveWindowTick.TickGroup = TG_PrePhysics;
+	ReceiveWindowTick.bCanEverTick = true;
+	ReceiveWindowTick.bStartWithTickEnabled = true;
+	ReceiveWindowTick.bTickEvenWhenPaused = true;
+}
+
+bool FShooterNetAccounting::Tick(float DeltaSeconds)
+{
+	bReceiveWindowOpen = true;
+	return true;
+}
+
+void FShooterNetAccounting::RegisterReceiveWindow(ULevel* Level)
+{
+	if (Level && !ReceiveWindowTick.IsTickFunctionRegistered())
+	{
+		ReceiveWindowTick.RegisterTickFunction(Level);
+		ReceiveWindowLevel = Level;
+	}
+}
+
+void FShooterNetAccounting::UnregisterReceiveWindow(ULevel* Level)
+{
+	if (ReceiveWindowTick.IsTickFunctionRegistered() && ReceiveWindowLevel.Get() == Level)
+	{
+		ReceiveWindowTick.UnRegisterTickFunction();
+		ReceiveWindowLevel = NULL;
+	}
+}
+
+void FShooterNetAccounting::SetEnabled(bool bInEnabled)
+{
+	UE_LOG(LogShooter, Log, TEXT("Net accounting %s"), bInEnabled ? TEXT("on") : TEXT("off"));
+
+	// values remembered while off are stale
+	bEnabled = bInEnabled;
+	LastValues.Empty();
+}
+
+int64 FShooterNetAccounting::GetBitsWritten(UNetConnection* Connection)
+{
+	// send buffer is moved into OutBytes whenever it gets flushed
+	return (int64)Connection->OutBytes * 8 + Connection->SendBuffer.GetNumBits();
+}
+
+void FShooterNetAccounting::AccountReceivedCall(AActor* Actor, UFunction* Function, void* Parameters)
+{
+	if (!bEnabled || (Function->FunctionFlags & FUNC_Net) == 0 || !IsReceiveWindowOpen())
+	{
+		return;
+	}
+
+	// server RPCs from remote owners on server, client and multicast RPCs on client; anything else is executing locally
+	UNetDriver* NetDriver = Actor->GetWorld() ? Actor->GetWorld()->GetNetDriver() : NULL;
+	UNetConnection* Connection = NULL;
+	if (Actor->GetNetMode() == NM_Client)
+	{
+		Connection = (Function->FunctionFlags & (FUNC_NetClient | FUNC_NetMulticast)) && NetDriver ? NetDriver->ServerConnection : NULL;
+	}
+	else if (Function->FunctionFlags & FUNC_NetServer)
+	{
+		Connection = Actor->GetNetConnection();
+	}
+
+	if (Connection == NULL)
+	{
+		return;
+	}
+
+	int32 Bits = RPCHeaderBits;
+	for (TFieldIterator<UProperty> It(Function); It && (It->PropertyFlags & CPF_Parm); ++It)
+	{
+		if ((It->PropertyFlags & CPF_ReturnParm) == 0)
+		{
+			Bits += EstimateNetBits(*It, It->ContainerPtrToValuePtr<void>(Parameters));
+		}
+	}
+
+	AddEntry(Connection, Function->GetFName(), false, true, true, Bits);
+}
+
+void FShooterNetAccounting::AccountReplicatedProperties(AActor* Actor)
+{
+	UNetDriver* NetDriver = bEnabled && Actor->GetWorld() ? Actor->GetWorld()->GetNetDriver() : NULL;
+	if (NetDriver == NULL || NetDriver->ClientConnections.Num() == 0)
+	{
+		return;
+	}
+
+	const TArray<FTrackedProperty>& Tracked = GetTrackedProperties(Actor);
+	TArray<uint32>& Values = LastValues.FindOrAdd(Actor);
+
+	// first pass sends everything
+	const bool bInitial = Values.Num() != Tracked.Num();
+	if (bInitial)
+	{
+		Values.Empty(Tracked.Num());
+		Values.AddZeroed(Tracked.Num());
+	}
+
+	UNetConnection* OwnerConnection = Actor->GetNetConnection();
+	for (int32 i = 0; i < Tracked.Num(); i++)
+	{
+		UProperty* Property = Tracked[i].Property;
+		const void* Data = Property->ContainerPtrToValuePtr<void>(Actor, Tracked[i].ArrayIndex);
+		const uint32 Hash = HashValue(Property, Data, 0);
+		if (Hash == Values[i] && !bInitial)
+		{
+			continue;
+		}
+		Values[i] = Hash;
+
+		const int32 Bits = PropertyHeaderBits + EstimateNetBits(Property, Data);
+		for (int32 ConnectionIdx = 0; ConnectionIdx < NetDriver->ClientConnections.Num(); ConnectionIdx++)
+		{
+			UNetConnection* Connection = NetDriver->ClientConnections[ConnectionIdx];
+			if (!Connection->ActorChannels.Contains(Actor))
+			{
+				continue;
+			}
+
+			const bool bOwner = Connection == OwnerConnection;
+			bool bSends = true;
+			switch (Tracked[i].Condition)
+			{
+				case COND_InitialOnly:		bSends = bInitial; break;
+				case COND_InitialOrOwner:	bSends = bInitial || bOwner; break;
+				case COND_OwnerOnly:
+				case COND_AutonomousOnly:	bSends = bOwner; break;
+				case COND_SkipOwner:
+				case COND_SimulatedOnly:	bSends = !bOwner; break;
+				default:					break;
+			}
+
+			if (bSends)
+			{
+				AddEntry(Connection, Property->GetFName(), true, false, true, Bits);
+			}
+		}
+	}
+}
+
+const TArray<FShooterNetAccounting::FTrackedProperty>& FShooterNetAccounting::GetTrackedProperties(AActor* Actor)
+{
+	UClass* Class = Actor->GetClass();
+	const TArray<FTrackedProperty>* Found = ClassProperties.Find(Class);
+	if (Found)
+	{
+		return *Found;
+	}
+
+	TArray<FLifetimeProperty> LifetimeProps;
+	Actor->GetLifetimeReplicatedProps(LifetimeProps);
+
+	TArray<FTrackedProperty>& Tracked = ClassProperties.Add(Class, TArray<FTrackedProperty>());
+	for (int32 i = 0; i < LifetimeProps.Num(); i++)
+	{
+		if (Class->ClassReps.IsValidIndex(LifetimeProps[i].RepIndex))
+		{
+			const FRepRecord& Rep = Class->ClassReps[LifetimeProps[i].RepIndex];
+
+			FTrackedProperty Property;
+			Property.Property = Rep.Property;
+			Property.ArrayIndex = Rep.Index;
+			Property.Condition = LifetimeProps[i].Condition;
+			Tracked.Add(Property);
+		}
+	}
+
+	return Tracked;
+}
+
+int32 FShooterNetAccounting::EstimateNetBits(UProperty* Property, const void* Data)
+{
+	if (Property->IsA(UBoolProperty::StaticClass()))
+	{
+		return 1;
+	}
+	if (UByteProperty* ByteProperty = Cast<UByteProperty>(Property))
+	{
+		return ByteProperty->Enum ? FMath::CeilLogTwo(ByteProperty->Enum->NumEnums()) : 8;
+	}
+	if (Property->IsA(UObjectPropertyBase::StaticClass()))
+	{
+		// net GUID
+		return 32;
+	}
+	if (Property->IsA(UStrProperty::StaticClass()))
+	{
+		return 32 + ((const FString*)Data)->Len() * 8;
+	}
+	if (Property->IsA(UNameProperty::StaticClass()))
+	{
+		return 32 + ((const FName*)Data)->ToString().Len() * 8;
+	}
+	if (UArrayProperty* ArrayProperty = Cast<UArrayProperty>(Property))
+	{
+		FScriptArrayHelper Helper(ArrayProperty, Data);
+		int32 Bits = 16;
+		for (int32 i = 0; i < Helper.Num(); i++)
+		{
+			Bits += EstimateNetBits(ArrayProperty->Inner, Helper.GetRawPtr(i));
+		}
+		return Bits;
+	}
+	if (UStructProperty* StructProperty = Cast<UStructProperty>(Property))
+	{
+		// natively serialized structs pack however they like, memory size is the upper bound
+		if ((StructProperty->Struct->StructFlags & STRUCT_NetSerializeNative) == 0)
+		{
+			int32 Bits = 0;
+			for (TFieldIterator<UProperty> It(StructProperty->Struct); It; ++It)
+			{
+				if ((It->PropertyFlags & CPF_RepSkip) == 0)
+				{
+					for (int32 i = 0; i < It->ArrayDim; i++)
+					{
+						Bits += EstimateNetBits(*It, It->ContainerPtrToValuePtr<void>(Data, i));
+					}
+				}
+			}
+			return Bits;
+		}
+	}
+
+	return Property->ElementSize * 8;
+}
+
+uint32 FShooterNetAccounting::HashValue(UProperty* Property, const void* Data, uint32 Crc)
+{
+	if (UBoolProperty* BoolProperty = Cast<UBoolProperty>(Property))
+	{
+		// bitfields share their byte with other flags
+		const uint8 Value = BoolProperty->GetPropertyValue(Data) ? 1 : 0;
+		return FCrc::MemCrc32(&Value, sizeof(Value), Crc);
+	}
+	if (Property->IsA(UStrProperty::StaticClass()))
+	{
+		return FCrc::StrCrc32(**(const FString*)Data, Crc);
+	}
+	if (UArrayProperty* ArrayProperty = Cast<UArrayProperty>(Property))
+	{
+		FScriptArrayHelper Helper(ArrayProperty, Data);
+		const int32 Num = Helper.Num();
+		Crc = FCrc::MemCrc32(&Num, sizeof(Num), Crc);
+		for (int32 i = 0; i < Num; i++)
+		{
+			Crc = HashValue(ArrayProperty->Inner, Helper.GetRawPtr(i), Crc);
+		}
+		return Crc;
+	}
+	if (UStructProperty* StructProperty = Cast<UStructProperty>(Property))
+	{
+		for (TFieldIterator<UProperty> It(StructProperty->Struct); It; ++It)
+		{
+			for (int32 i = 0; i < It->ArrayDim; i++)
+			{
+				Crc = HashValue(*It, It->ContainerPtrToValuePtr<void>(Data, i), Crc);
+			}
+		}
+		return Crc;
+	}
+
+	return FCrc::MemCrc32(Data, Property->ElementSize, Crc);
+}
+
+FShooterNetAccounting::FConnectionStats& FShooterNetAccounting::FindOrAddConnection(UNetConnection* Connection)
+{
+	int32 Index = INDEX_NONE;
+	if (const int32* Found = ConnectionIndices.Find(Connection))
+	{
+		Index = *Found;
+	}
+	else
+	{
+		Index = ConnectionStats.Add(FConnectionStats());
+		ConnectionIndices.Add(Connection, Index);
+
+		const bool bServer = Connection->Driver && Connection->Driver->ServerConnection == Connection;
+		ConnectionStats[Index].Name = bServer ? TEXT("Server") : Connection->LowLevelGetRemoteAddress();
+		ConnectionStats[Index].bHasPlayerName = bServer;
+	}
+
+	// player state shows up a bit after connection does
+	FConnectionStats& Stats = ConnectionStats[Index];
+	if (!Stats.bHasPlayerName && Connection->PlayerController && Connection->PlayerController->PlayerState)
+	{
+		Stats.Name = Connection->PlayerController->PlayerState->PlayerName;
+		Stats.bHasPlayerName = true;
+	}
+
+	return Stats;
+}
+
+void FShooterNetAccounting::AddEntry(UNetConnection* Connection, FName Name, bool bProperty, bool bReceived, bool bEstimated, int64 Bits)
+{
+	FNetEntry& Entry = FindOrAddConnection(Connection).Entries.FindOrAdd(Name);
+	Entry.bProperty = bProperty;
+	Entry.bReceived = bReceived;
+	Entry.bEstimated = bEstimated;
+	Entry.Count++;
+	Entry.Bits += Bits;
+}
+
+void FShooterNetAccounting::AddMulticastPayload(FName Name, int64 Bits)
+{
+	FNetEntry& Entry = MulticastPayloads.FindOrAdd(Name);
+	Entry.Count++;
+	Entry.UniqueBits += Bits;
+}
+
+void FShooterNetAccounting::DumpToLog() const
+{
+	if (ConnectionStats.Num() == 0)
+	{
+		UE_LOG(LogShooter, Log, TEXT("Net accounting: no traffic recorded%s"), bEnabled ? TEXT("") : TEXT(", enable with Shooter.NetAccounting 1"));
+		return;
+	}
+
+	TMap<FName, FNetEntry> Totals;
+	for (int32 i = 0; i < ConnectionStats.Num(); i++)
+	{
+		for (TMap<FName, FNetEntry>::TConstIterator It(ConnectionStats[i].Entries); It; ++It)
+		{
+			FNetEntry& Total = Totals.FindOrAdd(It.Key());
+			Total.bProperty = It.Value().bProperty;
+			Total.bReceived = It.Value().bReceived;
+			Total.bEstimated = It.Value().bEstimated;
+			Total.Count += It.Value().Count;
+			Total.Bits += It.Value().Bits;
+		}
+	}
+
+	for (TMap<FName, FNetEntry>::TConstIterator It(MulticastPayloads); It; ++It)
+	{
+		Totals.FindOrAdd(It.Key()).UniqueBits = It.Value().UniqueBits;
+	}
+
+	const auto LogEntries = [](const TMap<FName, FNetEntry>& Entries)
+	{
+		TArray<FName> Names;
+		Entries.GenerateKeyArray(Names);
+		Names.Sort([&Entries](const FName& A, const FName& B){ return Entries.FindRef(A).Bits > Entries.FindRef(B).Bits; });
+
+		for (int32 i = 0; i < Names.Num(); i++)
+		{
+			const FNetEntry& Entry = Entries.FindChecked(Names[i]);
+			const FString Unique = Entry.UniqueBits > 0 ? FString::Printf(TEXT(" %10.1f KB unique"), Entry.UniqueBits / 8192.0f) : FString();
+			UE_LOG(LogShooter, Log, TEXT("    %-24s %-8s %-4s %8d %10.1f KB%s%s"), *Names[i].ToString(), Entry.bProperty ? TEXT("property") : TEXT("rpc"),
+				Entry.bReceived ? TEXT("in") : TEXT("out"), Entry.Count, Entry.Bits / 8192.0f, *Unique, Entry.bEstimated ? TEXT(" (est)") : TEXT(""));
+		}
+	};
+
+	UE_LOG(LogShooter, Log, TEXT("Net accounting (name / kind / direction / count / size / multicast payload counted once per send):"));
+	UE_LOG(LogShooter, Log, TEXT("  All connections"));
+	LogEntries(Totals);
+
+	for (int32 i = 0; i < ConnectionStats.Num(); i++)
+	{
+		UE_LOG(LogShooter, Log, TEXT("  %s"), *ConnectionStats[i].Name);
+		LogEntries(ConnectionStats[i].Entries);
+	}
+}
+
+void FShooterNetAccounting::FlushToCSV(const FString& MapName)
+{
+	if (ConnectionStats.Num() == 0)
+	{
+		return;
+	}
+
+	const FString Filename = FPaths::GameSavedDir() / CsvFile;
+	const bool bNewFile = IFileManager::Get().FileSize(*Filename) <= 0;
+
+	FArchive* Ar = IFileManager::Get().CreateFileWriter(*Filename, FILEWRITE_Append);
+	if (Ar == NULL)
+	{
+		UE_LOG(LogShooter, Warning, TEXT("Net accounting: can't write %s"), *Filename);
+		return;
+	}
+
+	FString Csv;
+	if (bNewFile)
+	{
+		Csv += TEXT("Time,Map,Connection,Name,Kind,Direction,Count,Bytes,Estimated,UniqueBytes\n");
+	}
+
+	const FString Time = FDateTime::Now().ToString();
+	for (int32 i = 0; i < ConnectionStats.Num(); i++)
+	{
+		// player names are free text
+		const FString ConnectionName = ConnectionStats[i].Name.Replace(TEXT(","), TEXT(" "));
+		for (TMap<FName, FNetEntry>::TConstIterator It(ConnectionStats[i].Entries); It; ++It)
+		{
+			const FNetEntry& Entry = It.Value();
+			Csv += FString::Printf(TEXT("%s,%s,%s,%s,%s,%s,%d,%lld,%d,\n"), *Time, *MapName, *ConnectionName, *It.Key().ToString(),
+				Entry.bProperty ? TEXT("property") : TEXT("rpc"), Entry.bReceived ? TEXT("in") : TEXT("out"), Entry.Count, (Entry.Bits + 7) / 8, Entry.bEstimated ? 1 : 0);
+		}
+	}
+
+	// multicast payload counted once per send, Count is number of sends
+	for (TMap<FName, FNetEntry>::TConstIterator It(MulticastPayloads); It; ++It)
+	{
+		Csv += FString::Printf(TEXT("%s,%s,All,%s,rpc,out,%d,,0,%lld\n"), *Time, *MapName, *It.Key().ToString(), It.Value().Count, (It.Value().UniqueBits + 7) / 8);
+	}
+
+	FTCHARToUTF8 Utf8(*Csv);
+	Ar->Serialize((void*)Utf8.Get(), Utf8.Length());
+	delete Ar;
+
+	UE_LOG(LogShooter, Log, TEXT("Net accounting: appended %d connections to %s"), ConnectionStats.Num(), *Filename);
+
+	ConnectionStats.Empty();
+	ConnectionIndices.Empty();
+	MulticastPayloads.Empty();
+	LastValues.Empty();
+}
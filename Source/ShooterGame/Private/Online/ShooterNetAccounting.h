@@ -0,0 +1,213 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+/** opens or closes the window incoming RPCs are accepted in, see FShooterNetAccounting::SetReceiveWindow */
+struct FShooterNetReceiveTickFunction : public FTickFunction
+{
+	virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) OVERRIDE;
+	virtual FString DiagnosticMessage() OVERRIDE;
+};
+
+/**
+ * Attributes network bytes and call counts to each RPC and replicated property, per connection.
+ *
+ * Sent RPCs are measured on the connection send buffer around CallRemoteFunction, so they include bunch overhead.
+ * Multicast RPCs are counted on every connection they went out on, like any other RPC; totals also show a "unique" column
+ * with the payload counted once per send, the largest any connection got.
+ * Received RPCs and replicated properties can't be measured from game code and use an estimate of their serialized size;
+ * properties are counted once per replication pass they changed in, for every connection with an open channel the replication condition allows.
+ *
+ * The net driver delivers incoming RPCs at the start of the world tick, before the first tick group, so calls only count as received
+ * between the core ticker and the start of TG_PrePhysics. Server, client and multicast functions game code runs locally while actors,
+ * timers or tickable objects tick don't count. The game state registers the window, until it does every call counts.
+ *
+ * Off by default. "-NetAccounting", bEnabled in [ShooterGame.NetAccounting] of the Game ini or "Shooter.NetAccounting 1" turn it on,
+ * "Shooter.DumpNetAccounting" writes totals to the log and totals are appended to CsvFile under the Saved dir at match end.
+ * Outside of shipping builds "Shooter.TestNetAccounting" accounts a pawn RPC as run locally and as received, to check the window.
+ */
+class FShooterNetAccounting : public FTickerObjectBase
+{
+public:
+
+	/** accounts RPC sent by actor while in scope */
+	class FScopedSend
+	{
+	public:
+
+		FScopedSend(AActor* InActor, UFunction* InFunction);
+		~FScopedSend();
+
+	private:
+
+		/** actor sending RPC */
+		AActor* Actor;
+
+		/** RPC being sent */
+		UFunction* Function;
+
+		/** connections RPC can go out on */
+		TArray<UNetConnection*, TInlineAllocator<16> > Connections;
+
+		/** bits written to each connection before sending */
+		TArray<int64, TInlineAllocator<16> > StartBits;
+	};
+
+	/** returns the accounting */
+	static FShooterNetAccounting& Get();
+
+	/** is accounting running? */
+	FORCEINLINE bool IsEnabled() const
+	{
+		return bEnabled;
+	}
+
+	/** turns accounting on or off */
+	void SetEnabled(bool bInEnabled);
+
+	/** accounts RPC executed by actor if it came in over the network, call from ProcessEvent */
+	void AccountReceivedCall(AActor* Actor, UFunction* Function, void* Parameters);
+
+	/** starts closing the receive window at the start of level's world tick */
+	void RegisterReceiveWindow(ULevel* Level);
+
+	/** stops tracking the receive window in level's world, every call counts again */
+	void UnregisterReceiveWindow(ULevel* Level);
+
+	/** opens or closes the window calls are counted as received in */
+	void SetReceiveWindow(bool bOpen)
+	{
+		bReceiveWindowOpen = bOpen;
+	}
+
+	/** are calls counted as received now? */
+	bool IsReceiveWindowOpen() const
+	{
+		return bReceiveWindowOpen || !ReceiveWindowTick.IsTickFunctionRegistered();
+	}
+
+	/** accounts replicated properties of actor that changed since its last replication, call from PreReplication */
+	void AccountReplicatedProperties(AActor* Actor);
+
+	/** writes totals to the log */
+	void DumpToLog() const;
+
+	/** appends totals to the CSV file and starts over */
+	void FlushToCSV(const FString& MapName);
+
+	/** opens receive window for next world tick */
+	virtual bool Tick(float DeltaSeconds) OVERRIDE;
+
+private:
+
+	/** traffic attributed to single RPC or property */
+	struct FNetEntry
+	{
+		/** is it replicated property? */
+		bool bProperty;
+
+		/** was it received instead of sent? */
+		bool bReceived;
+
+		/** are bits estimated instead of measured? */
+		bool bEstimated;
+
+		/** number of calls or updates */
+		int32 Count;
+
+		/** bits sent or received */
+		int64 Bits;
+
+		/** bits of multicast payload counted once per send, 0 for anything else */
+		int64 UniqueBits;
+
+		FNetEntry()
+			: bProperty(false)
+			, bReceived(false)
+			, bEstimated(false)
+			, Count(0)
+			, Bits(0)
+			, UniqueBits(0)
+		{
+		}
+	};
+
+	/** traffic of single connection */
+	struct FConnectionStats
+	{
+		/** player name or remote address */
+		FString Name;
+
+		/** is Name final? */
+		bool bHasPlayerName;
+
+		/** traffic per RPC or property name */
+		TMap<FName, FNetEntry> Entries;
+
+		FConnectionStats()
+			: bHasPlayerName(false)
+		{
+		}
+	};
+
+	/** replicated property element of class and condition it replicates with */
+	struct FTrackedProperty
+	{
+		UProperty* Property;
+		int32 ArrayIndex;
+		ELifetimeCondition Condition;
+	};
+
+	FShooterNetAccounting();
+
+	/** adds traffic to connection */
+	void AddEntry(UNetConnection* Connection, FName Name, bool bProperty, bool bReceived, bool bEstimated, int64 Bits);
+
+	/** adds payload of sent multicast RPC, once for all connections */
+	void AddMulticastPayload(FName Name, int64 Bits);
+
+	/** returns stats of connection, adding them if needed */
+	FConnectionStats& FindOrAddConnection(UNetConnection* Connection);
+
+	/** returns replicated properties of class */
+	const TArray<FTrackedProperty>& GetTrackedProperties(AActor* Actor);
+
+	/** returns bits written to connection so far */
+	static int64 GetBitsWritten(UNetConnection* Connection);
+
+	/** returns rough serialized size of property value */
+	static int32 EstimateNetBits(UProperty* Property, const void* Data);
+
+	/** returns hash of property value, follows arrays, strings and struct members */
+	static uint32 HashValue(UProperty* Property, const void* Data, uint32 Crc);
+
+	/** is accounting running? */
+	bool bEnabled;
+
+	/** CSV file, relative to Saved dir */
+	FString CsvFile;
+
+	/** traffic per connection, in order of first traffic */
+	TArray<FConnectionStats> ConnectionStats;
+
+	/** index in ConnectionStats of each connection */
+	TMap<TWeakObjectPtr<UNetConnection>, int32> ConnectionIndices;
+
+	/** sends and payload of each multicast RPC, counted once for all connections */
+	TMap<FName, FNetEntry> MulticastPayloads;
+
+	/** closes receive window at start of world tick */
+	FShooterNetReceiveTickFunction ReceiveWindowTick;
+
+	/** level receive window is registered with, first game world to come up wins */
+	TWeakObjectPtr<ULevel> ReceiveWindowLevel;
+
+	/** are calls counted as received now? */
+	bool bReceiveWindowOpen;
+
+	/** replicated properties per class */
+	TMap<UClass*, TArray<FTrackedProperty> > ClassProperties;
+
+	/** hash of each tracked property at last replication of actor */
+	TMap<TWeakObjectPtr<AActor>, TArray<uint32> > LastValues;
+};
@@ -1,6 +1,7 @@
 // Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
 
 #include "ShooterGame.h"
+#include "ShooterNetAccounting.h"
 
 AShooterPlayerState::AShooterPlayerState(const class FPostConstructInitializeProperties& PCIP) : Super(PCIP)
 {
@@ -122,40 +123,23 @@ void AShooterPlayerState::ScorePoints(int32 Points)
 	Score += Points;
 }
 
-void AShooterPlayerState::InformAboutKill_Implementation(class AShooterPlayerState* KillerPlayerState, const UDamageType* KillerDamageType, class AShooterPlayerState* KilledPlayerState)
-{
-	//id can be null for bots
-	if (KillerPlayerState->UniqueId.IsValid())
-	{	
-		//search for the actual killer before calling OnKill()	
-		for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
-		{		
-			AShooterPlayerController* TestPC = Cast<AShooterPlayerController>(*It);
-			if (TestPC && TestPC->IsLocalController())
-			{
-				// a local player might not have an ID if it was created with CreateDebugPlayer.
-				ULocalPlayer* LocalPlayer = Cast<ULocalPlayer>(TestPC->Player);
-				TSharedPtr<FUniqueNetId> LocalID = LocalPlayer->GetUniqueNetId();
-				if (LocalID.IsValid() &&  *LocalPlayer->GetUniqueNetId() == *KillerPlayerState->UniqueId)
-				{			
-					TestPC->OnKill();
-				}
-			}
-		}
-	}
+void AShooterPlayerState::PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker)
+{
+	Super::PreReplication(ChangedPropertyTracker);
+
+	FShooterNetAccounting::Get().AccountReplicatedProperties(this);
 }
 
-void AShooterPlayerState::BroadcastDeath_Implementation(class AShooterPlayerState* KillerPlayerState, const UDamageType* KillerDamageType, class AShooterPlayerState* KilledPlayerState)
-{	
-	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
-	{
-		// all local players get death messages so they can update their huds.
-		AShooterPlayerController* TestPC = Cast<AShooterPlayerController>(*It);
-		if (TestPC && TestPC->IsLocalController())
-		{
-			TestPC->OnDeathMessage(KillerPlayerState, this, KillerDamageType);				
-		}
-	}	
+bool AShooterPlayerState::CallRemoteFunction(UFunction* Function, void* Parameters, FOutParmRec* OutParms, FFrame* Stack)
+{
+	FShooterNetAccounting::FScopedSend ScopedSend(this, Function);
+	return Super::CallRemoteFunction(Function, Parameters, OutParms, Stack);
+}
+
+void AShooterPlayerState::ProcessEvent(UFunction* Function, void* Parameters)
+{
+	FShooterNetAccounting::Get().AccountReceivedCall(this, Function, Parameters);
+	Super::ProcessEvent(Function, Parameters);
 }
 
 void AShooterPlayerState::GetLifetimeReplicatedProps( TArray< FLifetimeProperty > & OutLifetimeProps ) const
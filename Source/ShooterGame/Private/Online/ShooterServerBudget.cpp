@@ -0,0 +1,197 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "ShooterServerBudget.h"
+#include "ShooterConfigSection.h"
+
+/** shed level forced from console, INDEX_NONE if governor decides */
+static int32 GForcedShedLevel = INDEX_NONE;
+
+static void ForceShedLevel(const TArray<FString>& Args)
+{
+	GForcedShedLevel = Args.Num() > 0 ? FMath::Clamp(FCString::Atoi(*Args[0]), -1, (int32)EShooterShedWork::MAX) : INDEX_NONE;
+	UE_LOG(LogShooter, Log, TEXT("Server budget: forced shed level %d"), GForcedShedLevel);
+}
+
+FAutoConsoleCommand CmdForceShedLevel(
+	TEXT("Shooter.ForceShedLevel"),
+	TEXT("Pins server frame budget shed level, -1 or no argument lets the governor decide"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(ForceShedLevel)
+	);
+
+#if !UE_BUILD_SHIPPING
+/** busy time added to every server frame from console (ms) */
+static float GSimulatedLoadMs = 0.0f;
+
+static void SimulateServerLoad(const TArray<FString>& Args)
+{
+	GSimulatedLoadMs = Args.Num() > 0 ? FMath::Max(FCString::Atof(*Args[0]), 0.0f) : 0.0f;
+	UE_LOG(LogShooter, Log, TEXT("Server budget: simulating %.1fms of load per frame"), GSimulatedLoadMs);
+}
+
+static FAutoConsoleCommand CmdSimulateServerLoad(
+	TEXT("Shooter.SimulateServerLoad"),
+	TEXT("Busy waits given ms in every server frame, so the frame budget governor sheds work, no argument stops it"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(SimulateServerLoad)
+	);
+#endif
+
+void FShooterFrameStartTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+{
+	if (Budget)
+	{
+		Budget->MarkFrameStart();
+	}
+}
+
+FString FShooterFrameStartTickFunction::DiagnosticMessage()
+{
+	return TEXT("FShooterServerBudget frame start");
+}
+
+FShooterServerBudget::FShooterServerBudget()
+	: BudgetMs(25.0f)
+	, RestoreFraction(0.7f)
+	, ShedDelay(0.5f)
+	, RestoreDelay(3.0f)
+	, SmoothingFactor(0.1f)
+	, BotThinkInterval(0.5f)
+	, CosmeticInterval(0.25f)
+	, TelemetryInterval(5.0f)
+	, FrameStartCycles(0)
+	, SmoothedFrameMs(0.0f)
+	, PressureTime(0.0f)
+	, ShedLevel(0)
+{
+	FMemory::Memzero(TimeAtLevel, sizeof(TimeAtLevel));
+
+	const FShooterConfigSection Config(TEXT("ShooterGame.ServerBudget"));
+	Config.Get(TEXT("BudgetMs"), BudgetMs);
+	Config.Get(TEXT("RestoreFraction"), RestoreFraction);
+	Config.Get(TEXT("ShedDelay"), ShedDelay);
+	Config.Get(TEXT("RestoreDelay"), RestoreDelay);
+	Config.Get(TEXT("SmoothingFactor"), SmoothingFactor);
+	Config.Get(TEXT("BotThinkInterval"), BotThinkInterval);
+	Config.Get(TEXT("CosmeticInterval"), CosmeticInterval);
+	Config.Get(TEXT("TelemetryInterval"), TelemetryInterval);
+
+	FrameStartTick.TickGroup = TG_PrePhysics;
+	FrameStartTick.bCanEverTick = true;
+	FrameStartTick.bStartWithTickEnabled = true;
+	FrameStartTick.Budget = this;
+}
+
+FShooterServerBudget::~FShooterServerBudget()
+{
+	UnregisterFrameStart();
+}
+
+void FShooterServerBudget::RegisterFrameStart(ULevel* Level)
+{
+	if (Level && !FrameStartTick.IsTickFunctionRegistered())
+	{
+		FrameStartTick.RegisterTickFunction(Level);
+	}
+}
+
+void FShooterServerBudget::UnregisterFrameStart()
+{
+	if (FrameStartTick.IsTickFunctionRegistered())
+	{
+		FrameStartTick.UnRegisterTickFunction();
+	}
+	FrameStartCycles = 0;
+}
+
+void FShooterServerBudget::MarkFrameStart()
+{
+	FrameStartCycles = FPlatformTime::Cycles();
+
+#if !UE_BUILD_SHIPPING
+	if (GSimulatedLoadMs > 0.0f)
+	{
+		const double EndTime = FPlatformTime::Seconds() + GSimulatedLoadMs / 1000.0f;
+		while (FPlatformTime::Seconds() < EndTime)
+		{
+		}
+	}
+#endif
+}
+
+int32 FShooterServerBudget::GetShedLevel() const
+{
+	return GForcedShedLevel != INDEX_NONE ? GForcedShedLevel : ShedLevel;
+}
+
+const TCHAR* FShooterServerBudget::GetWorkName(EShooterShedWork::Type Work)
+{
+	switch (Work)
+	{
+		case EShooterShedWork::BotThink:			return TEXT("BotThink");
+		case EShooterShedWork::CosmeticMulticast:	return TEXT("CosmeticMulticast");
+		case EShooterShedWork::TelemetryFlush:		return TEXT("TelemetryFlush");
+		case EShooterShedWork::SpawnScoring:		return TEXT("SpawnScoring");
+		default:									return TEXT("None");
+	}
+}
+
+void FShooterServerBudget::Tick(float DeltaSeconds)
+{
+	TimeAtLevel[GetShedLevel()] += DeltaSeconds;
+
+	// world tick so far, idle time spent waiting for the next server tick isn't part of it
+	if (FrameStartCycles == 0)
+	{
+		return;
+	}
+	const float FrameMs = FPlatformTime::ToMilliseconds(FPlatformTime::Cycles() - FrameStartCycles);
+	FrameStartCycles = 0;
+
+	SmoothedFrameMs = FMath::Lerp(SmoothedFrameMs, FrameMs, SmoothingFactor);
+
+	const bool bOverBudget = SmoothedFrameMs > BudgetMs && ShedLevel < EShooterShedWork::MAX;
+	const bool bHeadroom = SmoothedFrameMs < BudgetMs * RestoreFraction && ShedLevel > 0;
+	if (!bOverBudget && !bHeadroom)
+	{
+		PressureTime = 0.0f;
+		return;
+	}
+
+	PressureTime += DeltaSeconds;
+	if (PressureTime < (bOverBudget ? ShedDelay : RestoreDelay))
+	{
+		return;
+	}
+
+	PressureTime = 0.0f;
+	if (bOverBudget)
+	{
+		UE_LOG(LogShooter, Log, TEXT("Server budget: frame %.1fms over %.1fms, shedding %s"), SmoothedFrameMs, BudgetMs, GetWorkName((EShooterShedWork::Type)ShedLevel));
+		ShedLevel++;
+	}
+	else
+	{
+		ShedLevel--;
+		UE_LOG(LogShooter, Log, TEXT("Server budget: frame %.1fms under %.1fms, restoring %s"), SmoothedFrameMs, BudgetMs, GetWorkName((EShooterShedWork::Type)ShedLevel));
+	}
+}
+
+void FShooterServerBudget::LogSummary()
+{
+	float TotalTime = 0.0f;
+	for (int32 i = 0; i <= EShooterShedWork::MAX; i++)
+	{
+		TotalTime += TimeAtLevel[i];
+	}
+
+	if (TotalTime > 0.0f)
+	{
+		UE_LOG(LogShooter, Log, TEXT("Server budget summary, %.1fms budget:"), BudgetMs);
+		for (int32 i = 0; i <= EShooterShedWork::MAX; i++)
+		{
+			UE_LOG(LogShooter, Log, TEXT("  shed level %d: %.1fs (%.1f%%)"), i, TimeAtLevel[i], 100.0f * TimeAtLevel[i] / TotalTime);
+		}
+	}
+
+	FMemory::Memzero(TimeAtLevel, sizeof(TimeAtLevel));
+}
@@ -0,0 +1,139 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+/** non-critical server work, in the order it gets shed */
+namespace EShooterShedWork
+{
+	enum Type
+	{
+		BotThink,
+		CosmeticMulticast,
+		TelemetryFlush,
+		SpawnScoring,
+		MAX,
+	};
+}
+
+/** marks start of the world tick for the server budget */
+struct FShooterFrameStartTickFunction : public FTickFunction
+{
+	/** budget timing the frame */
+	class FShooterServerBudget* Budget;
+
+	FShooterFrameStartTickFunction()
+		: Budget(NULL)
+	{
+	}
+
+	virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) OVERRIDE;
+	virtual FString DiagnosticMessage() OVERRIDE;
+};
+
+/**
+ * Server frame budget governor.
+ * Times the world tick on the game thread, from the start of TG_PrePhysics to the game mode's tick in TG_PostUpdateWork,
+ * so time the server sleeps between ticks doesn't count. Net driver receive and replication run outside of that window.
+ * While the smoothed time stays over budget, non-critical work is shed one EShooterShedWork step at a time.
+ * Steps are restored in reverse order once there is headroom again. Damage and hit registration are never shed.
+ *
+ * Level changes and a per-match summary go to the log for soak runs, "Shooter.ForceShedLevel N" pins the level (-1 releases it)
+ * and "Shooter.SimulateServerLoad Ms" adds busy time to every frame to watch the governor react.
+ * Tuned in [ShooterGame.ServerBudget] of the Game ini.
+ */
+class FShooterServerBudget
+{
+public:
+
+	FShooterServerBudget();
+	~FShooterServerBudget();
+
+	/** starts timing frames of level's world */
+	void RegisterFrameStart(ULevel* Level);
+
+	/** stops timing frames */
+	void UnregisterFrameStart();
+
+	/** called at start of world tick */
+	void MarkFrameStart();
+
+	/** samples frame up to now and updates shed level, called from the game mode's tick */
+	void Tick(float DeltaSeconds);
+
+	/** should given work be skipped or throttled? */
+	bool ShouldShed(EShooterShedWork::Type Work) const
+	{
+		return Work < GetShedLevel();
+	}
+
+	/** returns number of shed work types */
+	int32 GetShedLevel() const;
+
+	/** returns min time between decisions of single bot while bot think is shed */
+	float GetBotThinkInterval() const
+	{
+		return BotThinkInterval;
+	}
+
+	/** returns min time between cosmetic hit notifies of single weapon while cosmetics are shed */
+	float GetCosmeticInterval() const
+	{
+		return CosmeticInterval;
+	}
+
+	/** returns max age of cached telemetry while telemetry is shed */
+	float GetTelemetryInterval() const
+	{
+		return TelemetryInterval;
+	}
+
+	/** writes time spent on each level to the log and resets it */
+	void LogSummary();
+
+	/** returns display name of work type */
+	static const TCHAR* GetWorkName(EShooterShedWork::Type Work);
+
+private:
+
+	/** frame time budget (ms) */
+	float BudgetMs;
+
+	/** fraction of budget frame time has to drop below before work is restored */
+	float RestoreFraction;
+
+	/** how long frame time has to stay over budget before shedding next step */
+	float ShedDelay;
+
+	/** how long frame time has to stay under restore threshold before restoring last step */
+	float RestoreDelay;
+
+	/** weight of newest sample in smoothed frame time */
+	float SmoothingFactor;
+
+	/** min time between decisions of single bot while shed */
+	float BotThinkInterval;
+
+	/** min time between cosmetic hit notifies while shed */
+	float CosmeticInterval;
+
+	/** max age of cached telemetry while shed */
+	float TelemetryInterval;
+
+	/** ticks at start of world tick */
+	FShooterFrameStartTickFunction FrameStartTick;
+
+	/** cycle counter at start of current frame, 0 if it wasn't marked */
+	uint32 FrameStartCycles;
+
+	/** smoothed world tick time (ms) */
+	float SmoothedFrameMs;
+
+	/** time spent over budget or under restore threshold */
+	float PressureTime;
+
+	/** current shed level */
+	int32 ShedLevel;
+
+	/** time spent at each level since last summary */
+	float TimeAtLevel[EShooterShedWork::MAX + 1];
+};
@@ -0,0 +1,159 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "ShooterStatsExport.h"
+#include "ShooterServerBudget.h"
+#include "ShooterKillFeed.h"
+#include "Json.h"
+
+typedef TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR> > FShooterStatsJsonWriter;
+typedef TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR> > FShooterStatsJsonWriterFactory;
+
+FShooterStatsExport::FShooterStatsExport()
+	: CachedSignature(0)
+	, SnapshotTime(0.0f)
+	, bHasSnapshot(false)
+{
+}
+
+const FString& FShooterStatsExport::GetMatchStateJson(UWorld* World)
+{
+	static const FString EmptyJson(TEXT("{}"));
+
+	AShooterGameState* const GameState = World ? Cast<AShooterGameState>(World->GameState) : NULL;
+	if (GameState == NULL)
+	{
+		return EmptyJson;
+	}
+
+	// overloaded server serves slightly stale snapshot instead of checking for changes
+	AShooterGameMode* GameMode = Cast<AShooterGameMode>(World->GetAuthGameMode());
+	if (bHasSnapshot && GameMode && GameMode->GetServerBudget().ShouldShed(EShooterShedWork::TelemetryFlush) &&
+		World->GetRealTimeSeconds() - SnapshotTime < GameMode->GetServerBudget().GetTelemetryInterval())
+	{
+		return Buffer;
+	}
+
+	const uint32 Signature = ComputeSignature(World, GameState);
+	if (!bHasSnapshot || Signature != CachedSignature)
+	{
+		Serialize(World, GameState);
+		CachedSignature = Signature;
+		bHasSnapshot = true;
+	}
+	SnapshotTime = World->GetRealTimeSeconds();
+
+	return Buffer;
+}
+
+uint32 FShooterStatsExport::ComputeSignature(UWorld* World, AShooterGameState* GameState) const
+{
+	TArray<int32> Values;
+	Values.Reserve(8 + GameState->TeamScores.Num() + GameState->PlayerArray.Num() * 5);
+
+	Values.Add(GameState->RemainingTime);
+	Values.Add(GameState->bTimerPaused ? 1 : 0);
+	Values.Add(GameState->NumTeams);
+	Values.Add(GetTypeHash(GameState->GetMatchState()));
+	Values.Add(FCrc::StrCrc32(*World->GetMapName()));
+	Values.Append(GameState->TeamScores);
+	Values.Add(GameState->GetKillFeed().GetNewestEventId());
+
+	for (int32 i = 0; i < GameState->PlayerArray.Num(); i++)
+	{
+		const AShooterPlayerState* PlayerState = Cast<AShooterPlayerState>(GameState->PlayerArray[i]);
+		if (PlayerState)
+		{
+			Values.Add(FCrc::StrCrc32(*PlayerState->PlayerName));
+			Values.Add(PlayerState->GetTeamNum());
+			Values.Add(FMath::TruncToInt(PlayerState->Score));
+			Values.Add(PlayerState->GetKills());
+			Values.Add(PlayerState->GetDeaths());
+		}
+	}
+
+	return FCrc::MemCrc32(Values.GetData(), Values.Num() * Values.GetTypeSize());
+}
+
+void FShooterStatsExport::Serialize(UWorld* World, AShooterGameState* GameState)
+{
+	// keep the allocation, snapshots are about the same size every time
+	Buffer.Empty(Buffer.Len());
+
+	TSharedRef<FShooterStatsJsonWriter> Writer = FShooterStatsJsonWriterFactory::Create(&Buffer);
+	Writer->WriteObjectStart();
+
+	Writer->WriteValue(TEXT("map"), World->GetMapName());
+	Writer->WriteValue(TEXT("matchState"), GameState->GetMatchState().ToString());
+	Writer->WriteValue(TEXT("remainingTime"), GameState->RemainingTime);
+	Writer->WriteValue(TEXT("timerPaused"), GameState->bTimerPaused);
+
+	const int32 NumTeams = FMath::Max(GameState->NumTeams, 1);
+	RankedPlayerMap Players;
+
+	Writer->WriteArrayStart(TEXT("teams"));
+	for (int32 TeamIndex = 0; TeamIndex < NumTeams; TeamIndex++)
+	{
+		Writer->WriteObjectStart();
+		Writer->WriteValue(TEXT("team"), TeamIndex);
+		Writer->WriteValue(TEXT("score"), GameState->TeamScores.IsValidIndex(TeamIndex) ? GameState->TeamScores[TeamIndex] : 0);
+
+		GameState->GetRankedMap(TeamIndex, Players);
+		Writer->WriteArrayStart(TEXT("players"));
+		for (auto It = Players.CreateConstIterator(); It; ++It)
+		{
+			const AShooterPlayerState* PlayerState = It.Value().Get();
+			if (PlayerState)
+			{
+				Writer->WriteObjectStart();
+				Writer->WriteValue(TEXT("name"), PlayerState->PlayerName);
+				Writer->WriteValue(TEXT("score"), FMath::TruncToInt(PlayerState->Score));
+				Writer->WriteValue(TEXT("kills"), PlayerState->GetKills());
+				Writer->WriteValue(TEXT("deaths"), PlayerState->GetDeaths());
+				Writer->WriteObjectEnd();
+			}
+		}
+		Writer->WriteArrayEnd();
+
+		Writer->WriteObjectEnd();
+	}
+	Writer->WriteArrayEnd();
+
+	// flat list in the format the companion app reads
+	Writer->WriteArrayStart(TEXT("scoreboard"));
+	for (int32 TeamIndex = 0; TeamIndex < NumTeams; TeamIndex++)
+	{
+		GameState->GetRankedMap(TeamIndex, Players);
+		for (auto It = Players.CreateConstIterator(); It; ++It)
+		{
+			const AShooterPlayerState* PlayerState = It.Value().Get();
+			if (PlayerState)
+			{
+				Writer->WriteObjectStart();
+				Writer->WriteValue(TEXT("n"), PlayerState->GetShortPlayerName());
+				Writer->WriteValue(TEXT("k"), FString::FromInt(PlayerState->GetKills()));
+				Writer->WriteValue(TEXT("d"), FString::FromInt(PlayerState->GetDeaths()));
+				Writer->WriteObjectEnd();
+			}
+		}
+	}
+	Writer->WriteArrayEnd();
+
+	// recent kills, newest first
+	const FShooterKillFeed& KillFeed = GameState->GetKillFeed();
+	Writer->WriteArrayStart(TEXT("kills"));
+	for (int32 Age = 0; Age < KillFeed.Num(); Age++)
+	{
+		const FShooterKillFeedEntry& Entry = KillFeed.GetEntry(Age);
+		Writer->WriteObjectStart();
+		Writer->WriteValue(TEXT("killer"), Entry.KillerDesc);
+		Writer->WriteValue(TEXT("victim"), Entry.VictimDesc);
+		Writer->WriteValue(TEXT("damageType"), Entry.DamageType.IsValid() ? Entry.DamageType->GetClass()->GetName() : FString());
+		Writer->WriteValue(TEXT("time"), Entry.Time);
+		Writer->WriteObjectEnd();
+	}
+	Writer->WriteArrayEnd();
+
+	Writer->WriteObjectEnd();
+	Writer->Close();
+}
@@ -0,0 +1,38 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+/**
+ * Serializes match state (map, timer, teams, players) to JSON for external monitoring.
+ * The JSON is kept in a reusable buffer and only rewritten when a cheap state signature changes,
+ * so repeated scrapes of an unchanged match cost one pass over the player scores.
+ */
+class FShooterStatsExport
+{
+public:
+
+	FShooterStatsExport();
+
+	/** returns JSON snapshot of match state in given world, empty object if there is no match */
+	const FString& GetMatchStateJson(UWorld* World);
+
+private:
+
+	/** cheap checksum of everything that ends up in the JSON */
+	uint32 ComputeSignature(UWorld* World, class AShooterGameState* GameState) const;
+
+	/** writes JSON for match state into Buffer */
+	void Serialize(UWorld* World, class AShooterGameState* GameState);
+
+	/** last serialized JSON */
+	FString Buffer;
+
+	/** signature of state in Buffer */
+	uint32 CachedSignature;
+
+	/** real time Buffer was last checked against match state */
+	float SnapshotTime;
+
+	/** is Buffer valid? */
+	bool bHasSnapshot;
+};
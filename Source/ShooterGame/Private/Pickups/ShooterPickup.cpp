@@ -1,6 +1,8 @@
 // Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
 
 #include "ShooterGame.h"
+#include "ShooterPickupRegistry.h"
+#include "ShooterPickupScheduler.h"
 
 AShooterPickup::AShooterPickup(const class FPostConstructInitializeProperties& PCIP) : Super(PCIP)
 {
@@ -29,13 +31,38 @@ void AShooterPickup::BeginPlay()
 {
 	Super::BeginPlay();
 
+	// register in pickup registry (server only), active state follows from RespawnPickup
+	AShooterGameMode* GameMode = GetWorld()->GetAuthGameMode<AShooterGameMode>();
+	if (GameMode)
+	{
+		GameMode->GetPickupRegistry().Register(this);
+	}
+
 	RespawnPickup();
+}
+
+void AShooterPickup::Destroyed()
+{
+	AShooterGameMode* GameMode = GetWorld() ? GetWorld()->GetAuthGameMode<AShooterGameMode>() : NULL;
+	if (GameMode)
+	{
+		GameMode->GetPickupRegistry().Unregister(this);
+	}
+
+	Super::Destroyed();
+}
+
+UClass* AShooterPickup::GetPickupItemClass() const
+{
+	return NULL;
+}
 
-	// register on pickup list (server only), don't care about unregistering (in FinishDestroy) - no streaming
+void AShooterPickup::UpdateRegistry()
+{
 	AShooterGameMode* GameMode = GetWorld()->GetAuthGameMode<AShooterGameMode>();
 	if (GameMode)
 	{
-		GameMode->LevelPickups.Add(this);
+		GameMode->GetPickupRegistry().SetActive(this, bIsActive);
 	}
 }
 
@@ -67,10 +94,19 @@ void AShooterPickup::PickupOnTouch(class AShooterCharacter* Pawn)
 			{
 				bIsActive = false;
 				OnPickedUp();
+				UpdateRegistry();
 
 				if (RespawnTime > 0.0f)
 				{
-					GetWorldTimerManager().SetTimer(this, &AShooterPickup::RespawnPickup, RespawnTime, false);
+					AShooterGameMode* GameMode = GetWorld()->GetAuthGameMode<AShooterGameMode>();
+					if (GameMode)
+					{
+						GameMode->GetPickupScheduler().ScheduleRespawn(GetWorld(), this, RespawnTime);
+					}
+					else
+					{
+						GetWorldTimerManager().SetTimer(this, &AShooterPickup::RespawnPickup, RespawnTime, false);
+					}
 				}
 			}
 		}
@@ -82,14 +118,43 @@ void AShooterPickup::RespawnPickup()
 	bIsActive = true;
 	PickedUpBy = NULL;
 	OnRespawned();
+	UpdateRegistry();
+}
+
+void AShooterPickup::RespawnForPawns(const TArray<AShooterCharacter*>& NearbyPawns)
+{
+	RespawnPickup();
+
+	// pawns already inside don't get a new overlap event
+	for (int32 i = 0; i < NearbyPawns.Num() && bIsActive; i++)
+	{
+		if (IsTouchedBy(NearbyPawns[i]))
+		{
+			PickupOnTouch(NearbyPawns[i]);
+		}
+	}
+}
 
-	TArray<AActor*> OverlappingPawns;
-	GetOverlappingActors(OverlappingPawns, AShooterCharacter::StaticClass());
+float AShooterPickup::GetTouchRadius() const
+{
+	const UCapsuleComponent* Capsule = Cast<UCapsuleComponent>(GetRootComponent());
+	return Capsule ? Capsule->GetScaledCapsuleRadius() + Capsule->GetScaledCapsuleHalfHeight() : 0.0f;
+}
 
-	for (int32 i = 0; i < OverlappingPawns.Num(); i++)
+bool AShooterPickup::IsTouchedBy(const AShooterCharacter* Pawn) const
+{
+	const UCapsuleComponent* Capsule = Cast<UCapsuleComponent>(GetRootComponent());
+	if (Capsule == NULL || Pawn == NULL || !Pawn->CapsuleComponent.IsValid())
 	{
-		PickupOnTouch(Cast<AShooterCharacter>(OverlappingPawns[i]));	
+		return false;
 	}
+
+	// both capsules are upright, compare as cylinders
+	const FVector Delta = Pawn->GetActorLocation() - GetActorLocation();
+	const float MaxDist2D = Capsule->GetScaledCapsuleRadius() + Pawn->CapsuleComponent->GetScaledCapsuleRadius();
+	const float MaxDistZ = Capsule->GetScaledCapsuleHalfHeight() + Pawn->CapsuleComponent->GetScaledCapsuleHalfHeight();
+
+	return Delta.SizeSquared2D() <= FMath::Square(MaxDist2D) && FMath::Abs(Delta.Z) <= MaxDistZ;
 }
 
 void AShooterPickup::OnPickedUp()
@@ -0,0 +1,205 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "ShooterPickupRegistry.h"
+#include "ShooterDevHelper.h"
+
+#if !UE_BUILD_SHIPPING
+static void TestPickupSearch()
+{
+	UWorld* World = ShooterDevHelper::GetWorld();
+	AShooterGameMode* Game = World ? World->GetAuthGameMode<AShooterGameMode>() : NULL;
+	AShooterCharacter* Pawn = ShooterDevHelper::GetTestPawn(World);
+	if (Game == NULL || Pawn == NULL)
+	{
+		UE_LOG(LogShooter, Warning, TEXT("TestPickupSearch: needs a game with authority and a live pawn"));
+		return;
+	}
+
+	const FVector Location = Pawn->GetActorLocation();
+	const int32 NumQueries = 1000;
+
+	AShooterPickup* Found = NULL;
+	const double StartTime = FPlatformTime::Seconds();
+	for (int32 i = 0; i < NumQueries; i++)
+	{
+		Found = Game->GetPickupRegistry().FindNearestAvailable(AShooterPickup::StaticClass(), NULL, Location, Pawn);
+	}
+	const double QueryTime = (FPlatformTime::Seconds() - StartTime) / NumQueries;
+
+	// brute force over every pickup in the level
+	AShooterPickup* Expected = NULL;
+	float ExpectedDistSq = MAX_FLT;
+	for (TActorIterator<AShooterPickup> It(World); It; ++It)
+	{
+		const float DistSq = FVector::DistSquared(It->GetActorLocation(), Location);
+		if (DistSq < ExpectedDistSq && !It->IsPendingKill() && It->CanBePickedUp(Pawn))
+		{
+			ExpectedDistSq = DistSq;
+			Expected = *It;
+		}
+	}
+
+	UE_LOG(LogShooter, Log, TEXT("TestPickupSearch: nearest pickup for %s is %s (%.1f us per query), level scan finds %s%s"), *Pawn->GetName(),
+		*GetNameSafe(Found), QueryTime * 1000000.0, *GetNameSafe(Expected), Found == Expected ? TEXT("") : TEXT(" - MISMATCH"));
+}
+
+static FAutoConsoleCommand CmdTestPickupSearch(
+	TEXT("Shooter.TestPickupSearch"),
+	TEXT("Times the nearest available pickup query from the local pawn and checks it against a scan of every pickup in the level"),
+	FConsoleCommandDelegate::CreateStatic(TestPickupSearch)
+	);
+#endif
+
+FShooterPickupRegistry::FShooterPickupRegistry(float InCellSize)
+	: CellSize(FMath::Max(InCellSize, 1.0f))
+{
+}
+
+FIntPoint FShooterPickupRegistry::GetCell(const FVector& Location) const
+{
+	return FIntPoint(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize));
+}
+
+void FShooterPickupRegistry::Register(AShooterPickup* Pickup)
+{
+	if (Pickup == NULL || Pickups.Contains(Pickup))
+	{
+		return;
+	}
+
+	FPickupEntry Entry;
+	Entry.Type = FPickupType(Pickup->GetClass(), Pickup->GetPickupItemClass());
+	Entry.Cell = GetCell(Pickup->GetActorLocation());
+	Entry.bActive = false;
+	Pickups.Add(Pickup, Entry);
+
+	// pickups don't move, cell bounds only grow
+	FTypeIndex& Index = Types.FindOrAdd(Entry.Type);
+	Index.MinCell = FIntPoint(FMath::Min(Index.MinCell.X, Entry.Cell.X), FMath::Min(Index.MinCell.Y, Entry.Cell.Y));
+	Index.MaxCell = FIntPoint(FMath::Max(Index.MaxCell.X, Entry.Cell.X), FMath::Max(Index.MaxCell.Y, Entry.Cell.Y));
+}
+
+void FShooterPickupRegistry::Unregister(AShooterPickup* Pickup)
+{
+	SetActive(Pickup, false);
+	Pickups.Remove(Pickup);
+}
+
+void FShooterPickupRegistry::SetActive(AShooterPickup* Pickup, bool bActive)
+{
+	FPickupEntry* Entry = Pickups.Find(Pickup);
+	if (Entry == NULL || Entry->bActive == bActive)
+	{
+		return;
+	}
+
+	Entry->bActive = bActive;
+
+	FTypeIndex& Index = Types.FindChecked(Entry->Type);
+	if (bActive)
+	{
+		Index.Cells.FindOrAdd(Entry->Cell).Add(Pickup);
+		Index.NumActive++;
+	}
+	else
+	{
+		TArray<AShooterPickup*>* CellPickups = Index.Cells.Find(Entry->Cell);
+		if (CellPickups)
+		{
+			CellPickups->RemoveSingleSwap(Pickup);
+		}
+		Index.NumActive--;
+	}
+}
+
+AShooterPickup* FShooterPickupRegistry::FindNearestAvailable(UClass* PickupClass, UClass* ItemClass, const FVector& Location, AShooterCharacter* ForPawn) const
+{
+	AShooterPickup* BestPickup = NULL;
+	float BestDistSq = MAX_FLT;
+
+	for (auto It = Types.CreateConstIterator(); It; ++It)
+	{
+		const FPickupType& Type = It.Key();
+		const bool bMatchingPickup = PickupClass == NULL || Type.PickupClass->IsChildOf(PickupClass);
+		const bool bMatchingItem = ItemClass == NULL || (Type.ItemClass && Type.ItemClass->IsChildOf(ItemClass));
+
+		if (bMatchingPickup && bMatchingItem && It.Value().NumActive > 0)
+		{
+			FindNearestInType(It.Value(), Location, ForPawn, BestPickup, BestDistSq);
+		}
+	}
+
+	return BestPickup;
+}
+
+void FShooterPickupRegistry::FindNearestInType(const FTypeIndex& Index, const FVector& Location, AShooterCharacter* ForPawn, AShooterPickup*& InOutBest, float& InOutBestDistSq) const
+{
+	const FIntPoint Center = GetCell(Location);
+	const int32 MaxRing = FMath::Max(
+		FMath::Max(FMath::Abs(Center.X - Index.MinCell.X), FMath::Abs(Index.MaxCell.X - Center.X)),
+		FMath::Max(FMath::Abs(Center.Y - Index.MinCell.Y), FMath::Abs(Index.MaxCell.Y - Center.Y)));
+
+	for (int32 Ring = 0; Ring <= MaxRing; Ring++)
+	{
+		// anything in this ring or further out is at least (Ring - 1) cells away
+		const float RingDist = FMath::Max(0, Ring - 1) * CellSize;
+		if (InOutBestDistSq <= FMath::Square(RingDist))
+		{
+			return;
+		}
+
+		if (Ring == 0)
+		{
+			SearchCell(Index, Center, Location, ForPawn, InOutBest, InOutBestDistSq);
+			continue;
+		}
+
+		// ring border only, clipped to cells of this type: full rows at top and bottom, columns in between
+		const int32 MinX = FMath::Max(Center.X - Ring, Index.MinCell.X);
+		const int32 MaxX = FMath::Min(Center.X + Ring, Index.MaxCell.X);
+		for (int32 Y = Center.Y - Ring; Y <= Center.Y + Ring; Y += 2 * Ring)
+		{
+			if (Y >= Index.MinCell.Y && Y <= Index.MaxCell.Y)
+			{
+				for (int32 X = MinX; X <= MaxX; X++)
+				{
+					SearchCell(Index, FIntPoint(X, Y), Location, ForPawn, InOutBest, InOutBestDistSq);
+				}
+			}
+		}
+
+		const int32 MinY = FMath::Max(Center.Y - Ring + 1, Index.MinCell.Y);
+		const int32 MaxY = FMath::Min(Center.Y + Ring - 1, Index.MaxCell.Y);
+		for (int32 X = Center.X - Ring; X <= Center.X + Ring; X += 2 * Ring)
+		{
+			if (X >= Index.MinCell.X && X <= Index.MaxCell.X)
+			{
+				for (int32 Y = MinY; Y <= MaxY; Y++)
+				{
+					SearchCell(Index, FIntPoint(X, Y), Location, ForPawn, InOutBest, InOutBestDistSq);
+				}
+			}
+		}
+	}
+}
+
+void FShooterPickupRegistry::SearchCell(const FTypeIndex& Index, const FIntPoint& Cell, const FVector& Location, AShooterCharacter* ForPawn, AShooterPickup*& InOutBest, float& InOutBestDistSq) const
+{
+	const TArray<AShooterPickup*>* CellPickups = Index.Cells.Find(Cell);
+	if (CellPickups == NULL)
+	{
+		return;
+	}
+
+	for (int32 i = 0; i < CellPickups->Num(); i++)
+	{
+		AShooterPickup* Pickup = (*CellPickups)[i];
+		const float DistSq = FVector::DistSquared(Pickup->GetActorLocation(), Location);
+		if (DistSq < InOutBestDistSq && !Pickup->IsPendingKill() && Pickup->CanBePickedUp(ForPawn))
+		{
+			InOutBestDistSq = DistSq;
+			InOutBest = Pickup;
+		}
+	}
+}
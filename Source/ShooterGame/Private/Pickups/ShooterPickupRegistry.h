@@ -0,0 +1,108 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+/**
+ * Server-side index of level pickups, grouped by pickup class and the item they give (e.g. weapon type of ammo).
+ * Active pickups of each type are kept in a uniform 2D grid, updated when pickups are picked up and respawn,
+ * so nearest-available queries only look at cells around the querier, ring by ring outward.
+ *
+ * Outside of shipping builds "Shooter.TestPickupSearch" checks the query from the local pawn against a scan of all pickups.
+ */
+class FShooterPickupRegistry
+{
+public:
+
+	FShooterPickupRegistry(float InCellSize = 2048.0f);
+
+	/** adds pickup, inactive until SetActive */
+	void Register(class AShooterPickup* Pickup);
+
+	/** removes pickup */
+	void Unregister(class AShooterPickup* Pickup);
+
+	/** moves pickup in or out of the active grid of its type */
+	void SetActive(class AShooterPickup* Pickup, bool bActive);
+
+	/**
+	 * Finds closest active pickup the pawn can use.
+	 *
+	 * @param PickupClass	pickup class or any of its parents
+	 * @param ItemClass		class of given item or any of its parents, NULL to accept any
+	 * @param Location		where to search from
+	 * @param ForPawn		pawn that wants the pickup, passed to CanBePickedUp
+	 */
+	class AShooterPickup* FindNearestAvailable(UClass* PickupClass, UClass* ItemClass, const FVector& Location, class AShooterCharacter* ForPawn) const;
+
+private:
+
+	/** pickup class and class of item it gives */
+	struct FPickupType
+	{
+		UClass* PickupClass;
+		UClass* ItemClass;
+
+		FPickupType(UClass* InPickupClass = NULL, UClass* InItemClass = NULL)
+			: PickupClass(InPickupClass)
+			, ItemClass(InItemClass)
+		{
+		}
+
+		bool operator==(const FPickupType& Other) const
+		{
+			return PickupClass == Other.PickupClass && ItemClass == Other.ItemClass;
+		}
+
+		friend uint32 GetTypeHash(const FPickupType& Type)
+		{
+			return HashCombine(PointerHash(Type.PickupClass), PointerHash(Type.ItemClass));
+		}
+	};
+
+	/** active pickups of single type */
+	struct FTypeIndex
+	{
+		/** active pickups in each occupied cell */
+		TMap<FIntPoint, TArray<class AShooterPickup*> > Cells;
+
+		/** bounds of cells pickups of this type were ever registered in */
+		FIntPoint MinCell;
+		FIntPoint MaxCell;
+
+		/** number of active pickups */
+		int32 NumActive;
+
+		FTypeIndex()
+			: MinCell(MAX_int32, MAX_int32)
+			, MaxCell(MIN_int32, MIN_int32)
+			, NumActive(0)
+		{
+		}
+	};
+
+	/** registered pickup */
+	struct FPickupEntry
+	{
+		FPickupType Type;
+		FIntPoint Cell;
+		bool bActive;
+	};
+
+	/** returns grid cell for given location */
+	FIntPoint GetCell(const FVector& Location) const;
+
+	/** searches single type outward from Location, only accepts pickups closer than InOutBestDistSq */
+	void FindNearestInType(const FTypeIndex& Index, const FVector& Location, class AShooterCharacter* ForPawn, class AShooterPickup*& InOutBest, float& InOutBestDistSq) const;
+
+	/** checks active pickups of single cell, only accepts pickups closer than InOutBestDistSq */
+	void SearchCell(const FTypeIndex& Index, const FIntPoint& Cell, const FVector& Location, class AShooterCharacter* ForPawn, class AShooterPickup*& InOutBest, float& InOutBestDistSq) const;
+
+	/** size of single grid cell */
+	float CellSize;
+
+	/** active pickups per type */
+	TMap<FPickupType, FTypeIndex> Types;
+
+	/** every registered pickup */
+	TMap<class AShooterPickup*, FPickupEntry> Pickups;
+};
@@ -0,0 +1,95 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "ShooterPickupScheduler.h"
+#include "ShooterPawnSpatialIndex.h"
+#include "ShooterDevHelper.h"
+
+#if !UE_BUILD_SHIPPING
+static void DumpPickupRespawns()
+{
+	UWorld* World = ShooterDevHelper::GetWorld();
+	AShooterGameMode* Game = World ? World->GetAuthGameMode<AShooterGameMode>() : NULL;
+	if (Game)
+	{
+		Game->GetPickupScheduler().Dump(World, Game->GetPawnSpatialIndex());
+	}
+}
+
+static FAutoConsoleCommand CmdDumpPickupRespawns(
+	TEXT("Shooter.DumpPickupRespawns"),
+	TEXT("Logs pickups waiting to respawn in order, with time left and pawns standing on them that get them right away"),
+	FConsoleCommandDelegate::CreateStatic(DumpPickupRespawns)
+	);
+#endif
+
+void FShooterPickupScheduler::ScheduleRespawn(UWorld* World, AShooterPickup* Pickup, float Delay)
+{
+	FPendingRespawn Entry;
+	Entry.Pickup = Pickup;
+	Entry.Time = World->GetTimeSeconds() + Delay;
+	Queue.HeapPush(Entry, FRespawnTimePredicate());
+}
+
+void FShooterPickupScheduler::Tick(UWorld* World, FShooterPawnSpatialIndex& PawnIndex)
+{
+	const float Now = World->GetTimeSeconds();
+
+	DuePickups.Reset();
+	while (Queue.Num() > 0 && Queue.HeapTop().Time <= Now)
+	{
+		FPendingRespawn Entry;
+		Queue.HeapPop(Entry, FRespawnTimePredicate());
+
+		AShooterPickup* Pickup = Entry.Pickup.Get();
+		if (Pickup && !Pickup->IsPendingKill())
+		{
+			DuePickups.Add(Pickup);
+		}
+	}
+
+	for (int32 i = 0; i < DuePickups.Num(); i++)
+	{
+		AShooterPickup* Pickup = DuePickups[i];
+
+		// grid lookup is shared by all queries this frame
+		NearbyPawns.Reset();
+		PawnIndex.QuerySphere(World, Pickup->GetActorLocation(), Pickup->GetTouchRadius(), NearbyPawns);
+
+		Pickup->RespawnForPawns(NearbyPawns);
+	}
+}
+
+void FShooterPickupScheduler::Dump(UWorld* World, FShooterPawnSpatialIndex& PawnIndex)
+{
+	const float Now = World->GetTimeSeconds();
+
+	TArray<FPendingRespawn> Sorted = Queue;
+	Sorted.Sort(FRespawnTimePredicate());
+
+	UE_LOG(LogShooter, Log, TEXT("Pickup scheduler: %d pickups waiting to respawn"), Sorted.Num());
+	for (int32 i = 0; i < Sorted.Num(); i++)
+	{
+		AShooterPickup* Pickup = Sorted[i].Pickup.Get();
+		if (Pickup == NULL)
+		{
+			UE_LOG(LogShooter, Log, TEXT("  (destroyed) in %.1fs"), Sorted[i].Time - Now);
+			continue;
+		}
+
+		// same lookup the respawn does
+		NearbyPawns.Reset();
+		PawnIndex.QuerySphere(World, Pickup->GetActorLocation(), Pickup->GetTouchRadius(), NearbyPawns);
+
+		FString Touching;
+		for (int32 PawnIdx = 0; PawnIdx < NearbyPawns.Num(); PawnIdx++)
+		{
+			if (Pickup->IsTouchedBy(NearbyPawns[PawnIdx]))
+			{
+				Touching += (Touching.Len() > 0 ? TEXT(", ") : TEXT(", touched by ")) + NearbyPawns[PawnIdx]->GetName();
+			}
+		}
+
+		UE_LOG(LogShooter, Log, TEXT("  %s in %.1fs, %d pawns near%s"), *Pickup->GetName(), Sorted[i].Time - Now, NearbyPawns.Num(), *Touching);
+	}
+}
@@ -0,0 +1,57 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+/**
+ * Owns respawn timers of all level pickups in a single queue ordered by respawn time.
+ * Due pickups are respawned together once per tick; pawns already standing on them are found through the
+ * game mode's pawn spatial index and an analytic capsule test instead of a physics overlap query per pickup.
+ *
+ * Outside of shipping builds "Shooter.DumpPickupRespawns" lists pending respawns with the pawns that would get them.
+ */
+class FShooterPickupScheduler
+{
+public:
+
+	/** queues pickup to respawn after Delay */
+	void ScheduleRespawn(UWorld* World, class AShooterPickup* Pickup, float Delay);
+
+	/** respawns pickups that are due */
+	void Tick(UWorld* World, class FShooterPawnSpatialIndex& PawnIndex);
+
+	/** writes pending respawns and pawns standing on them to the log */
+	void Dump(UWorld* World, class FShooterPawnSpatialIndex& PawnIndex);
+
+	/** returns number of pickups waiting to respawn */
+	int32 GetNumPending() const
+	{
+		return Queue.Num();
+	}
+
+private:
+
+	/** pickup waiting to respawn */
+	struct FPendingRespawn
+	{
+		TWeakObjectPtr<class AShooterPickup> Pickup;
+		float Time;
+	};
+
+	/** orders queue by respawn time */
+	struct FRespawnTimePredicate
+	{
+		bool operator()(const FPendingRespawn& A, const FPendingRespawn& B) const
+		{
+			return A.Time < B.Time;
+		}
+	};
+
+	/** binary heap, earliest respawn on top */
+	TArray<FPendingRespawn> Queue;
+
+	/** pickups due this tick, kept around to avoid allocations */
+	TArray<class AShooterPickup*> DuePickups;
+
+	/** pawns near due pickup, kept around to avoid allocations */
+	TArray<class AShooterCharacter*> NearbyPawns;
+};
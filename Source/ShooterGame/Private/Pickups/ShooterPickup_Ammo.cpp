@@ -12,6 +12,11 @@ bool AShooterPickup_Ammo::IsForWeapon(UClass* WeaponClass)
 	return WeaponType->IsChildOf(WeaponClass);
 }
 
+UClass* AShooterPickup_Ammo::GetPickupItemClass() const
+{
+	return WeaponType;
+}
+
 bool AShooterPickup_Ammo::CanBePickedUp(class AShooterCharacter* TestPawn) const
 {
 	AShooterWeapon* TestWeapon = (TestPawn ? TestPawn->FindWeapon(WeaponType) : NULL);
@@ -1,6 +1,11 @@
 // Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
 
 #include "ShooterGame.h"
+#include "Sound/ShooterAudioVoiceManager.h"
+#include "Player/ShooterCharacterUpdateManager.h"
+#include "Online/ShooterServerBudget.h"
+#include "Online/ShooterNetAccounting.h"
+#include "Bots/ShooterPerceptionBus.h"
 
 AShooterCharacter::AShooterCharacter(const class FPostConstructInitializeProperties& PCIP) 
 	: Super(PCIP.SetDefaultSubobjectClass<UShooterCharacterMovement>(ACharacter::CharacterMovementComponentName))
@@ -37,6 +42,8 @@ AShooterCharacter::AShooterCharacter(const class FPostConstructInitializePropert
 	bWantsToRun = false;
 	bWantsToFire = false;
 	LowHealthPercentage = 0.5f;
+	MaxHealth = 0;
+	bRegisteredForUpdates = false;
 
 	BaseTurnRate = 45.f;
 	BaseLookUpRate = 45.f;
@@ -46,6 +53,9 @@ void AShooterCharacter::PostInitializeComponents()
 {
 	Super::PostInitializeComponents();
 
+	MaxHealth = GetClass()->GetDefaultObject<AShooterCharacter>()->Health;
+	RegisterForUpdates();
+
 	if (Role == ROLE_Authority)
 	{
 		Health = GetMaxHealth();
@@ -80,6 +90,7 @@ void AShooterCharacter::Destroyed()
 {
 	Super::Destroyed();
 	DestroyInventory();
+	UnregisterFromUpdates();
 }
 
 void AShooterCharacter::PawnClientRestart()
@@ -92,6 +103,9 @@ void AShooterCharacter::PawnClientRestart()
 	// reattach weapon if needed
 	SetCurrentWeapon(CurrentWeapon);
 
+	// owner's cheats apply to weapons from now on
+	ResolveWeaponModifiers();
+
 	// set team colors for 1st person view
 	UMaterialInstanceDynamic* Mesh1PMID = Mesh1P->CreateAndSetMaterialInstanceDynamic(0);
 	UpdateTeamColors(Mesh1PMID);
@@ -103,6 +117,9 @@ void AShooterCharacter::PossessedBy(class AController* InController)
 
 	// [server] as soon as PlayerState is assigned, set team colors of this pawn for local player
 	UpdateTeamColorsAllMIDs();
+
+	// [server] owner's cheats and controller apply to weapons from now on
+	ResolveWeaponModifiers();
 }
 
 void AShooterCharacter::OnRep_PlayerState()
@@ -222,29 +239,69 @@ float AShooterCharacter::TakeDamage(float Damage, struct FDamageEvent const& Dam
 		return 0.f;
 	}
 
-	// Modify based on game rules.
+	// damage is collected for the whole frame and resolved by the game mode
 	AShooterGameMode* const Game = GetWorld()->GetAuthGameMode<AShooterGameMode>();
-	Damage = Game ? Game->ModifyDamage(Damage, this, DamageEvent, EventInstigator, DamageCauser) : 0.f;
+	if (Game == NULL || Damage <= 0.f)
+	{
+		return 0.f;
+	}
+
+	Game->QueueDamage(this, Damage, DamageEvent, EventInstigator, DamageCauser);
+
+	// victim always learns who hit it, bots close by may hear the fight
+	Game->GetPerceptionBus().Post(EShooterStimulus::Damage, GetActorLocation(), EventInstigator ? EventInstigator->GetPawn() : NULL, Controller);
+	return Damage;
+}
 
-	const float ActualDamage = Super::TakeDamage(Damage, DamageEvent, EventInstigator, DamageCauser);
-	if (ActualDamage > 0.f)
+void AShooterCharacter::ApplyPendingDamage(TArray<FShooterPendingDamage>& PendingDamage)
+{
+	if (Health <= 0.f || bIsDying)
 	{
-		Health -= ActualDamage;
-		if (Health <= 0)
-		{
-			Die(ActualDamage, DamageEvent, EventInstigator, DamageCauser);
-		}
-		else
+		return;
+	}
+
+	float TotalDamage = 0.f;
+	float BestDamage = 0.f;
+	int32 BestIndex = INDEX_NONE;
+	for (int32 i = 0; i < PendingDamage.Num(); i++)
+	{
+		FShooterPendingDamage& Entry = PendingDamage[i];
+		const float ActualDamage = Super::TakeDamage(Entry.Damage, Entry.HitInfo.GetDamageEvent(), Entry.EventInstigator.Get(), Entry.DamageCauser.Get());
+		if (ActualDamage > 0.f)
 		{
-			PlayHit(ActualDamage, DamageEvent, EventInstigator ? EventInstigator->GetPawn() : NULL, DamageCauser);
+			TotalDamage += ActualDamage;
+
+			// biggest contributor this frame gets the hit (and the kill)
+			if (ActualDamage > BestDamage)
+			{
+				BestDamage = ActualDamage;
+				BestIndex = i;
+			}
 		}
+	}
 
-		MakeNoise(1.0f, EventInstigator ? EventInstigator->GetPawn() : this);
+	if (BestIndex == INDEX_NONE)
+	{
+		return;
 	}
 
-	return ActualDamage;
-}
+	FShooterPendingDamage& Best = PendingDamage[BestIndex];
+	FDamageEvent const& DamageEvent = Best.HitInfo.GetDamageEvent();
+	AController* const EventInstigator = Best.EventInstigator.Get();
+
+	Health -= TotalDamage;
+	if (Health <= 0)
+	{
+		Die(TotalDamage, DamageEvent, EventInstigator, Best.DamageCauser.Get());
+	}
+	else
+	{
+		PlayHit(TotalDamage, DamageEvent, EventInstigator ? EventInstigator->GetPawn() : NULL, Best.DamageCauser.Get());
+		RequestPeriodicUpdates();
+	}
 
+	MakeNoise(1.0f, EventInstigator ? EventInstigator->GetPawn() : this);
+}
 
 bool AShooterCharacter::CanDie(float KillingDamage, FDamageEvent const& DamageEvent, AController* Killer, AActor* DamageCauser) const
 {
@@ -300,9 +357,11 @@ void AShooterCharacter::OnDeath(float KillingDamage, struct FDamageEvent const&
 	{
 		ReplicateHit(KillingDamage, DamageEvent, PawnInstigator, DamageCauser, true);	
 
-		// play the force feedback effect on the client player controller
+		// play the force feedback effect on the client player controller, unless server is shedding cosmetic RPCs
 		APlayerController* PC = Cast<APlayerController>(Controller);
-		if (PC && DamageEvent.DamageTypeClass)
+		AShooterGameMode* GameMode = Cast<AShooterGameMode>(GetWorld()->GetAuthGameMode());
+		const bool bShedCosmetics = GameMode && GameMode->GetServerBudget().ShouldShed(EShooterShedWork::CosmeticMulticast);
+		if (PC && DamageEvent.DamageTypeClass && !bShedCosmetics)
 		{
 			UShooterDamageType *DamageType = Cast<UShooterDamageType>(DamageEvent.DamageTypeClass->GetDefaultObject());
 			if (DamageType && DamageType->KilledForceFeedback)
@@ -368,9 +427,11 @@ void AShooterCharacter::PlayHit(float DamageTaken, struct FDamageEvent const& Da
 	{
 		ReplicateHit(DamageTaken, DamageEvent, PawnInstigator, DamageCauser, false);
 
-		// play the force feedback effect on the client player controller
+		// play the force feedback effect on the client player controller, unless server is shedding cosmetic RPCs
 		APlayerController* PC = Cast<APlayerController>(Controller);
-		if (PC && DamageEvent.DamageTypeClass)
+		AShooterGameMode* GameMode = Cast<AShooterGameMode>(GetWorld()->GetAuthGameMode());
+		const bool bShedCosmetics = GameMode && GameMode->GetServerBudget().ShouldShed(EShooterShedWork::CosmeticMulticast);
+		if (PC && DamageEvent.DamageTypeClass && !bShedCosmetics)
 		{
 			UShooterDamageType *DamageType = Cast<UShooterDamageType>(DamageEvent.DamageTypeClass->GetDefaultObject());
 			if (DamageType && DamageType->HitForceFeedback)
@@ -486,6 +547,11 @@ void AShooterCharacter::OnRep_LastTakeHitInfo()
 	}
 }
 
+void AShooterCharacter::OnRep_Health()
+{
+	RequestPeriodicUpdates();
+}
+
 //Pawn::PlayDying sets this lifespan, but when that function is called on client, dead pawn's role is still SimulatedProxy despite bTearOff being true. 
 void AShooterCharacter::TornOff()
 {
@@ -572,6 +638,17 @@ AShooterWeapon* AShooterCharacter::FindWeapon(TSubclassOf<AShooterWeapon> Weapon
 	return NULL;
 }
 
+void AShooterCharacter::ResolveWeaponModifiers()
+{
+	for (int32 i = 0; i < Inventory.Num(); i++)
+	{
+		if (Inventory[i])
+		{
+			Inventory[i]->ResolveModifiers();
+		}
+	}
+}
+
 void AShooterCharacter::EquipWeapon(AShooterWeapon* Weapon)
 {
 	if (Weapon)
@@ -677,21 +754,6 @@ void AShooterCharacter::SetTargeting(bool bNewTargeting)
 	{
 		UGameplayStatics::PlaySoundAttached(TargetingSound, GetRootComponent());
 	}
-
-	if (Role < ROLE_Authority)
-	{
-		ServerSetTargeting(bNewTargeting);
-	}
-}
-
-bool AShooterCharacter::ServerSetTargeting_Validate(bool bNewTargeting)
-{
-	return true;
-}
-
-void AShooterCharacter::ServerSetTargeting_Implementation(bool bNewTargeting)
-{
-	SetTargeting(bNewTargeting);
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -702,22 +764,8 @@ void AShooterCharacter::SetRunning(bool bNewRunning, bool bToggle)
 	bWantsToRun = bNewRunning;
 	bWantsToRunToggled = bNewRunning && bToggle;
 
-	if (Role < ROLE_Authority)
-	{
-		ServerSetRunning(bNewRunning, bToggle);
-	}
-
 	UpdateRunSounds(bNewRunning);
-}
-
-bool AShooterCharacter::ServerSetRunning_Validate(bool bNewRunning, bool bToggle)
-{
-	return true;
-}
-
-void AShooterCharacter::ServerSetRunning_Implementation(bool bNewRunning, bool bToggle)
-{
-	SetRunning(bNewRunning, bToggle);
+	RequestPeriodicUpdates();
 }
 
 void AShooterCharacter::UpdateRunSounds(bool bNewRunning)
@@ -979,55 +1027,150 @@ void AShooterCharacter::OnStopRunning()
 
 bool AShooterCharacter::IsRunning() const
 {	
+	return WantsToRun() && IsMovingForRun();
+}
+
+bool AShooterCharacter::WantsToRun() const
+{
+	return bWantsToRun || bWantsToRunToggled;
+}
+
+bool AShooterCharacter::IsMovingForRun() const
+{
 	if (!CharacterMovement)
 	{
 		return false;
 	}
-	
-	return (bWantsToRun || bWantsToRunToggled) && !GetVelocity().IsZero() && (GetVelocity().SafeNormal2D() | GetActorRotation().Vector()) > -0.1;
+
+	return !GetVelocity().IsZero() && (GetVelocity().SafeNormal2D() | GetActorRotation().Vector()) > -0.1;
 }
 
 void AShooterCharacter::Tick(float DeltaSeconds)
 {
 	Super::Tick(DeltaSeconds);
 
-	FCollisionQueryParams Params = FCollisionQueryParams(FName(TEXT("Params")), true, this);
+	// game state may replicate after us on clients, keep ticking until periodic updates can be handed over
+	if (!bRegisteredForUpdates)
+	{
+		RegisterForUpdates();
+	}
+}
+
+void AShooterCharacter::RegisterForUpdates()
+{
+	AShooterGameState* const MyGameState = Cast<AShooterGameState>(GetWorld()->GameState);
+	if (MyGameState == NULL || bRegisteredForUpdates)
+	{
+		return;
+	}
+
+	bRegisteredForUpdates = true;
+	RequestPeriodicUpdates();
+
+	// running state, regen and low health are updated in batches, only blueprint tick logic needs actor tick
+	UFunction* TickFunction = GetClass()->FindFunctionByName(FName(TEXT("ReceiveTick")));
+	const bool bHasBlueprintTick = TickFunction && TickFunction->GetOuter()->IsA(UBlueprintGeneratedClass::StaticClass());
+	if (!bHasBlueprintTick)
+	{
+		SetActorTickEnabled(false);
+	}
+}
+
+void AShooterCharacter::UnregisterFromUpdates()
+{
+	AShooterGameState* const MyGameState = Cast<AShooterGameState>(GetWorld()->GameState);
+	if (MyGameState && bRegisteredForUpdates)
+	{
+		MyGameState->GetCharacterUpdateManager().Remove(this);
+	}
+
+	bRegisteredForUpdates = false;
+}
+
+void AShooterCharacter::RequestPeriodicUpdates()
+{
+	AShooterGameState* const MyGameState = Cast<AShooterGameState>(GetWorld()->GameState);
+	if (MyGameState && bRegisteredForUpdates && NeedsPeriodicUpdates())
+	{
+		MyGameState->GetCharacterUpdateManager().Activate(this);
+	}
+}
+
+bool AShooterCharacter::NeedsPeriodicUpdates() const
+{
+	if (bWantsToRunToggled)
+	{
+		return true;
+	}
+
+	// regen until healed
+	AShooterPlayerController* MyPC = Cast<AShooterPlayerController>(Controller);
+	if (Role == ROLE_Authority && MyPC && MyPC->HasHealthRegen() && Health > 0.f && Health < GetMaxHealth())
+	{
+		return true;
+	}
+
+	// low health warning until it's stopped
+	const bool bWarningPlaying = LowHealthWarningPlayer && LowHealthWarningPlayer->IsPlaying();
+	const bool bWarningWanted = LowHealthSound && GetNetMode() != NM_DedicatedServer && Health > 0.f && Health < GetMaxHealth() * LowHealthPercentage;
+	return bWarningPlaying || bWarningWanted;
+}
 
+void AShooterCharacter::UpdateRunningState()
+{
 	if (bWantsToRunToggled && !IsRunning())
 	{
 		SetRunning(false, false);
 	}
+}
+
+void AShooterCharacter::UpdateHealthRegen(float DeltaSeconds)
+{
+	if (Role < ROLE_Authority || Health <= 0.f || Health >= GetMaxHealth())
+	{
+		return;
+	}
+
 	AShooterPlayerController* MyPC = Cast<AShooterPlayerController>(Controller);
 	if (MyPC && MyPC->HasHealthRegen())
 	{
-		if (this->Health < this->GetMaxHealth())
+		Health = FMath::Min<float>(Health + 5 * DeltaSeconds, GetMaxHealth());
+	}
+}
+
+void AShooterCharacter::UpdateLowHealthWarning()
+{
+	if (LowHealthSound == NULL || !GEngine->UseSound())
+	{
+		return;
+	}
+
+	const float LowHealth = GetMaxHealth() * LowHealthPercentage;
+	const bool bWarningPlaying = LowHealthWarningPlayer && LowHealthWarningPlayer->IsPlaying();
+
+	if (Health > 0 && Health < LowHealth && !bWarningPlaying)
+	{
+		AShooterGameState* const MyGameState = Cast<AShooterGameState>(GetWorld()->GameState);
+		if (MyGameState)
 		{
-			this->Health +=  5 * DeltaSeconds;
-			if (Health > this->GetMaxHealth())
+			LowHealthWarningPlayer = MyGameState->GetAudioVoiceManager().PlaySoundAttached(EShooterSoundCategory::LowHealth, LowHealthSound, GetRootComponent(),
+				IsLocallyControlled() && IsPlayerControlled(), true);
+			if (LowHealthWarningPlayer)
 			{
-				Health = this->GetMaxHealth();
+				LowHealthWarningPlayer->SetVolumeMultiplier(0.0f);
 			}
 		}
 	}
-	
-	if (LowHealthSound && GEngine->UseSound())
+	else if ((Health > LowHealth || Health < 0) && bWarningPlaying)
 	{
-		if ((this->Health > 0 && this->Health < this->GetMaxHealth() * LowHealthPercentage) && (!LowHealthWarningPlayer || !LowHealthWarningPlayer->IsPlaying()))
-		{
-			LowHealthWarningPlayer = UGameplayStatics::PlaySoundAttached(LowHealthSound, GetRootComponent(),
-				NAME_None, FVector(ForceInit), EAttachLocation::KeepRelativeOffset, true);
-			LowHealthWarningPlayer->SetVolumeMultiplier(0.0f);
-		} 
-		else if ((this->Health > this->GetMaxHealth() * LowHealthPercentage || this->Health < 0) && LowHealthWarningPlayer && LowHealthWarningPlayer->IsPlaying())
-		{
-			LowHealthWarningPlayer->Stop();
-		}
-		if (LowHealthWarningPlayer && LowHealthWarningPlayer->IsPlaying())
-		{
-			const float MinVolume = 0.3f;
-			const float VolumeMultiplier = (1.0f - (this->Health / (this->GetMaxHealth() * LowHealthPercentage)));
-			LowHealthWarningPlayer->SetVolumeMultiplier(MinVolume + (1.0f - MinVolume) * VolumeMultiplier);
-		}
+		LowHealthWarningPlayer->Stop();
+	}
+
+	if (LowHealthWarningPlayer && LowHealthWarningPlayer->IsPlaying())
+	{
+		const float MinVolume = 0.3f;
+		const float VolumeMultiplier = (1.0f - (Health / LowHealth));
+		LowHealthWarningPlayer->SetVolumeMultiplier(MinVolume + (1.0f - MinVolume) * VolumeMultiplier);
 	}
 }
 
@@ -1054,6 +1197,20 @@ void AShooterCharacter::PreReplication( IRepChangedPropertyTracker & ChangedProp
 
 	// Only replicate this property for a short duration after it changes so join in progress players don't get spammed with fx when joining late
 	DOREPLIFETIME_ACTIVE_OVERRIDE( AShooterCharacter, LastTakeHitInfo, GetWorld() && GetWorld()->GetTimeSeconds() < LastTakeHitTimeTimeout );
+
+	FShooterNetAccounting::Get().AccountReplicatedProperties(this);
+}
+
+bool AShooterCharacter::CallRemoteFunction(UFunction* Function, void* Parameters, FOutParmRec* OutParms, FFrame* Stack)
+{
+	FShooterNetAccounting::FScopedSend ScopedSend(this, Function);
+	return Super::CallRemoteFunction(Function, Parameters, OutParms, Stack);
+}
+
+void AShooterCharacter::ProcessEvent(UFunction* Function, void* Parameters)
+{
+	FShooterNetAccounting::Get().AccountReceivedCall(this, Function, Parameters);
+	Super::ProcessEvent(Function, Parameters);
 }
 
 void AShooterCharacter::GetLifetimeReplicatedProps( TArray< FLifetimeProperty > & OutLifetimeProps ) const
@@ -1131,7 +1288,7 @@ bool AShooterCharacter::IsFirstPerson() const
 
 int32 AShooterCharacter::GetMaxHealth() const
 {
-	return GetClass()->GetDefaultObject<AShooterCharacter>()->Health;
+	return MaxHealth;
 }
 
 bool AShooterCharacter::IsAlive() const
@@ -2,6 +2,9 @@
 
 #include "ShooterGame.h"
 
+/** compressed move flags of running and targeting */
+#define FLAG_WantsToRun		FSavedMove_Character::FLAG_Custom_0
+#define FLAG_IsTargeting	FSavedMove_Character::FLAG_Custom_1
 
 //----------------------------------------------------------------------//
 // UPawnMovementComponent
@@ -9,6 +12,9 @@
 UShooterCharacterMovement::UShooterCharacterMovement(const class FPostConstructInitializeProperties& PCIP)
 	: Super(PCIP)
 {
+	bReplayingMove = false;
+	bReplayedWantsToRun = false;
+	bReplayedIsTargeting = false;
 }
 
 
@@ -19,11 +25,14 @@ float UShooterCharacterMovement::GetMaxSpeedModifier() const
 	const AShooterCharacter* ShooterCharacterOwner = Cast<AShooterCharacter>(PawnOwner);
 	if (ShooterCharacterOwner)
 	{
-		if (ShooterCharacterOwner->IsTargeting())
+		const bool bTargeting = bReplayingMove ? bReplayedIsTargeting : ShooterCharacterOwner->IsTargeting();
+		const bool bRunning = bReplayingMove ? (bReplayedWantsToRun && ShooterCharacterOwner->IsMovingForRun()) : ShooterCharacterOwner->IsRunning();
+
+		if (bTargeting)
 		{
 			SpeedMod *= ShooterCharacterOwner->GetTargetingSpeedModifier();
 		}
-		if (ShooterCharacterOwner->IsRunning())
+		if (bRunning)
 		{
 			SpeedMod *= ShooterCharacterOwner->GetRunningSpeedModifier();
 		}
@@ -31,3 +40,128 @@ float UShooterCharacterMovement::GetMaxSpeedModifier() const
 
 	return SpeedMod;
 }
+
+FNetworkPredictionData_Client* UShooterCharacterMovement::GetPredictionData_Client() const
+{
+	check(PawnOwner != NULL);
+	check(PawnOwner->Role < ROLE_Authority);
+
+	if (!ClientPredictionData)
+	{
+		UShooterCharacterMovement* MutableThis = const_cast<UShooterCharacterMovement*>(this);
+		MutableThis->ClientPredictionData = new FNetworkPredictionData_Client_Shooter();
+	}
+
+	return ClientPredictionData;
+}
+
+void UShooterCharacterMovement::SetReplayedMoveState(bool bWantsToRun, bool bIsTargeting)
+{
+	bReplayingMove = true;
+	bReplayedWantsToRun = bWantsToRun;
+	bReplayedIsTargeting = bIsTargeting;
+}
+
+void UShooterCharacterMovement::ClearReplayedMoveState()
+{
+	bReplayingMove = false;
+}
+
+void UShooterCharacterMovement::UpdateFromCompressedFlags(uint8 Flags)
+{
+	Super::UpdateFromCompressedFlags(Flags);
+
+	// only react to changes, setters play sounds
+	AShooterCharacter* ShooterCharacterOwner = Cast<AShooterCharacter>(CharacterOwner);
+	if (ShooterCharacterOwner)
+	{
+		const bool bWantsToRun = (Flags & FLAG_WantsToRun) != 0;
+		if (ShooterCharacterOwner->WantsToRun() != bWantsToRun)
+		{
+			ShooterCharacterOwner->SetRunning(bWantsToRun, false);
+		}
+
+		const bool bIsTargeting = (Flags & FLAG_IsTargeting) != 0;
+		if (ShooterCharacterOwner->IsTargeting() != bIsTargeting)
+		{
+			ShooterCharacterOwner->SetTargeting(bIsTargeting);
+		}
+	}
+}
+
+//----------------------------------------------------------------------//
+// FSavedMove_Shooter
+//----------------------------------------------------------------------//
+void FSavedMove_Shooter::Clear()
+{
+	Super::Clear();
+
+	bSavedWantsToRun = false;
+	bSavedIsTargeting = false;
+}
+
+void FSavedMove_Shooter::SetMoveFor(ACharacter* Character, float InDeltaTime, FVector const& NewAccel, class FNetworkPredictionData_Client_Character& ClientData)
+{
+	Super::SetMoveFor(Character, InDeltaTime, NewAccel, ClientData);
+
+	// new move is performed right after this, with current state
+	UShooterCharacterMovement* MoveComp = Cast<UShooterCharacterMovement>(Character->CharacterMovement);
+	if (MoveComp)
+	{
+		MoveComp->ClearReplayedMoveState();
+	}
+
+	const AShooterCharacter* ShooterCharacter = Cast<AShooterCharacter>(Character);
+	if (ShooterCharacter)
+	{
+		bSavedWantsToRun = ShooterCharacter->WantsToRun();
+		bSavedIsTargeting = ShooterCharacter->IsTargeting();
+	}
+}
+
+void FSavedMove_Shooter::PrepMoveFor(ACharacter* Character)
+{
+	Super::PrepMoveFor(Character);
+
+	// replay with state move was made with, leave current state of character alone
+	UShooterCharacterMovement* MoveComp = Cast<UShooterCharacterMovement>(Character->CharacterMovement);
+	if (MoveComp)
+	{
+		MoveComp->SetReplayedMoveState(bSavedWantsToRun, bSavedIsTargeting);
+	}
+}
+
+uint8 FSavedMove_Shooter::GetCompressedFlags() const
+{
+	uint8 Result = Super::GetCompressedFlags();
+
+	if (bSavedWantsToRun)
+	{
+		Result |= FLAG_WantsToRun;
+	}
+	if (bSavedIsTargeting)
+	{
+		Result |= FLAG_IsTargeting;
+	}
+
+	return Result;
+}
+
+bool FSavedMove_Shooter::CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* Character, float MaxDelta) const
+{
+	const FSavedMove_Shooter* NewShooterMove = (const FSavedMove_Shooter*)NewMove.Get();
+	if (bSavedWantsToRun != NewShooterMove->bSavedWantsToRun || bSavedIsTargeting != NewShooterMove->bSavedIsTargeting)
+	{
+		return false;
+	}
+
+	return Super::CanCombineWith(NewMove, Character, MaxDelta);
+}
+
+//----------------------------------------------------------------------//
+// FNetworkPredictionData_Client_Shooter
+//----------------------------------------------------------------------//
+FSavedMovePtr FNetworkPredictionData_Client_Shooter::AllocateNewMove()
+{
+	return FSavedMovePtr(new FSavedMove_Shooter());
+}
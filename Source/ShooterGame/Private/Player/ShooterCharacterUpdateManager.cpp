@@ -0,0 +1,108 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "ShooterCharacterUpdateManager.h"
+#include "ShooterConfigSection.h"
+#include "ShooterDevHelper.h"
+
+#if !UE_BUILD_SHIPPING
+static void DumpCharacterUpdates()
+{
+	UWorld* World = ShooterDevHelper::GetWorld();
+	AShooterGameState* MyGameState = World ? Cast<AShooterGameState>(World->GameState) : NULL;
+	if (MyGameState)
+	{
+		MyGameState->GetCharacterUpdateManager().Dump();
+	}
+}
+
+static FAutoConsoleCommand CmdDumpCharacterUpdates(
+	TEXT("Shooter.DumpCharacterUpdates"),
+	TEXT("Logs characters the character update manager visits, damaged pawns join it and leave once healed"),
+	FConsoleCommandDelegate::CreateStatic(DumpCharacterUpdates)
+	);
+#endif
+
+FShooterCharacterUpdateManager::FShooterCharacterUpdateManager()
+	: HealthRegenInterval(0.25f)
+	, LowHealthInterval(0.1f)
+	, TimeSinceHealthRegen(0.0f)
+	, TimeSinceLowHealth(0.0f)
+{
+	const FShooterConfigSection Config(TEXT("ShooterGame.CharacterUpdates"));
+	Config.Get(TEXT("HealthRegenInterval"), HealthRegenInterval);
+	Config.Get(TEXT("LowHealthInterval"), LowHealthInterval);
+}
+
+void FShooterCharacterUpdateManager::Activate(AShooterCharacter* Character)
+{
+	if (Character)
+	{
+		ActiveCharacters.AddUnique(Character);
+	}
+}
+
+void FShooterCharacterUpdateManager::Remove(AShooterCharacter* Character)
+{
+	ActiveCharacters.Remove(Character);
+}
+
+void FShooterCharacterUpdateManager::Tick(UWorld* World, float DeltaSeconds)
+{
+	TimeSinceHealthRegen += DeltaSeconds;
+	TimeSinceLowHealth += DeltaSeconds;
+
+	const bool bUpdateHealthRegen = TimeSinceHealthRegen >= HealthRegenInterval;
+	const bool bUpdateLowHealth = TimeSinceLowHealth >= LowHealthInterval && World->GetNetMode() != NM_DedicatedServer;
+
+	for (int32 i = ActiveCharacters.Num() - 1; i >= 0; i--)
+	{
+		AShooterCharacter* Character = ActiveCharacters[i].Get();
+		if (Character == NULL || Character->IsPendingKill())
+		{
+			ActiveCharacters.RemoveAtSwap(i);
+			continue;
+		}
+
+		Character->UpdateRunningState();
+
+		if (bUpdateHealthRegen)
+		{
+			Character->UpdateHealthRegen(TimeSinceHealthRegen);
+		}
+
+		if (bUpdateLowHealth)
+		{
+			Character->UpdateLowHealthWarning();
+		}
+
+		if (!Character->NeedsPeriodicUpdates())
+		{
+			ActiveCharacters.RemoveAtSwap(i);
+		}
+	}
+
+	if (bUpdateHealthRegen)
+	{
+		TimeSinceHealthRegen = 0.0f;
+	}
+
+	if (bUpdateLowHealth)
+	{
+		TimeSinceLowHealth = 0.0f;
+	}
+}
+
+void FShooterCharacterUpdateManager::Dump() const
+{
+	UE_LOG(LogShooter, Log, TEXT("Character updates: %d active, regen every %.2fs, low health every %.2fs"), ActiveCharacters.Num(), HealthRegenInterval, LowHealthInterval);
+	for (int32 i = 0; i < ActiveCharacters.Num(); i++)
+	{
+		const AShooterCharacter* Character = ActiveCharacters[i].Get();
+		if (Character)
+		{
+			UE_LOG(LogShooter, Log, TEXT("  %s: health %.0f/%d%s"), *Character->GetName(), Character->Health, Character->GetMaxHealth(),
+				Character->IsRunning() ? TEXT(", running") : TEXT(""));
+		}
+	}
+}
@@ -0,0 +1,47 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+/**
+ * Runs periodic character behaviours (run toggle, health regen, low health warning) in a single pass,
+ * one per world (owned by the game state). Only characters with work pending are visited: a character
+ * activates itself when something starts work (toggled run, damage taken) and is dropped once it reports
+ * it's idle. Regen and low health updates run at configurable intervals, read from
+ * [ShooterGame.CharacterUpdates] in Game ini. Registered characters without blueprint tick logic disable
+ * their own actor tick.
+ */
+class FShooterCharacterUpdateManager
+{
+public:
+
+	FShooterCharacterUpdateManager();
+
+	/** updates character until it has no periodic work left */
+	void Activate(class AShooterCharacter* Character);
+
+	/** stops updates for character */
+	void Remove(class AShooterCharacter* Character);
+
+	/** updates active characters and drops idle ones */
+	void Tick(UWorld* World, float DeltaSeconds);
+
+	/** logs active characters */
+	void Dump() const;
+
+private:
+
+	/** characters with periodic work pending */
+	TArray<TWeakObjectPtr<class AShooterCharacter> > ActiveCharacters;
+
+	/** seconds between health regen updates */
+	float HealthRegenInterval;
+
+	/** seconds between low health warning updates */
+	float LowHealthInterval;
+
+	/** time since last health regen update */
+	float TimeSinceHealthRegen;
+
+	/** time since last low health warning update */
+	float TimeSinceLowHealth;
+};
@@ -0,0 +1,160 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "ShooterKillCamPlayback.h"
+
+/** how long a shot tracer stays visible */
+static const float KillCamShotDisplayTime = 0.15f;
+
+/** camera distance behind killer */
+static const float KillCamCameraDistance = 250.0f;
+
+/** camera height above recorded pawn location */
+static const float KillCamCameraHeight = 90.0f;
+
+FShooterKillCamPlayback::FShooterKillCamPlayback(const FShooterKillCamClip& InClip)
+	: Clip(InClip)
+	, PlaybackTime(0.0f)
+{
+	const int32 NumFrames = Clip.NumFrames;
+	SampleLookup.Init(INDEX_NONE, Clip.Actors.Num() * NumFrames);
+	for (int32 i = 0; i < Clip.Samples.Num(); i++)
+	{
+		const FShooterKillCamSample& Sample = Clip.Samples[i];
+		if (Sample.ActorIndex < Clip.Actors.Num() && Sample.FrameIndex < NumFrames)
+		{
+			SampleLookup[Sample.ActorIndex * NumFrames + Sample.FrameIndex] = i;
+		}
+	}
+
+	KillerIndex = FindActor(true);
+	VictimIndex = FindActor(false);
+
+	PawnViews.AddZeroed(Clip.Actors.Num());
+	UpdatePawnViews();
+}
+
+int32 FShooterKillCamPlayback::FindActor(bool bKiller) const
+{
+	for (int32 i = 0; i < Clip.Actors.Num(); i++)
+	{
+		if (bKiller ? Clip.Actors[i].bKiller : Clip.Actors[i].bVictim)
+		{
+			return i;
+		}
+	}
+
+	return INDEX_NONE;
+}
+
+int32 FShooterKillCamPlayback::FindSample(int32 ActorIndex, int32 FrameIndex) const
+{
+	if (FrameIndex < 0 || FrameIndex >= Clip.NumFrames)
+	{
+		return INDEX_NONE;
+	}
+
+	return SampleLookup[ActorIndex * Clip.NumFrames + FrameIndex];
+}
+
+bool FShooterKillCamPlayback::Tick(float DeltaSeconds)
+{
+	PlaybackTime += DeltaSeconds;
+	if (GetProgress() >= 1.0f)
+	{
+		return false;
+	}
+
+	UpdatePawnViews();
+	return true;
+}
+
+float FShooterKillCamPlayback::GetProgress() const
+{
+	const float Length = (Clip.NumFrames - 1) * Clip.FrameInterval;
+	return Length > 0.0f ? FMath::Clamp(PlaybackTime / Length, 0.0f, 1.0f) : 1.0f;
+}
+
+void FShooterKillCamPlayback::UpdatePawnViews()
+{
+	const float FramePos = Clip.FrameInterval > 0.0f ? PlaybackTime / Clip.FrameInterval : 0.0f;
+	const int32 Frame = FMath::FloorToInt(FramePos);
+	const float Alpha = FramePos - Frame;
+
+	for (int32 i = 0; i < PawnViews.Num(); i++)
+	{
+		FPawnView& View = PawnViews[i];
+		const int32 FromIdx = FindSample(i, Frame);
+		const int32 ToIdx = FindSample(i, Frame + 1);
+
+		View.bVisible = (FromIdx != INDEX_NONE || ToIdx != INDEX_NONE);
+		if (!View.bVisible)
+		{
+			continue;
+		}
+
+		const FShooterKillCamSample& From = Clip.Samples[FromIdx != INDEX_NONE ? FromIdx : ToIdx];
+		const FShooterKillCamSample& To = Clip.Samples[ToIdx != INDEX_NONE ? ToIdx : FromIdx];
+		const FRotator FromRotation(FRotator::DecompressAxisFromByte(From.Pitch), FRotator::DecompressAxisFromByte(From.Yaw), 0.0f);
+		const FRotator ToRotation(FRotator::DecompressAxisFromByte(To.Pitch), FRotator::DecompressAxisFromByte(To.Yaw), 0.0f);
+
+		View.Location = Clip.Origin + FMath::Lerp<FVector>(From.Location, To.Location, Alpha);
+		View.Rotation = FromRotation + (ToRotation - FromRotation).GetNormalized() * Alpha;
+	}
+}
+
+void FShooterKillCamPlayback::GetCameraView(UWorld* World, FVector& OutLocation, FRotator& OutRotation) const
+{
+	const FVector Height(0.0f, 0.0f, KillCamCameraHeight);
+	const FVector VictimLocation = (VictimIndex != INDEX_NONE && PawnViews[VictimIndex].bVisible) ? PawnViews[VictimIndex].Location : (FVector)Clip.Origin;
+	FVector Anchor;
+
+	if (KillerIndex != INDEX_NONE && PawnViews[KillerIndex].bVisible)
+	{
+		// over killer's shoulder, looking at victim
+		const FVector KillerLocation = PawnViews[KillerIndex].Location;
+		FVector ViewDir = (VictimLocation - KillerLocation).SafeNormal();
+		if (ViewDir.IsZero())
+		{
+			ViewDir = PawnViews[KillerIndex].Rotation.Vector();
+		}
+
+		Anchor = KillerLocation + Height;
+		OutLocation = Anchor - ViewDir * KillCamCameraDistance;
+		OutRotation = (VictimLocation - OutLocation).Rotation();
+	}
+	else
+	{
+		// no killer to follow, slowly orbit victim
+		const FRotator OrbitDir(-30.0f, GetProgress() * 90.0f, 0.0f);
+		Anchor = VictimLocation + Height;
+		OutLocation = Anchor - OrbitDir.Vector() * KillCamCameraDistance * 2.0f;
+		OutRotation = OrbitDir;
+	}
+
+	FHitResult Hit;
+	if (World && World->LineTraceSingle(Hit, Anchor, OutLocation, ECC_Camera, FCollisionQueryParams(TEXT("KillCam"), false)))
+	{
+		OutLocation = Hit.Location;
+	}
+}
+
+void FShooterKillCamPlayback::GetShotViews(TArray<FShotView>& OutShots) const
+{
+	for (int32 i = 0; i < Clip.Shots.Num(); i++)
+	{
+		const FShooterKillCamShot& Shot = Clip.Shots[i];
+		const float Age = PlaybackTime - Shot.FrameIndex * Clip.FrameInterval;
+		if (Age < 0.0f || Age > KillCamShotDisplayTime || Shot.ActorIndex >= PawnViews.Num() || !PawnViews[Shot.ActorIndex].bVisible)
+		{
+			continue;
+		}
+
+		FShotView View;
+		View.ActorIndex = Shot.ActorIndex;
+		View.Start = PawnViews[Shot.ActorIndex].Location + FVector(0.0f, 0.0f, KillCamCameraHeight * 0.5f);
+		View.End = Clip.Origin + Shot.End;
+		View.Alpha = 1.0f - Age / KillCamShotDisplayTime;
+		OutShots.Add(View);
+	}
+}
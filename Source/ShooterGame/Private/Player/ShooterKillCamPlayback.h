@@ -0,0 +1,85 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+/**
+ * Plays back kill-cam clip received from the server: interpolates recorded pawn transforms,
+ * places the camera behind the killer looking at the victim and tells the HUD what to draw.
+ */
+class FShooterKillCamPlayback
+{
+public:
+
+	/** interpolated state of clip pawn */
+	struct FPawnView
+	{
+		/** pawn has a sample near current time */
+		bool bVisible;
+		FVector Location;
+		FRotator Rotation;
+	};
+
+	/** shot visible at current time */
+	struct FShotView
+	{
+		int32 ActorIndex;
+		FVector Start;
+		FVector End;
+		float Alpha;
+	};
+
+	FShooterKillCamPlayback(const FShooterKillCamClip& InClip);
+
+	/** advances playback, returns false once clip ended */
+	bool Tick(float DeltaSeconds);
+
+	/** returns camera for current time, pulled in front of world geometry */
+	void GetCameraView(UWorld* World, FVector& OutLocation, FRotator& OutRotation) const;
+
+	/** returns played clip */
+	const FShooterKillCamClip& GetClip() const
+	{
+		return Clip;
+	}
+
+	/** returns state of each clip actor at current time */
+	const TArray<FPawnView>& GetPawnViews() const
+	{
+		return PawnViews;
+	}
+
+	/** gathers shots fired shortly before current time */
+	void GetShotViews(TArray<FShotView>& OutShots) const;
+
+	/** returns fraction of clip played */
+	float GetProgress() const;
+
+private:
+
+	/** returns index in Clip.Samples of actor's sample in frame, INDEX_NONE if pawn wasn't recorded in it */
+	int32 FindSample(int32 ActorIndex, int32 FrameIndex) const;
+
+	/** updates PawnViews for current time */
+	void UpdatePawnViews();
+
+	/** returns index of first actor with given flag set, INDEX_NONE if there is none */
+	int32 FindActor(bool bKiller) const;
+
+	/** played clip */
+	FShooterKillCamClip Clip;
+
+	/** sample index per actor and frame, actor major */
+	TArray<int32> SampleLookup;
+
+	/** state of each clip actor at current time */
+	TArray<FPawnView> PawnViews;
+
+	/** time since playback start */
+	float PlaybackTime;
+
+	/** index of killer in clip actors */
+	int32 KillerIndex;
+
+	/** index of victim in clip actors */
+	int32 VictimIndex;
+};
@@ -223,3 +223,14 @@ void UShooterPersistentUser::SetBotsCount(int32 InCount)
 
 	BotsCount = InCount;
 }
+
+void UShooterPersistentUser::SetPendingAchievements(const TArray<FShooterPendingAchievement>& InPendingAchievements)
+{
+	if (PendingAchievements.Num() == 0 && InPendingAchievements.Num() == 0)
+	{
+		return;
+	}
+
+	PendingAchievements = InPendingAchievements;
+	bIsDirty = true;
+}
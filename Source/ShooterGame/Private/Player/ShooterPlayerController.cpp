@@ -4,6 +4,9 @@
 #include "UI/Menu/ShooterIngameMenu.h"
 #include "UI/Style/ShooterStyle.h"
 #include "OnlineAchievementsInterface.h"
+#include "Online/ShooterNetAccounting.h"
+#include "Online/ShooterAchievementQueue.h"
+#include "ShooterKillCamPlayback.h"
 
 #define  ACH_FRAG_SOMEONE	TEXT("ACH_FRAG_SOMEONE")
 #define  ACH_SOME_KILLS		TEXT("ACH_SOME_KILLS")
@@ -36,6 +39,8 @@ AShooterPlayerController::AShooterPlayerController(const class FPostConstructIni
 	PlayerCameraManagerClass = AShooterPlayerCameraManager::StaticClass();
 	CheatClass = UShooterCheatManager::StaticClass();
 	bAllowGameActions = true;
+	DeathCameraLocation = FVector::ZeroVector;
+	DeathCameraRotation = FRotator::ZeroRotator;
 
 	if (!HasAnyFlags(RF_ClassDefaultObject))
 	{
@@ -95,6 +100,9 @@ void AShooterPlayerController::QueryAchievements()
 					{
 						Achievements->QueryAchievements( *UserId.Get(), FOnQueryAchievementsCompleteDelegate::CreateUObject( this, &AShooterPlayerController::OnQueryAchievementsComplete ));
 					}
+
+					// retries progress a failed write left in the persistent user
+					FShooterAchievementQueue::Get().AddUser(LocalPlayer->ControllerId, GetPersistentUser());
 				}
 				else
 				{
@@ -120,6 +128,22 @@ void AShooterPlayerController::QueryAchievements()
 void AShooterPlayerController::OnQueryAchievementsComplete(const FUniqueNetId& PlayerId, const bool bWasSuccessful )
 {
 	UE_LOG(LogOnline, Display, TEXT("AShooterPlayerController::OnQueryAchievementsComplete(bWasSuccessful = %s)"), bWasSuccessful ? TEXT("TRUE") : TEXT("FALSE"));
+
+	ULocalPlayer* LocalPlayer = Cast<ULocalPlayer>(Player);
+	IOnlineSubsystem* OnlineSub = IOnlineSubsystem::Get();
+	if (bWasSuccessful && LocalPlayer && OnlineSub)
+	{
+		IOnlineAchievementsPtr Achievements = OnlineSub->GetAchievementsInterface();
+		TArray<FOnlineAchievement> CachedAchievements;
+		if (Achievements.IsValid() && Achievements->GetCachedAchievements(PlayerId, CachedAchievements) == EOnlineCachedResult::Success)
+		{
+			// progress the service already has doesn't need to be written again
+			for (int32 i = 0; i < CachedAchievements.Num(); i++)
+			{
+				FShooterAchievementQueue::Get().SetKnownProgress(LocalPlayer->ControllerId, CachedAchievements[i].Id, (float)CachedAchievements[i].Progress);
+			}
+		}
+	}
 }
 
 void AShooterPlayerController::UnFreeze()
@@ -201,8 +225,67 @@ void AShooterPlayerController::GameHasEnded(class AActor* EndGameFocus, bool bIs
 
 void AShooterPlayerController::ClientSetSpectatorCamera_Implementation(FVector CameraLocation, FRotator CameraRotation)
 {
-	SetInitialLocationAndRotation(CameraLocation, CameraRotation);
+	DeathCameraLocation = CameraLocation;
+	DeathCameraRotation = CameraRotation;
 	SetViewTarget(this);
+
+	// kill-cam moves here once it's done
+	if (!KillCamPlayback.IsValid())
+	{
+		SetInitialLocationAndRotation(CameraLocation, CameraRotation);
+	}
+}
+
+void AShooterPlayerController::ClientPlayKillCam_Implementation(const FShooterKillCamClip& Clip)
+{
+	if (Clip.NumFrames < 2 || Clip.Actors.Num() == 0)
+	{
+		return;
+	}
+
+	KillCamPlayback = MakeShareable(new FShooterKillCamPlayback(Clip));
+	KillCamPawn = GetPawn();
+	DeathCameraLocation = Clip.Origin + FVector(0, 0, 300.0f);
+	DeathCameraRotation = FRotator(-90.0f, 0.0f, 0.0f);
+
+	SetViewTarget(this);
+}
+
+const FShooterKillCamPlayback* AShooterPlayerController::GetKillCamPlayback() const
+{
+	return KillCamPlayback.Get();
+}
+
+void AShooterPlayerController::PlayerTick(float DeltaTime)
+{
+	Super::PlayerTick(DeltaTime);
+
+	if (KillCamPlayback.IsValid())
+	{
+		const bool bRespawned = GetPawn() != NULL && GetPawn() != KillCamPawn.Get();
+		if (bRespawned || !KillCamPlayback->Tick(DeltaTime))
+		{
+			StopKillCam();
+		}
+		else
+		{
+			FVector CameraLocation;
+			FRotator CameraRotation;
+			KillCamPlayback->GetCameraView(GetWorld(), CameraLocation, CameraRotation);
+			SetInitialLocationAndRotation(CameraLocation, CameraRotation);
+		}
+	}
+}
+
+void AShooterPlayerController::StopKillCam()
+{
+	KillCamPlayback.Reset();
+	KillCamPawn.Reset();
+
+	if (GetPawn() == NULL)
+	{
+		SetInitialLocationAndRotation(DeathCameraLocation, DeathCameraRotation);
+	}
 }
 
 bool AShooterPlayerController::FindDeathCameraSpot(FVector& CameraLocation, FRotator& CameraRotation)
@@ -253,6 +336,11 @@ void AShooterPlayerController::SimulateInputKey(FKey Key, bool bPressed)
 	InputKey(Key, bPressed ? IE_Pressed : IE_Released, 1, false);
 }
 
+void AShooterPlayerController::ClientOnKill_Implementation()
+{
+	OnKill();
+}
+
 void AShooterPlayerController::OnKill()
 {
 	UpdateAchievementProgress(ACH_FRAG_SOMEONE, 100.0f);
@@ -269,9 +357,9 @@ void AShooterPlayerController::OnKill()
 			TSharedPtr<FUniqueNetId> UniqueID = Identity->GetUniquePlayerId(UserIndex);			
 			if (UniqueID.IsValid())
 			{			
+				// pawn can be gone already when the notify arrives
 				ACharacter* Pawn = GetCharacter();
-				check(Pawn);
-				FVector Location = Pawn->GetActorLocation();
+				const FVector Location = Pawn ? Pawn->GetActorLocation() : (PlayerCameraManager ? PlayerCameraManager->GetCameraLocation() : FVector::ZeroVector);
 
 				FOnlineEventParms Params;		
 
@@ -323,9 +411,9 @@ void AShooterPlayerController::OnDeathMessage(class AShooterPlayerState* KillerP
 				TSharedPtr<FUniqueNetId> UniqueID = Identity->GetUniquePlayerId(UserIndex);
 				if (UniqueID.IsValid())
 				{				
+					// victim's pawn is usually unpossessed by the time the kill event arrives, death cam is where it died
 					ACharacter* Pawn = GetCharacter();
-					check(Pawn);
-					FVector Location = Pawn->GetActorLocation();
+					const FVector Location = Pawn ? Pawn->GetActorLocation() : (PlayerCameraManager ? PlayerCameraManager->GetCameraLocation() : FVector::ZeroVector);
 
 					FOnlineEventParms Params;
 					Params.Add( TEXT( "SectionId" ), FVariantData( (int32)1 ) );
@@ -353,45 +441,7 @@ void AShooterPlayerController::UpdateAchievementProgress( const FString& Id, flo
 	ULocalPlayer* LocalPlayer = Cast<ULocalPlayer>(Player);
 	if (LocalPlayer)
 	{
-		IOnlineSubsystem* OnlineSub = IOnlineSubsystem::Get();
-		if(OnlineSub)
-		{
-			IOnlineIdentityPtr Identity = OnlineSub->GetIdentityInterface();
-			if (Identity.IsValid())
-			{
-				TSharedPtr<FUniqueNetId> UserId = Identity->GetUniquePlayerId(LocalPlayer->ControllerId);
-
-				if (UserId.IsValid())
-				{
-
-					IOnlineAchievementsPtr Achievements = OnlineSub->GetAchievementsInterface();
-					if (Achievements.IsValid() && (!WriteObject.IsValid() || WriteObject->WriteState != EOnlineAsyncTaskState::InProgress))
-					{
-						WriteObject = MakeShareable(new FOnlineAchievementsWrite());
-						WriteObject->SetFloatStat(*Id, Percent);
-
-						FOnlineAchievementsWriteRef WriteObjectRef = WriteObject.ToSharedRef();
-						Achievements->WriteAchievements(*UserId.Get(), WriteObjectRef);
-					}
-					else
-					{
-						UE_LOG(LogOnline, Warning, TEXT("No valid achievement interface or another write is in progress."));
-					}
-				}
-				else
-				{
-					UE_LOG(LogOnline, Warning, TEXT("No valid user id for this controller."));
-				}
-			}
-			else
-			{
-				UE_LOG(LogOnline, Warning, TEXT("No valid identity interface."));
-			}
-		}
-		else
-		{
-			UE_LOG(LogOnline, Warning, TEXT("No default online subsystem."));
-		}
+		FShooterAchievementQueue::Get().UpdateProgress(LocalPlayer->ControllerId, GetPersistentUser(), Id, Percent);
 	}
 	else
 	{
@@ -462,16 +512,33 @@ bool AShooterPlayerController::IsGameMenuVisible() const
 void AShooterPlayerController::SetInfiniteAmmo(bool bEnable)
 {
 	bInfiniteAmmo = bEnable;
+	OnRep_WeaponCheats();
 }
 
 void AShooterPlayerController::SetInfiniteClip(bool bEnable)
 {
 	bInfiniteClip = bEnable;
+	OnRep_WeaponCheats();
+}
+
+void AShooterPlayerController::OnRep_WeaponCheats()
+{
+	AShooterCharacter* MyPawn = Cast<AShooterCharacter>(GetPawn());
+	if (MyPawn)
+	{
+		MyPawn->ResolveWeaponModifiers();
+	}
 }
 
 void AShooterPlayerController::SetHealthRegen(bool bEnable)
 {
 	bHealthRegen = bEnable;
+
+	AShooterCharacter* MyPawn = Cast<AShooterCharacter>(GetPawn());
+	if (MyPawn)
+	{
+		MyPawn->RequestPeriodicUpdates();
+	}
 }
 
 void AShooterPlayerController::SetGodMode(bool bEnable)
@@ -702,6 +769,12 @@ void AShooterPlayerController::ClientGameEnded_Implementation(class AActor* EndG
 			ShooterHUD->ShowScoreboard(true);
 		}
 	}
+
+	// server flushes in FinishMatch
+	if (GetNetMode() == NM_Client)
+	{
+		FShooterNetAccounting::Get().FlushToCSV(GetWorld()->GetMapName());
+	}
 }
 
 void AShooterPlayerController::SetCinematicMode(bool bInCinematicMode, bool bHidePlayer, bool bAffectsHUD, bool bAffectsMovement, bool bAffectsTurning)
@@ -735,6 +808,25 @@ void AShooterPlayerController::InitInputSystem()
 	}
 }
 
+void AShooterPlayerController::PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker)
+{
+	Super::PreReplication(ChangedPropertyTracker);
+
+	FShooterNetAccounting::Get().AccountReplicatedProperties(this);
+}
+
+bool AShooterPlayerController::CallRemoteFunction(UFunction* Function, void* Parameters, FOutParmRec* OutParms, FFrame* Stack)
+{
+	FShooterNetAccounting::FScopedSend ScopedSend(this, Function);
+	return Super::CallRemoteFunction(Function, Parameters, OutParms, Stack);
+}
+
+void AShooterPlayerController::ProcessEvent(UFunction* Function, void* Parameters)
+{
+	FShooterNetAccounting::Get().AccountReceivedCall(this, Function, Parameters);
+	Super::ProcessEvent(Function, Parameters);
+}
+
 void AShooterPlayerController::GetLifetimeReplicatedProps( TArray< FLifetimeProperty > & OutLifetimeProps ) const
 {
 	Super::GetLifetimeReplicatedProps( OutLifetimeProps );
@@ -0,0 +1,49 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "ShooterConfigSection.h"
+
+FShooterConfigSection::FShooterConfigSection(const TCHAR* InSection)
+	: Section(InSection)
+{
+}
+
+void FShooterConfigSection::Get(const TCHAR* Key, float& Value) const
+{
+	if (GConfig)
+	{
+		GConfig->GetFloat(Section, Key, Value, GGameIni);
+	}
+}
+
+void FShooterConfigSection::Get(const TCHAR* Key, int32& Value) const
+{
+	if (GConfig)
+	{
+		GConfig->GetInt(Section, Key, Value, GGameIni);
+	}
+}
+
+void FShooterConfigSection::Get(const TCHAR* Key, bool& Value) const
+{
+	if (GConfig)
+	{
+		GConfig->GetBool(Section, Key, Value, GGameIni);
+	}
+}
+
+void FShooterConfigSection::Get(const TCHAR* Key, FString& Value) const
+{
+	if (GConfig)
+	{
+		GConfig->GetString(Section, Key, Value, GGameIni);
+	}
+}
+
+void FShooterConfigSection::Get(const TCHAR* Key, TArray<FString>& Values) const
+{
+	if (GConfig)
+	{
+		GConfig->GetArray(Section, Key, Values, GGameIni);
+	}
+}
@@ -0,0 +1,27 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+/**
+ * Reads settings of one section of the Game ini, e.g. [ShooterGame.ServerBudget].
+ * A key missing from the ini (or no config system yet) leaves the value untouched, so callers set defaults first.
+ */
+class FShooterConfigSection
+{
+public:
+
+	FShooterConfigSection(const TCHAR* InSection);
+
+	void Get(const TCHAR* Key, float& Value) const;
+	void Get(const TCHAR* Key, int32& Value) const;
+	void Get(const TCHAR* Key, bool& Value) const;
+	void Get(const TCHAR* Key, FString& Value) const;
+
+	/** reads all values of an array key (+Key=...) */
+	void Get(const TCHAR* Key, TArray<FString>& Values) const;
+
+private:
+
+	/** name of ini section */
+	const TCHAR* Section;
+};
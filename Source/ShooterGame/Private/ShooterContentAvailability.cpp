@@ -0,0 +1,226 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "ShooterContentAvailability.h"
+#include "ShooterConfigSection.h"
+
+/** forwards to platform chunk installer */
+class FShooterPlatformChunkSource : public IShooterChunkSource
+{
+public:
+
+	FShooterPlatformChunkSource(IPlatformChunkInstall* InInstaller)
+		: Installer(InInstaller)
+	{
+	}
+
+	virtual EChunkLocation::Type GetChunkLocation(uint32 ChunkID) OVERRIDE
+	{
+		return Installer->GetChunkLocation(ChunkID);
+	}
+
+	virtual float GetChunkProgress(uint32 ChunkID) OVERRIDE
+	{
+		return Installer->GetChunkProgress(ChunkID, EChunkProgressReportingType::PercentageComplete);
+	}
+
+	virtual bool PrioritizeChunk(uint32 ChunkID) OVERRIDE
+	{
+		return Installer->PrioritizeChunk(ChunkID, EChunkPriority::High);
+	}
+
+private:
+
+	IPlatformChunkInstall* Installer;
+};
+
+/** installs one chunk at a time at fixed rate, prioritized chunk first */
+class FShooterFakeChunkSource : public IShooterChunkSource
+{
+public:
+
+	FShooterFakeChunkSource(float InPercentPerSecond)
+		: PercentPerSecond(InPercentPerSecond)
+		, PrioritizedChunk(INDEX_NONE)
+	{
+	}
+
+	virtual EChunkLocation::Type GetChunkLocation(uint32 ChunkID) OVERRIDE
+	{
+		return GetChunkProgress(ChunkID) >= 100.0f ? EChunkLocation::LocalFast : EChunkLocation::NotAvailable;
+	}
+
+	virtual float GetChunkProgress(uint32 ChunkID) OVERRIDE
+	{
+		return Progress.FindOrAdd(ChunkID);
+	}
+
+	virtual bool PrioritizeChunk(uint32 ChunkID) OVERRIDE
+	{
+		PrioritizedChunk = ChunkID;
+		return true;
+	}
+
+	virtual void Tick(float DeltaSeconds) OVERRIDE
+	{
+		float* Installing = NULL;
+		if (PrioritizedChunk != INDEX_NONE)
+		{
+			Installing = &Progress.FindOrAdd(PrioritizedChunk);
+		}
+
+		if (Installing == NULL || *Installing >= 100.0f)
+		{
+			Installing = NULL;
+			for (TMap<uint32, float>::TIterator It(Progress); It; ++It)
+			{
+				if (It.Value() < 100.0f)
+				{
+					Installing = &It.Value();
+					break;
+				}
+			}
+		}
+
+		if (Installing)
+		{
+			*Installing = FMath::Min(*Installing + PercentPerSecond * DeltaSeconds, 100.0f);
+		}
+	}
+
+private:
+
+	/** install speed */
+	float PercentPerSecond;
+
+	/** chunk installed before others */
+	int32 PrioritizedChunk;
+
+	/** progress of every chunk queried so far */
+	TMap<uint32, float> Progress;
+};
+
+static void UseFakeChunkInstaller(const TArray<FString>& Args)
+{
+	const float PercentPerSecond = Args.Num() > 0 ? FCString::Atof(*Args[0]) : 10.0f;
+	FShooterContentAvailability::Get().UseFakeInstaller(PercentPerSecond);
+}
+
+FAutoConsoleCommand CmdFakeChunkInstall(
+	TEXT("Shooter.FakeChunkInstall"),
+	TEXT("Simulates chunk install of all maps, optional argument: percent per second"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(UseFakeChunkInstaller)
+	);
+
+FShooterContentAvailability& FShooterContentAvailability::Get()
+{
+	static FShooterContentAvailability Instance;
+	return Instance;
+}
+
+FShooterContentAvailability::FShooterContentAvailability()
+	: PollInterval(0.25f)
+	, TimeUntilPoll(0.0f)
+	, PrioritizedMapIndex(INDEX_NONE)
+{
+	// maps aren't members of the AssetRegistry yet, so chunk assignment has to be listed here
+#if PLATFORM_XBOXONE
+	Maps.Add(FShooterMapContent(TEXT("Sanctuary"), 1, 1000));
+	Maps.Add(FShooterMapContent(TEXT("Highrise"), 2, 1000));
+#else
+	Maps.Add(FShooterMapContent(TEXT("Sanctuary"), 1, 1));
+	Maps.Add(FShooterMapContent(TEXT("Highrise"), 2, 2));
+#endif
+
+	float FakeInstallRate = 10.0f;
+	const FShooterConfigSection Config(TEXT("ShooterGame.ContentAvailability"));
+	Config.Get(TEXT("PollInterval"), PollInterval);
+	Config.Get(TEXT("FakeInstallRate"), FakeInstallRate);
+
+	if (FParse::Param(FCommandLine::Get(), TEXT("FakeChunkInstall")))
+	{
+		ChunkSource = MakeShareable(new FShooterFakeChunkSource(FakeInstallRate));
+	}
+	else if (IPlatformChunkInstall* Installer = FPlatformMisc::GetPlatformChunkInstall())
+	{
+		ChunkSource = MakeShareable(new FShooterPlatformChunkSource(Installer));
+	}
+
+	UpdateMaps();
+}
+
+bool FShooterContentAvailability::IsMapReady(int32 MapIndex) const
+{
+	return !Maps.IsValidIndex(MapIndex) || Maps[MapIndex].IsReady();
+}
+
+int32 FShooterContentAvailability::GetMapPercentComplete(int32 MapIndex) const
+{
+	return Maps.IsValidIndex(MapIndex) ? Maps[MapIndex].PercentComplete : 100;
+}
+
+void FShooterContentAvailability::PrioritizeMap(int32 MapIndex)
+{
+	if (Maps.IsValidIndex(MapIndex) && MapIndex != PrioritizedMapIndex)
+	{
+		PrioritizedMapIndex = MapIndex;
+		if (ChunkSource.IsValid() && !Maps[MapIndex].IsReady())
+		{
+			ChunkSource->PrioritizeChunk(Maps[MapIndex].InstallChunkID);
+		}
+	}
+}
+
+void FShooterContentAvailability::UseFakeInstaller(float PercentPerSecond)
+{
+	ChunkSource = MakeShareable(new FShooterFakeChunkSource(PercentPerSecond));
+
+	// re-apply priority to the new source
+	const int32 PrevPrioritizedMapIndex = PrioritizedMapIndex;
+	PrioritizedMapIndex = INDEX_NONE;
+	UpdateMaps();
+	PrioritizeMap(PrevPrioritizedMapIndex);
+}
+
+bool FShooterContentAvailability::Tick(float DeltaSeconds)
+{
+	if (ChunkSource.IsValid())
+	{
+		ChunkSource->Tick(DeltaSeconds);
+
+		TimeUntilPoll -= DeltaSeconds;
+		if (TimeUntilPoll <= 0.0f)
+		{
+			TimeUntilPoll = PollInterval;
+			UpdateMaps();
+		}
+	}
+
+	return true;
+}
+
+void FShooterContentAvailability::UpdateMaps()
+{
+	for (int32 i = 0; i < Maps.Num(); i++)
+	{
+		FShooterMapContent& Map = Maps[i];
+
+		EChunkLocation::Type NewLocation = EChunkLocation::LocalFast;
+		int32 NewPercent = 100;
+		if (ChunkSource.IsValid())
+		{
+			NewLocation = ChunkSource->GetChunkLocation(Map.InstallChunkID);
+			if (NewLocation == EChunkLocation::NotAvailable)
+			{
+				NewPercent = FMath::Clamp(FMath::FloorToInt(ChunkSource->GetChunkProgress(Map.InstallChunkID)), 0, 100);
+			}
+		}
+
+		if (NewLocation != Map.Location || NewPercent != Map.PercentComplete)
+		{
+			Map.Location = NewLocation;
+			Map.PercentComplete = NewPercent;
+			MapContentChangedEvent.Broadcast(i);
+		}
+	}
+}
@@ -0,0 +1,131 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "GenericPlatformChunkInstall.h"
+
+/** source of chunk install state, either the platform installer or a local fake */
+class IShooterChunkSource
+{
+public:
+
+	virtual ~IShooterChunkSource() {}
+
+	/** returns where chunk currently lives */
+	virtual EChunkLocation::Type GetChunkLocation(uint32 ChunkID) = 0;
+
+	/** returns install progress of chunk, 0-100 */
+	virtual float GetChunkProgress(uint32 ChunkID) = 0;
+
+	/** moves chunk to the front of install queue */
+	virtual bool PrioritizeChunk(uint32 ChunkID) = 0;
+
+	/** advances simulated installs, platform installers progress on their own */
+	virtual void Tick(float DeltaSeconds) {}
+};
+
+/** single playable map and the chunks it is shipped in */
+struct FShooterMapContent
+{
+	/** map name, used in travel URLs and menu */
+	FString MapName;
+
+	/** pak chunk assigned at cook time */
+	int32 PakChunkID;
+
+	/** chunk queried from installer at runtime */
+	int32 InstallChunkID;
+
+	/** last known location of InstallChunkID */
+	EChunkLocation::Type Location;
+
+	/** last known install progress in whole percents */
+	int32 PercentComplete;
+
+	FShooterMapContent(const FString& InMapName, int32 InPakChunkID, int32 InInstallChunkID)
+		: MapName(InMapName)
+		, PakChunkID(InPakChunkID)
+		, InstallChunkID(InInstallChunkID)
+		, Location(EChunkLocation::DoesNotExist)
+		, PercentComplete(0)
+	{
+	}
+
+	/** can map be loaded right now? */
+	bool IsReady() const
+	{
+		return Location != EChunkLocation::NotAvailable;
+	}
+};
+
+/**
+ * Tracks install state of all map chunks and notifies listeners on change, so UI doesn't have to poll the installer.
+ * Also the single source of map to chunk assignment used by the cooker.
+ *
+ * Start with "-FakeChunkInstall" or use "Shooter.FakeChunkInstall [PercentPerSecond]" to simulate installs locally.
+ */
+class FShooterContentAvailability : public FTickerObjectBase
+{
+public:
+
+	/** pak chunk holding engine and shared content */
+	static const int32 BasePakChunkID = 0;
+
+	/** index of map whose state changed */
+	DECLARE_MULTICAST_DELEGATE_OneParam(FOnMapContentChanged, int32);
+
+	/** returns the service */
+	static FShooterContentAvailability& Get();
+
+	/** returns all known maps */
+	const TArray<FShooterMapContent>& GetMaps() const
+	{
+		return Maps;
+	}
+
+	/** can map be loaded right now? */
+	bool IsMapReady(int32 MapIndex) const;
+
+	/** returns install progress of map in whole percents */
+	int32 GetMapPercentComplete(int32 MapIndex) const;
+
+	/** requests map to be installed before others, call with map player is likely to pick next */
+	void PrioritizeMap(int32 MapIndex);
+
+	/** replaces platform installer with simulated one, all maps start uninstalled */
+	void UseFakeInstaller(float PercentPerSecond);
+
+	/** called when location or progress of map changes */
+	FOnMapContentChanged& OnMapContentChanged()
+	{
+		return MapContentChangedEvent;
+	}
+
+	/** polls chunk source at PollInterval */
+	virtual bool Tick(float DeltaSeconds) OVERRIDE;
+
+private:
+
+	FShooterContentAvailability();
+
+	/** queries source for all maps and fires change events */
+	void UpdateMaps();
+
+	/** known maps */
+	TArray<FShooterMapContent> Maps;
+
+	/** installer being tracked, NULL if platform has none */
+	TSharedPtr<IShooterChunkSource> ChunkSource;
+
+	/** map change notification */
+	FOnMapContentChanged MapContentChangedEvent;
+
+	/** time between installer queries */
+	float PollInterval;
+
+	/** time left until next query */
+	float TimeUntilPoll;
+
+	/** map requested by PrioritizeMap */
+	int32 PrioritizedMapIndex;
+};
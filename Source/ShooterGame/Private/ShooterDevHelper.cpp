@@ -0,0 +1,49 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "ShooterDevHelper.h"
+
+#if !UE_BUILD_SHIPPING
+
+UWorld* ShooterDevHelper::GetWorld()
+{
+	const TIndirectArray<FWorldContext>& WorldContexts = GEngine->GetWorldContexts();
+	for (int32 i = 0; i < WorldContexts.Num(); i++)
+	{
+		const FWorldContext& Context = WorldContexts[i];
+		if (Context.WorldType == EWorldType::Game || Context.WorldType == EWorldType::PIE)
+		{
+			return Context.World();
+		}
+	}
+
+	return NULL;
+}
+
+AShooterCharacter* ShooterDevHelper::GetTestPawn(UWorld* World)
+{
+	if (World == NULL)
+	{
+		return NULL;
+	}
+
+	APlayerController* LocalPC = World->GetFirstPlayerController();
+	AShooterCharacter* LocalPawn = LocalPC ? Cast<AShooterCharacter>(LocalPC->GetPawn()) : NULL;
+	if (LocalPawn && LocalPawn->IsAlive())
+	{
+		return LocalPawn;
+	}
+
+	for (FConstPawnIterator It = World->GetPawnIterator(); It; ++It)
+	{
+		AShooterCharacter* Pawn = Cast<AShooterCharacter>(*It);
+		if (Pawn && !Pawn->IsPendingKill() && Pawn->IsAlive())
+		{
+			return Pawn;
+		}
+	}
+
+	return NULL;
+}
+
+#endif
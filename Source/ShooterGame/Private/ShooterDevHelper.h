@@ -0,0 +1,19 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#if !UE_BUILD_SHIPPING
+
+/**
+ * Lookups shared by development console commands that exercise game systems on a running game.
+ */
+namespace ShooterDevHelper
+{
+	/** returns game (or PIE) world console commands act on, NULL if no game is running */
+	UWorld* GetWorld();
+
+	/** returns pawn of first local player, or first live shooter pawn if there's none (e.g. on dedicated server) */
+	class AShooterCharacter* GetTestPawn(UWorld* World);
+}
+
+#endif
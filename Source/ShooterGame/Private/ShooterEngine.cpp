@@ -16,6 +16,13 @@ void UShooterEngine::Init(IEngineLoop* InEngineLoop)
 	// Note: Lots of important things happen in Super::Init(), including spawning the player pawn in-game and
 	// creating the renderer.
 	Super::Init(InEngineLoop);	
+
+	// first launch with auto quality measures the machine
+	UShooterGameUserSettings* UserSettings = Cast<UShooterGameUserSettings>(GetGameUserSettings());
+	if (UserSettings)
+	{
+		UserSettings->InitAutoQuality();
+	}
 }
 
 
@@ -2,6 +2,8 @@
 
 #include "ShooterGame.h"
 #include "GameDelegates.h"
+#include "Online/ShooterStatsExport.h"
+#include "ShooterContentAvailability.h"
 
 
 #if !UE_BUILD_SHIPPING
@@ -27,75 +29,66 @@ FAutoConsoleCommand CmdPlayGoNext(
 #endif
 
 
+/** match state JSON for the companion app and monitoring, cached between requests */
+static FShooterStatsExport& GetStatsExport()
+{
+	static FShooterStatsExport StatsExport;
+	return StatsExport;
+}
+
+static UWorld* GetStatsExportWorld()
+{
+	// you shouldn't normally use this method to get a UWorld as it won't always be correct in a PIE context.
+	// However, the PS4 companion app server will never run in the Editor.
+	UGameEngine* GameEngine = Cast<UGameEngine>(GEngine);
+	return GameEngine ? GameEngine->GetGameWorld() : NULL;
+}
+
+static void DumpStatsJson()
+{
+	UE_LOG(LogShooter, Log, TEXT("%s"), *GetStatsExport().GetMatchStateJson(GetStatsExportWorld()));
+}
+
+FAutoConsoleCommand CmdDumpStatsJson(
+	TEXT("Shooter.DumpStatsJson"),
+	TEXT("Writes the match state JSON served to the companion app to the log"),
+	FConsoleCommandDelegate::CreateStatic(DumpStatsJson)
+	);
+
 // respond to requests from a companion app
 static void WebServerDelegate(int32 UserIndex, const FString& Action, const FString& URL, const TMap<FString, FString>& Params, TMap<FString, FString>& Response)
 {
 	if (URL == TEXT("/index.html?scoreboard"))
 	{
-		FString ScoreboardStr = TEXT("{ \"scoreboard\" : [ ");
-
-		// you shouldn't normally use this method to get a UWorld as it won't always be correct in a PIE context.
-		// However, the PS4 companion app server will never run in the Editor.
-		UGameEngine* GameEngine = CastChecked<UGameEngine>(GEngine);
-		if (GameEngine)
+		UWorld* World = GetStatsExportWorld();
+		if (World)
 		{
-			UWorld* World = GameEngine->GetGameWorld();
-			if (World)
-			{			
-				ULocalPlayer *Player = GEngine->GetFirstGamePlayer(World);
-				if (Player)
-				{
-					// get the shoter game
-					AShooterGameState* const GameState = Cast<AShooterGameState>(Player->PlayerController->GetWorld()->GameState);
-
-
-					RankedPlayerMap Players;
-					GameState->GetRankedMap(0, Players);
-
-					bool bNeedsComma = false;
-					for (auto It = Players.CreateIterator(); It; ++It)
-					{
-						if (bNeedsComma)
-						{
-							ScoreboardStr += TEXT(" ,");
-						}
-						ScoreboardStr += FString::Printf(TEXT(" { \"n\" : \"%s\" , \"k\" : \"%d\" , \"d\" : \"%d\" }"), *It.Value()->GetShortPlayerName(), It.Value()->GetKills(), It.Value()->GetDeaths());
-						bNeedsComma = true;
-					}
-				}
-
-				ScoreboardStr += TEXT(" ] }");
-
-				Response.Add(TEXT("Content-Type"), TEXT("text/html; charset=utf-8"));
-				Response.Add(TEXT("Body"), ScoreboardStr);
-			}
+			Response.Add(TEXT("Content-Type"), TEXT("text/html; charset=utf-8"));
+			Response.Add(TEXT("Body"), GetStatsExport().GetMatchStateJson(World));
 		}
 	}
 }
 
 static void AssignStreamingChunk(const FString& PackageToAdd, const FString& LastLoadedMapName, const TArray<int32>& AssetRegistryChunkIDs, const TArray<int32>& ExistingChunkIds, int32& OutChunkIndex)
 {
-	const int32 BasePak = 0;
-	const int32 SanctuaryPak = 1;
-	const int32 HighrisePak = 2;
+	const FShooterContentAvailability& Content = FShooterContentAvailability::Get();
 
 	// Add assets to map paks unless they're engine packages or have already been added to the base (engine) pak.
-	if (!PackageToAdd.StartsWith("/Engine/"))
+	if (!PackageToAdd.StartsWith("/Engine/") && !ExistingChunkIds.Contains(FShooterContentAvailability::BasePakChunkID))
 	{
-		if ((LastLoadedMapName.Find(TEXT("Sanctuary")) >= 0 || PackageToAdd.Find(TEXT("Sanctuary")) >= 0) &&
-				!ExistingChunkIds.Contains(BasePak))
-		{
-			OutChunkIndex = SanctuaryPak;
-		}
-		else if ((LastLoadedMapName.Find(TEXT("Highrise")) >= 0 || PackageToAdd.Find(TEXT("Highrise")) >= 0) &&
-			!ExistingChunkIds.Contains(BasePak))
+		const TArray<FShooterMapContent>& Maps = Content.GetMaps();
+		for (int32 i = 0; i < Maps.Num(); i++)
 		{
-			OutChunkIndex = HighrisePak;
+			if (LastLoadedMapName.Find(Maps[i].MapName) >= 0 || PackageToAdd.Find(Maps[i].MapName) >= 0)
+			{
+				OutChunkIndex = Maps[i].PakChunkID;
+				break;
+			}
 		}
 	}
 	if (OutChunkIndex == INDEX_NONE)
 	{
-		OutChunkIndex = BasePak;
+		OutChunkIndex = FShooterContentAvailability::BasePakChunkID;
 	}
 }
 
@@ -1,6 +1,13 @@
 // Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
 
 #include "ShooterGame.h"
+#include "ShooterQualityBenchmark.h"
+
+/** relative CPU cost of scalability levels, compared to highest */
+static const float CPUCostPerLevel[] = { 0.7f, 0.8f, 0.9f, 1.0f };
+
+/** relative GPU cost of scalability levels, compared to highest */
+static const float GPUCostPerLevel[] = { 0.3f, 0.5f, 0.75f, 1.0f };
 
 UShooterGameUserSettings::UShooterGameUserSettings(const class FPostConstructInitializeProperties& PCIP)
 	: Super(PCIP)
@@ -12,20 +19,36 @@ void UShooterGameUserSettings::SetToDefaults()
 {
 	Super::SetToDefaults();
 
+#if PLATFORM_DESKTOP
+	// hardware varies, measure it
+	GraphicsQuality = 2;
+#else
 	GraphicsQuality = 1;	
+#endif
 	bIsLanMatch = true;
+
+	BenchmarkGameThreadMs = 0.0f;
+	BenchmarkRenderThreadMs = 0.0f;
+	BenchmarkGPUMs = 0.0f;
+	AutoQualityLevel = 3;
+	AppliedQualityLevel = 3;
 }
 
 void UShooterGameUserSettings::ApplySettings()
 {
 	if (GraphicsQuality == 0)
 	{
-		ScalabilityQuality.SetFromSingleQualityLevel(1);
+		AppliedQualityLevel = 1;
+	}
+	else if (IsAutoQuality())
+	{
+		AppliedQualityLevel = AutoQualityLevel;
 	}
 	else
 	{
-		ScalabilityQuality.SetFromSingleQualityLevel(3);
+		AppliedQualityLevel = 3;
 	}
+	ScalabilityQuality.SetFromSingleQualityLevel(AppliedQualityLevel);
 
 	Super::ApplySettings();
 
@@ -33,6 +56,55 @@ void UShooterGameUserSettings::ApplySettings()
 	{
 		return;
 	}
+
+	InitAutoQuality();
+}
+
+void UShooterGameUserSettings::InitAutoQuality()
+{
+	const bool bNeedsBenchmark = IsAutoQuality() && BenchmarkGPUMs <= 0.0f;
+	if (bNeedsBenchmark && !IsRunningDedicatedServer() && !FShooterQualityBenchmark::Get().IsRunning())
+	{
+		FShooterQualityBenchmark::Get().Start();
+	}
+}
+
+void UShooterGameUserSettings::SetBenchmarkResults(float GameThreadMs, float RenderThreadMs, float GPUMs)
+{
+	// scale measurements to highest level, so any level can be predicted from them
+	const int32 MeasuredLevel = FMath::Clamp(AppliedQualityLevel, 0, 3);
+	BenchmarkGameThreadMs = GameThreadMs / CPUCostPerLevel[MeasuredLevel];
+	BenchmarkRenderThreadMs = RenderThreadMs / CPUCostPerLevel[MeasuredLevel];
+	BenchmarkGPUMs = GPUMs / GPUCostPerLevel[MeasuredLevel];
+	AutoQualityLevel = PickAutoQualityLevel();
+
+	UE_LOG(LogShooter, Log, TEXT("Quality benchmark at level %d: game %.1fms, render %.1fms, GPU %.1fms, picked level %d"),
+		MeasuredLevel, GameThreadMs, RenderThreadMs, GPUMs, AutoQualityLevel);
+
+	if (IsAutoQuality())
+	{
+		ApplySettings();
+	}
+	else
+	{
+		SaveSettings();
+	}
+}
+
+int32 UShooterGameUserSettings::PickAutoQualityLevel() const
+{
+	const float TargetFrameTime = FShooterQualityBenchmark::Get().GetTargetFrameTime();
+	for (int32 Level = 3; Level > 0; Level--)
+	{
+		const float CPUMs = FMath::Max(BenchmarkGameThreadMs, BenchmarkRenderThreadMs) * CPUCostPerLevel[Level];
+		const float GPUMs = BenchmarkGPUMs * GPUCostPerLevel[Level];
+		if (FMath::Max(CPUMs, GPUMs) <= TargetFrameTime)
+		{
+			return Level;
+		}
+	}
+
+	return 0;
 }
 
 int32 ShooterGameGetBoundFullScreenModeCVar()
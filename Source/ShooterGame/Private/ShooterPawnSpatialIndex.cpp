@@ -0,0 +1,78 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "ShooterPawnSpatialIndex.h"
+
+FShooterPawnSpatialIndex::FShooterPawnSpatialIndex(float InCellSize)
+	: CellSize(FMath::Max(InCellSize, 1.0f))
+	, MaxPawnExtent(0.0f)
+	, BuiltFrame(MAX_uint64)
+{
+}
+
+FIntPoint FShooterPawnSpatialIndex::GetCell(const FVector& Location) const
+{
+	return FIntPoint(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize));
+}
+
+void FShooterPawnSpatialIndex::ConditionalRebuild(UWorld* World)
+{
+	if (BuiltFrame == GFrameCounter)
+	{
+		return;
+	}
+
+	BuiltFrame = GFrameCounter;
+	MaxPawnExtent = 0.0f;
+
+	// keep allocations around, pawns rarely move far between frames
+	for (auto It = Cells.CreateIterator(); It; ++It)
+	{
+		It.Value().Reset();
+	}
+
+	for (FConstPawnIterator It = World->GetPawnIterator(); It; ++It)
+	{
+		AShooterCharacter* Pawn = Cast<AShooterCharacter>(*It);
+		if (Pawn && !Pawn->IsPendingKill() && Pawn->IsAlive())
+		{
+			Cells.FindOrAdd(GetCell(Pawn->GetActorLocation())).Add(Pawn);
+			MaxPawnExtent = FMath::Max(MaxPawnExtent, Pawn->CapsuleComponent->GetScaledCapsuleHalfHeight());
+		}
+	}
+}
+
+void FShooterPawnSpatialIndex::QuerySphere(UWorld* World, const FVector& Origin, float Radius, TArray<AShooterCharacter*>& OutPawns)
+{
+	if (World == NULL)
+	{
+		return;
+	}
+
+	ConditionalRebuild(World);
+
+	const float QueryRadius = Radius + MaxPawnExtent;
+	const FIntPoint MinCell = GetCell(Origin - FVector(QueryRadius, QueryRadius, 0.0f));
+	const FIntPoint MaxCell = GetCell(Origin + FVector(QueryRadius, QueryRadius, 0.0f));
+
+	for (int32 X = MinCell.X; X <= MaxCell.X; X++)
+	{
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; Y++)
+		{
+			const TArray<AShooterCharacter*>* CellPawns = Cells.Find(FIntPoint(X, Y));
+			if (CellPawns == NULL)
+			{
+				continue;
+			}
+
+			for (int32 i = 0; i < CellPawns->Num(); i++)
+			{
+				AShooterCharacter* Pawn = (*CellPawns)[i];
+				if (!Pawn->IsPendingKill() && FVector::DistSquared(Pawn->GetActorLocation(), Origin) <= FMath::Square(QueryRadius))
+				{
+					OutPawns.Add(Pawn);
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,37 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+/**
+ * Uniform 2D grid of live shooter pawns, used for radius queries on the server.
+ * Rebuilt lazily, at most once per frame, on the first query of that frame.
+ */
+class FShooterPawnSpatialIndex
+{
+public:
+
+	FShooterPawnSpatialIndex(float InCellSize = 1024.0f);
+
+	/** gathers live pawns which may overlap sphere at Origin (coarse test, callers do exact distance checks) */
+	void QuerySphere(UWorld* World, const FVector& Origin, float Radius, TArray<class AShooterCharacter*>& OutPawns);
+
+private:
+
+	/** rebuilds grid if it wasn't built this frame */
+	void ConditionalRebuild(UWorld* World);
+
+	/** returns grid cell for given location */
+	FIntPoint GetCell(const FVector& Location) const;
+
+	/** size of single grid cell */
+	float CellSize;
+
+	/** largest pawn extent found during last rebuild, used to grow queries */
+	float MaxPawnExtent;
+
+	/** frame number of last rebuild */
+	uint64 BuiltFrame;
+
+	/** pawns in each occupied cell */
+	TMap<FIntPoint, TArray<class AShooterCharacter*> > Cells;
+};
@@ -0,0 +1,234 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "ShooterPreloadManifest.h"
+#include "ShooterConfigSection.h"
+#include "Weapons/ShooterWeaponRegistry.h"
+#include "AssetRegistryModule.h"
+#include "IAssetRegistry.h"
+
+#if !UE_BUILD_SHIPPING
+static void DumpPreloadManifest(const TArray<FString>& Args)
+{
+	FShooterPreloadManifest::Get().Dump(Args.Num() > 0 ? Args[0] : FString(), AShooterGame_FreeForAll::StaticClass());
+}
+
+static FAutoConsoleCommand CmdDumpPreloadManifest(
+	TEXT("Shooter.DumpPreloadManifest"),
+	TEXT("Logs assets preloaded for a map and which of them are loaded already, optional argument: map name"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(DumpPreloadManifest)
+	);
+#endif
+
+FShooterPreloadManifest& FShooterPreloadManifest::Get()
+{
+	static FShooterPreloadManifest Instance;
+	return Instance;
+}
+
+FShooterPreloadManifest::FShooterPreloadManifest()
+	: MaxDepth(8)
+	, bPreloading(false)
+{
+	FShooterConfigSection(TEXT("ShooterGame.PreloadManifest")).Get(TEXT("MaxDepth"), MaxDepth);
+}
+
+void FShooterPreloadManifest::StartPreload(const FString& MapName, TSubclassOf<class AGameMode> GameModeClass)
+{
+	ReleasePreloaded();
+
+	// anything in memory already won't hitch
+	const TArray<FStringAssetReference>& Manifest = GetManifest(MapName, GameModeClass);
+	for (int32 i = 0; i < Manifest.Num(); i++)
+	{
+		if (StaticFindObject(UObject::StaticClass(), NULL, *Manifest[i].ToString()) == NULL)
+		{
+			PendingAssets.Add(Manifest[i]);
+		}
+	}
+
+	if (PendingAssets.Num() > 0)
+	{
+		UE_LOG(LogShooter, Log, TEXT("Preloading %d assets for %s, %d loaded already"), PendingAssets.Num(), MapName.IsEmpty() ? TEXT("unknown map") : *MapName,
+			Manifest.Num() - PendingAssets.Num());
+
+		bPreloading = true;
+		Streamable.RequestAsyncLoad(PendingAssets, FStreamableDelegate::CreateRaw(this, &FShooterPreloadManifest::OnPreloadComplete));
+	}
+}
+
+void FShooterPreloadManifest::OnPreloadComplete()
+{
+	bPreloading = false;
+
+	for (int32 i = 0; i < PendingAssets.Num(); i++)
+	{
+		UObject* Asset = PendingAssets[i].ResolveObject();
+		if (Asset)
+		{
+			PreloadedAssets.Add(Asset);
+		}
+	}
+}
+
+void FShooterPreloadManifest::ReleasePreloaded()
+{
+	for (int32 i = 0; i < PendingAssets.Num(); i++)
+	{
+		Streamable.Unload(PendingAssets[i]);
+	}
+
+	PendingAssets.Reset();
+	PreloadedAssets.Reset();
+	bPreloading = false;
+}
+
+void FShooterPreloadManifest::AddReferencedObjects(FReferenceCollector& Collector)
+{
+	Collector.AddReferencedObjects(PreloadedAssets);
+}
+
+const TArray<FStringAssetReference>& FShooterPreloadManifest::GetManifest(const FString& MapName, TSubclassOf<class AGameMode> GameModeClass)
+{
+	const FString Key = MapName + TEXT(":") + (GameModeClass ? GameModeClass->GetName() : FString());
+
+	TArray<FStringAssetReference>* Manifest = Manifests.Find(Key);
+	if (Manifest == NULL)
+	{
+		Manifest = &Manifests.Add(Key, TArray<FStringAssetReference>());
+
+		// assets softly referenced from defaults of game mode: pawns, inventory, effects
+		TSet<UObject*> Visited;
+		GatherFromObject(GameModeClass, 0, Visited, *Manifest);
+
+		GatherWeaponDefinitions(*Manifest);
+
+		// map specific assets
+		if (!MapName.IsEmpty())
+		{
+			TArray<FString> MapAssets;
+			FShooterConfigSection(TEXT("ShooterGame.PreloadManifest")).Get(*MapName, MapAssets);
+			for (int32 i = 0; i < MapAssets.Num(); i++)
+			{
+				Manifest->AddUnique(FStringAssetReference(MapAssets[i]));
+			}
+		}
+	}
+
+	return *Manifest;
+}
+
+void FShooterPreloadManifest::Dump(const FString& MapName, TSubclassOf<class AGameMode> GameModeClass)
+{
+	const TArray<FStringAssetReference>& Manifest = GetManifest(MapName, GameModeClass);
+	UE_LOG(LogShooter, Log, TEXT("Preload manifest of %s: %d assets, %d requested by current preload%s"), MapName.IsEmpty() ? TEXT("unknown map") : *MapName,
+		Manifest.Num(), PendingAssets.Num(), bPreloading ? TEXT(" (streaming)") : TEXT(""));
+
+	for (int32 i = 0; i < Manifest.Num(); i++)
+	{
+		const bool bLoaded = StaticFindObject(UObject::StaticClass(), NULL, *Manifest[i].ToString()) != NULL;
+		UE_LOG(LogShooter, Log, TEXT("  %s%s"), *Manifest[i].ToString(), bLoaded ? TEXT(" (loaded)") : TEXT(""));
+	}
+}
+
+void FShooterPreloadManifest::GatherWeaponDefinitions(TArray<FStringAssetReference>& OutAssets) const
+{
+	TArray<FString> Paths;
+	FShooterWeaponRegistry::GetDefinitionPaths(Paths);
+
+	FARFilter Filter;
+	Filter.ClassNames.Add(UShooterWeaponDefinition::StaticClass()->GetFName());
+	Filter.bRecursivePaths = true;
+	for (int32 i = 0; i < Paths.Num(); i++)
+	{
+		Filter.PackagePaths.Add(FName(*Paths[i]));
+	}
+
+	TArray<FAssetData> Definitions;
+	FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry"));
+	AssetRegistryModule.Get().GetAssets(Filter, Definitions);
+
+	for (int32 i = 0; i < Definitions.Num(); i++)
+	{
+		OutAssets.AddUnique(FStringAssetReference(Definitions[i].ObjectPath.ToString()));
+	}
+}
+
+void FShooterPreloadManifest::GatherFromObject(UObject* Object, int32 Depth, TSet<UObject*>& Visited, TArray<FStringAssetReference>& OutAssets) const
+{
+	if (Object == NULL || Depth > MaxDepth || Visited.Contains(Object))
+	{
+		return;
+	}
+	Visited.Add(Object);
+
+	UClass* Class = Cast<UClass>(Object);
+	if (Class)
+	{
+		GatherFromObject(Class->GetDefaultObject(), Depth + 1, Visited, OutAssets);
+	}
+	else if (!Object->HasAnyFlags(RF_ClassDefaultObject) && Object->GetOuter() && Object->GetOuter()->IsA(UPackage::StaticClass()) && !Object->IsA(UDataAsset::StaticClass()))
+	{
+		// meshes, materials, sounds and other top level assets don't reference gameplay content softly
+	}
+	else
+	{
+		// class defaults, their subobjects (components) and data assets hold the references
+		GatherFromStruct(Object->GetClass(), Object, Depth + 1, Visited, OutAssets);
+	}
+}
+
+void FShooterPreloadManifest::GatherFromStruct(UStruct* Struct, const void* Data, int32 Depth, TSet<UObject*>& Visited, TArray<FStringAssetReference>& OutAssets) const
+{
+	for (TFieldIterator<UProperty> It(Struct); It; ++It)
+	{
+		UProperty* Property = *It;
+		for (int32 i = 0; i < Property->ArrayDim; i++)
+		{
+			GatherFromValue(Property, Property->ContainerPtrToValuePtr<void>(Data, i), Depth, Visited, OutAssets);
+		}
+	}
+}
+
+void FShooterPreloadManifest::GatherFromValue(UProperty* Property, const void* Value, int32 Depth, TSet<UObject*>& Visited, TArray<FStringAssetReference>& OutAssets) const
+{
+	static const FName StringAssetReferenceName(TEXT("StringAssetReference"));
+
+	// asset pointers are object properties as well, check them first
+	if (Cast<UAssetObjectProperty>(Property))
+	{
+		const FStringAssetReference& AssetRef = ((const FAssetPtr*)Value)->GetUniqueID();
+		if (!AssetRef.ToString().IsEmpty())
+		{
+			OutAssets.AddUnique(AssetRef);
+		}
+	}
+	else if (UObjectPropertyBase* ObjectProperty = Cast<UObjectPropertyBase>(Property))
+	{
+		// hard references are loaded already, follow them to soft references they hold
+		GatherFromObject(ObjectProperty->GetObjectPropertyValue(Value), Depth, Visited, OutAssets);
+	}
+	else if (UStructProperty* StructProperty = Cast<UStructProperty>(Property))
+	{
+		if (StructProperty->Struct->GetFName() == StringAssetReferenceName)
+		{
+			const FStringAssetReference& AssetRef = *(const FStringAssetReference*)Value;
+			if (!AssetRef.ToString().IsEmpty())
+			{
+				OutAssets.AddUnique(AssetRef);
+			}
+		}
+		else
+		{
+			GatherFromStruct(StructProperty->Struct, Value, Depth, Visited, OutAssets);
+		}
+	}
+	else if (UArrayProperty* ArrayProperty = Cast<UArrayProperty>(Property))
+	{
+		FScriptArrayHelper ArrayHelper(ArrayProperty, Value);
+		for (int32 i = 0; i < ArrayHelper.Num(); i++)
+		{
+			GatherFromValue(ArrayProperty->Inner, ArrayHelper.GetRawPtr(i), Depth, Visited, OutAssets);
+		}
+	}
+}
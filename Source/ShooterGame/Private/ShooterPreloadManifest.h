@@ -0,0 +1,83 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Engine/StreamableManager.h"
+
+/**
+ * Streams gameplay assets of the map being loaded while the loading screen is up, so the first firefight doesn't hitch.
+ *
+ * Everything the game mode's defaults reference directly is loaded with its class already, so the manifest of a map
+ * only holds what would otherwise load after the map opens: soft references (TAssetPtr, FStringAssetReference) found by
+ * walking defaults of the game mode, its pawns and their inventory, weapon definitions found through the asset registry
+ * (loaded when the game state comes up), and map specific assets listed in [ShooterGame.PreloadManifest] of the
+ * Game ini, e.g. +Sanctuary=/Game/Effects/ParticleSystems/P_Waterfall.P_Waterfall
+ * Assets already in memory when a preload starts are skipped.
+ *
+ * Preloaded assets are referenced until next preload, which keeps them alive through garbage collection on map change.
+ */
+class FShooterPreloadManifest : public FGCObject
+{
+public:
+
+	/** returns the manifest */
+	static FShooterPreloadManifest& Get();
+
+	/** starts streaming assets needed by map, MapName can be empty when joining unknown map */
+	void StartPreload(const FString& MapName, TSubclassOf<class AGameMode> GameModeClass);
+
+	/** logs manifest of map and which of its assets are loaded */
+	void Dump(const FString& MapName, TSubclassOf<class AGameMode> GameModeClass);
+
+	/** returns true while assets are being streamed */
+	bool IsPreloading() const
+	{
+		return bPreloading;
+	}
+
+	/** keeps preloaded assets alive */
+	virtual void AddReferencedObjects(FReferenceCollector& Collector) OVERRIDE;
+
+private:
+
+	FShooterPreloadManifest();
+
+	/** returns cached manifest of map, computing it on first use */
+	const TArray<FStringAssetReference>& GetManifest(const FString& MapName, TSubclassOf<class AGameMode> GameModeClass);
+
+	/** adds weapon definitions the weapon registry will collect */
+	void GatherWeaponDefinitions(TArray<FStringAssetReference>& OutAssets) const;
+
+	/** adds assets softly referenced by object, follows classes to their defaults */
+	void GatherFromObject(UObject* Object, int32 Depth, TSet<UObject*>& Visited, TArray<FStringAssetReference>& OutAssets) const;
+
+	/** adds assets softly referenced by properties of struct or object */
+	void GatherFromStruct(UStruct* Struct, const void* Data, int32 Depth, TSet<UObject*>& Visited, TArray<FStringAssetReference>& OutAssets) const;
+
+	/** adds assets softly referenced by single property value */
+	void GatherFromValue(UProperty* Property, const void* Value, int32 Depth, TSet<UObject*>& Visited, TArray<FStringAssetReference>& OutAssets) const;
+
+	/** called when all assets of current preload are loaded */
+	void OnPreloadComplete();
+
+	/** drops references to assets of previous preload */
+	void ReleasePreloaded();
+
+	/** async loader */
+	FStreamableManager Streamable;
+
+	/** computed manifests, keyed by map and game mode */
+	TMap<FString, TArray<FStringAssetReference> > Manifests;
+
+	/** assets requested by current preload */
+	TArray<FStringAssetReference> PendingAssets;
+
+	/** loaded assets of current preload */
+	TArray<UObject*> PreloadedAssets;
+
+	/** how many references deep defaults are walked */
+	int32 MaxDepth;
+
+	/** assets are being streamed */
+	bool bPreloading;
+};
@@ -0,0 +1,158 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "ShooterQualityBenchmark.h"
+#include "ShooterConfigSection.h"
+#include "RenderCore.h"
+
+static void RunQualityBenchmark()
+{
+	FShooterQualityBenchmark::Get().Start();
+}
+
+FAutoConsoleCommand CmdRunQualityBenchmark(
+	TEXT("Shooter.RunQualityBenchmark"),
+	TEXT("Measures frame times and picks auto quality level"),
+	FConsoleCommandDelegate::CreateStatic(RunQualityBenchmark)
+	);
+
+static UShooterGameUserSettings* GetShooterUserSettings()
+{
+	return GEngine ? Cast<UShooterGameUserSettings>(GEngine->GetGameUserSettings()) : NULL;
+}
+
+FShooterQualityBenchmark& FShooterQualityBenchmark::Get()
+{
+	static FShooterQualityBenchmark Instance;
+	return Instance;
+}
+
+FShooterQualityBenchmark::FShooterQualityBenchmark()
+	: TargetFrameTime(33.3f)
+	, WarmupTime(1.0f)
+	, Duration(4.0f)
+	, DriftTolerance(0.3f)
+	, DriftSustainTime(15.0f)
+	, bRunning(false)
+	, BenchmarkTime(0.0f)
+	, DriftTime(0.0f)
+	, NumSamples(0)
+	, GameThreadSum(0.0f)
+	, RenderThreadSum(0.0f)
+	, GPUSum(0.0f)
+{
+	const FShooterConfigSection Config(TEXT("ShooterGame.AutoQuality"));
+	Config.Get(TEXT("TargetFrameTime"), TargetFrameTime);
+	Config.Get(TEXT("WarmupTime"), WarmupTime);
+	Config.Get(TEXT("Duration"), Duration);
+	Config.Get(TEXT("DriftTolerance"), DriftTolerance);
+	Config.Get(TEXT("DriftSustainTime"), DriftSustainTime);
+}
+
+void FShooterQualityBenchmark::Start()
+{
+	UE_LOG(LogShooter, Log, TEXT("Starting quality benchmark"));
+
+	bRunning = true;
+	BenchmarkTime = 0.0f;
+	NumSamples = 0;
+	GameThreadSum = RenderThreadSum = GPUSum = 0.0f;
+}
+
+bool FShooterQualityBenchmark::Tick(float DeltaSeconds)
+{
+	if (bRunning)
+	{
+		BenchmarkTime += DeltaSeconds;
+		if (BenchmarkTime > WarmupTime)
+		{
+			float GameThreadMs, RenderThreadMs, GPUMs;
+			SampleFrame(DeltaSeconds, GameThreadMs, RenderThreadMs, GPUMs);
+
+			NumSamples++;
+			GameThreadSum += GameThreadMs;
+			RenderThreadSum += RenderThreadMs;
+			GPUSum += GPUMs;
+		}
+
+		if (BenchmarkTime > WarmupTime + Duration)
+		{
+			bRunning = false;
+			ReportResults(NumSamples, GameThreadSum, RenderThreadSum, GPUSum);
+		}
+	}
+	else
+	{
+		TickDriftMonitor(DeltaSeconds);
+	}
+
+	return true;
+}
+
+void FShooterQualityBenchmark::SampleFrame(float DeltaSeconds, float& OutGameThreadMs, float& OutRenderThreadMs, float& OutGPUMs) const
+{
+	OutGameThreadMs = FPlatformTime::ToMilliseconds(GGameThreadTime);
+	OutRenderThreadMs = FPlatformTime::ToMilliseconds(GRenderThreadTime);
+
+	// without GPU timing fall back to whole frame, pessimistic when vsynced
+	OutGPUMs = GGPUFrameTime > 0 ? FPlatformTime::ToMilliseconds(GGPUFrameTime) : DeltaSeconds * 1000.0f;
+}
+
+bool FShooterQualityBenchmark::IsGameplayRunning() const
+{
+	UWorld* World = (GEngine && GEngine->GameViewport) ? GEngine->GameViewport->GetWorld() : NULL;
+	AShooterGameState* const GameState = World ? Cast<AShooterGameState>(World->GameState) : NULL;
+	return GameState && GameState->GetMatchState() == MatchState::InProgress && !World->IsPaused();
+}
+
+void FShooterQualityBenchmark::TickDriftMonitor(float DeltaSeconds)
+{
+	UShooterGameUserSettings* Settings = GetShooterUserSettings();
+	if (Settings == NULL || !Settings->IsAutoQuality() || !IsGameplayRunning())
+	{
+		DriftTime = 0.0f;
+		return;
+	}
+
+	float GameThreadMs, RenderThreadMs, GPUMs;
+	SampleFrame(DeltaSeconds, GameThreadMs, RenderThreadMs, GPUMs);
+
+	// only drift that a different level could fix counts
+	const float FrameMs = FMath::Max3(GameThreadMs, RenderThreadMs, GPUMs);
+	const bool bTooSlow = FrameMs > TargetFrameTime * (1.0f + DriftTolerance) && Settings->GetAppliedQualityLevel() > 0;
+	const bool bTooFast = FrameMs < TargetFrameTime * (1.0f - DriftTolerance) && Settings->GetAppliedQualityLevel() < 3;
+	if (!bTooSlow && !bTooFast)
+	{
+		DriftTime = 0.0f;
+		return;
+	}
+
+	if (DriftTime == 0.0f)
+	{
+		NumSamples = 0;
+		GameThreadSum = RenderThreadSum = GPUSum = 0.0f;
+	}
+
+	DriftTime += DeltaSeconds;
+	NumSamples++;
+	GameThreadSum += GameThreadMs;
+	RenderThreadSum += RenderThreadMs;
+	GPUSum += GPUMs;
+
+	if (DriftTime > DriftSustainTime)
+	{
+		UE_LOG(LogShooter, Log, TEXT("Sustained frame time drifted from target %.1fms, re-evaluating quality"), TargetFrameTime);
+
+		DriftTime = 0.0f;
+		ReportResults(NumSamples, GameThreadSum, RenderThreadSum, GPUSum);
+	}
+}
+
+void FShooterQualityBenchmark::ReportResults(int32 InNumSamples, float GameThreadMs, float RenderThreadMs, float GPUMs)
+{
+	UShooterGameUserSettings* Settings = GetShooterUserSettings();
+	if (Settings && InNumSamples > 0)
+	{
+		Settings->SetBenchmarkResults(GameThreadMs / InNumSamples, RenderThreadMs / InNumSamples, GPUMs / InNumSamples);
+	}
+}
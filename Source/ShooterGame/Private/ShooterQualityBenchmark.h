@@ -0,0 +1,89 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+/**
+ * Measures game thread, render thread and GPU frame times on whatever scene is being rendered
+ * and hands them to UShooterGameUserSettings to pick the auto quality level.
+ *
+ * Runs on first launch with auto quality, when auto quality gets selected in options or on "Shooter.RunQualityBenchmark".
+ * While playing with auto quality it also watches for frame times drifting away from the target and re-evaluates.
+ * Tuned in [ShooterGame.AutoQuality] of the Game ini.
+ */
+class FShooterQualityBenchmark : public FTickerObjectBase
+{
+public:
+
+	/** returns the benchmark */
+	static FShooterQualityBenchmark& Get();
+
+	/** starts measuring, restarts if already running */
+	void Start();
+
+	/** is benchmark running? */
+	bool IsRunning() const
+	{
+		return bRunning;
+	}
+
+	/** returns frame time auto quality aims for (ms) */
+	float GetTargetFrameTime() const
+	{
+		return TargetFrameTime;
+	}
+
+	/** samples frame times */
+	virtual bool Tick(float DeltaSeconds) OVERRIDE;
+
+private:
+
+	FShooterQualityBenchmark();
+
+	/** reads thread and GPU times of last frame */
+	void SampleFrame(float DeltaSeconds, float& OutGameThreadMs, float& OutRenderThreadMs, float& OutGPUMs) const;
+
+	/** is match in progress in game viewport? */
+	bool IsGameplayRunning() const;
+
+	/** watches sustained frame times while playing with auto quality */
+	void TickDriftMonitor(float DeltaSeconds);
+
+	/** passes averages of samples to user settings */
+	void ReportResults(int32 InNumSamples, float GameThreadMs, float RenderThreadMs, float GPUMs);
+
+	/** frame time to hit (ms) */
+	float TargetFrameTime;
+
+	/** time skipped at start of benchmark, lets the scene settle */
+	float WarmupTime;
+
+	/** length of benchmark */
+	float Duration;
+
+	/** allowed relative difference between sustained frame time and target */
+	float DriftTolerance;
+
+	/** how long frame times need to stay outside tolerance before re-evaluating */
+	float DriftSustainTime;
+
+	/** is benchmark running? */
+	bool bRunning;
+
+	/** time since benchmark start */
+	float BenchmarkTime;
+
+	/** time frame times stayed outside tolerance */
+	float DriftTime;
+
+	/** samples of benchmark or drift window */
+	int32 NumSamples;
+
+	/** sum of game thread times of samples (ms) */
+	float GameThreadSum;
+
+	/** sum of render thread times of samples (ms) */
+	float RenderThreadSum;
+
+	/** sum of GPU times of samples (ms) */
+	float GPUSum;
+};
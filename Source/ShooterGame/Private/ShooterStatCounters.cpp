@@ -0,0 +1,111 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "ShooterStatCounters.h"
+
+static void DumpShooterCounters()
+{
+	FShooterStatCounters::Get().DumpToLog();
+}
+
+static void ToggleShooterCounters()
+{
+	FShooterStatCounters::Get().ToggleOverlay();
+}
+
+FAutoConsoleCommand CmdDumpShooterCounters(
+	TEXT("Shooter.DumpCounters"),
+	TEXT("Writes hot path counters to the log"),
+	FConsoleCommandDelegate::CreateStatic(DumpShooterCounters)
+	);
+
+FAutoConsoleCommand CmdShowShooterCounters(
+	TEXT("Shooter.ShowCounters"),
+	TEXT("Toggles hot path counters overlay on HUD"),
+	FConsoleCommandDelegate::CreateStatic(ToggleShooterCounters)
+	);
+
+FShooterStatCounters& FShooterStatCounters::Get()
+{
+	static FShooterStatCounters Instance;
+	return Instance;
+}
+
+FShooterStatCounters::FShooterStatCounters()
+	: HistoryIndex(0)
+	, NumHistoryFrames(0)
+	, bShowOverlay(false)
+{
+	FMemory::Memzero(CurrentFrame, sizeof(CurrentFrame));
+	FMemory::Memzero(History, sizeof(History));
+	FMemory::Memzero(WindowSum, sizeof(WindowSum));
+	FMemory::Memzero(Totals, sizeof(Totals));
+}
+
+const TCHAR* FShooterStatCounters::GetCounterName(EShooterCounter::Type Counter)
+{
+	switch (Counter)
+	{
+		case EShooterCounter::WeaponTrace:		return TEXT("WeaponTrace");
+		case EShooterCounter::ProjectileSpawn:	return TEXT("ProjectileSpawn");
+		case EShooterCounter::ImpactEffect:		return TEXT("ImpactEffect");
+		case EShooterCounter::RankedMapRebuild:	return TEXT("RankedMapRebuild");
+		case EShooterCounter::BotLineOfSight:	return TEXT("BotLineOfSight");
+		case EShooterCounter::ReliableRPC:		return TEXT("ReliableRPC");
+		default:								return TEXT("Unknown");
+	}
+}
+
+bool FShooterStatCounters::Tick(float DeltaSeconds)
+{
+	for (int32 i = 0; i < EShooterCounter::MAX; i++)
+	{
+		WindowSum[i] += CurrentFrame[i] - History[i][HistoryIndex];
+		History[i][HistoryIndex] = CurrentFrame[i];
+		Totals[i] += CurrentFrame[i];
+		CurrentFrame[i] = 0;
+	}
+
+	HistoryIndex = (HistoryIndex + 1) % WindowSize;
+	NumHistoryFrames = FMath::Min(NumHistoryFrames + 1, WindowSize);
+
+	return true;
+}
+
+FShooterStatCounters::FCounterStats FShooterStatCounters::GetStats(EShooterCounter::Type Counter) const
+{
+	FCounterStats Stats;
+	Stats.LastFrame = History[Counter][(HistoryIndex + WindowSize - 1) % WindowSize];
+	Stats.Average = NumHistoryFrames > 0 ? (float)WindowSum[Counter] / NumHistoryFrames : 0.0f;
+	Stats.Total = Totals[Counter];
+
+	// only computed on demand, for overlay and dumps
+	Stats.Peak = 0;
+	for (int32 i = 0; i < NumHistoryFrames; i++)
+	{
+		Stats.Peak = FMath::Max(Stats.Peak, History[Counter][i]);
+	}
+
+	return Stats;
+}
+
+void FShooterStatCounters::DumpToLog() const
+{
+	UE_LOG(LogShooter, Log, TEXT("Hot path counters (last frame / avg / peak over %d frames / total):"), NumHistoryFrames);
+	for (int32 i = 0; i < EShooterCounter::MAX; i++)
+	{
+		const EShooterCounter::Type Counter = (EShooterCounter::Type)i;
+		const FCounterStats Stats = GetStats(Counter);
+		UE_LOG(LogShooter, Log, TEXT("  %-18s %6d %8.2f %6d %10llu"), GetCounterName(Counter), Stats.LastFrame, Stats.Average, Stats.Peak, Stats.Total);
+	}
+}
+
+bool FShooterStatCounters::IsOverlayVisible() const
+{
+	return bShowOverlay;
+}
+
+void FShooterStatCounters::ToggleOverlay()
+{
+	bShowOverlay = !bShowOverlay;
+}
@@ -0,0 +1,102 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+namespace EShooterCounter
+{
+	enum Type
+	{
+		WeaponTrace,
+		ProjectileSpawn,
+		ImpactEffect,
+		RankedMapRebuild,
+		BotLineOfSight,
+		ReliableRPC,
+		MAX,
+	};
+}
+
+/**
+ * Always-on hot path counters, cheap enough for shipping dedicated servers.
+ * Incrementing is a single array write; once per frame the core ticker rolls the counts into a rolling window.
+ *
+ * "Shooter.DumpCounters" writes current statistics to the log, "Shooter.ShowCounters" toggles the HUD overlay.
+ */
+class FShooterStatCounters : public FTickerObjectBase
+{
+public:
+
+	/** number of frames kept for rolling statistics */
+	static const int32 WindowSize = 120;
+
+	/** statistics for single counter */
+	struct FCounterStats
+	{
+		/** count in last completed frame */
+		int32 LastFrame;
+
+		/** average per frame over rolling window */
+		float Average;
+
+		/** highest single frame count in rolling window */
+		int32 Peak;
+
+		/** count since startup */
+		uint64 Total;
+	};
+
+	/** returns the counters */
+	static FShooterStatCounters& Get();
+
+	/** counts single event in current frame */
+	FORCEINLINE void Increment(EShooterCounter::Type Counter)
+	{
+		CurrentFrame[Counter]++;
+	}
+
+	/** returns statistics for counter */
+	FCounterStats GetStats(EShooterCounter::Type Counter) const;
+
+	/** returns display name of counter */
+	static const TCHAR* GetCounterName(EShooterCounter::Type Counter);
+
+	/** writes all statistics to the log */
+	void DumpToLog() const;
+
+	/** should HUD draw the overlay? */
+	bool IsOverlayVisible() const;
+
+	/** toggles HUD overlay */
+	void ToggleOverlay();
+
+	/** rolls current frame into the window */
+	virtual bool Tick(float DeltaSeconds) OVERRIDE;
+
+private:
+
+	FShooterStatCounters();
+
+	/** counts in frame being recorded */
+	int32 CurrentFrame[EShooterCounter::MAX];
+
+	/** counts of last WindowSize frames, ring buffer */
+	int32 History[EShooterCounter::MAX][WindowSize];
+
+	/** sum of History per counter */
+	int32 WindowSum[EShooterCounter::MAX];
+
+	/** count since startup */
+	uint64 Totals[EShooterCounter::MAX];
+
+	/** next History slot to write */
+	int32 HistoryIndex;
+
+	/** number of valid History entries */
+	int32 NumHistoryFrames;
+
+	/** HUD overlay on? */
+	bool bShowOverlay;
+};
+
+/** counts event for hot path counter */
+#define SHOOTER_COUNTER_INC(Counter) FShooterStatCounters::Get().Increment(EShooterCounter::Counter)
@@ -0,0 +1,174 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "ShooterAudioVoiceManager.h"
+#include "ShooterConfigSection.h"
+
+FShooterAudioVoiceManager::FShooterAudioVoiceManager()
+	: CachedFrame(MAX_uint64)
+{
+	static const TCHAR* CategoryNames[EShooterSoundCategory::MAX] = { TEXT("Weapon"), TEXT("Impact"), TEXT("Explosion"), TEXT("LowHealth") };
+	static const int32 DefaultMaxVoices[EShooterSoundCategory::MAX] = { 12, 8, 6, 1 };
+	static const float DefaultMaxDistance[EShooterSoundCategory::MAX] = { 10000.0f, 4000.0f, 12000.0f, 2000.0f };
+
+	const FShooterConfigSection Config(TEXT("ShooterGame.AudioVoices"));
+	for (int32 i = 0; i < EShooterSoundCategory::MAX; i++)
+	{
+		FCategoryVoices& Category = Categories[i];
+		Category.MaxVoices = DefaultMaxVoices[i];
+		Category.MaxDistance = DefaultMaxDistance[i];
+
+		Config.Get(*FString::Printf(TEXT("Max%sVoices"), CategoryNames[i]), Category.MaxVoices);
+		Config.Get(*FString::Printf(TEXT("%sMaxDistance"), CategoryNames[i]), Category.MaxDistance);
+	}
+}
+
+void FShooterAudioVoiceManager::ConditionalUpdateListeners(UWorld* World)
+{
+	if (CachedFrame == GFrameCounter)
+	{
+		return;
+	}
+
+	CachedFrame = GFrameCounter;
+	ListenerLocations.Reset();
+
+	for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+	{
+		APlayerController* PC = *It;
+		if (PC && PC->IsLocalController())
+		{
+			FVector ViewLocation;
+			FRotator ViewRotation;
+			PC->GetPlayerViewPoint(ViewLocation, ViewRotation);
+			ListenerLocations.Add(ViewLocation);
+		}
+	}
+}
+
+float FShooterAudioVoiceManager::GetListenerDistance(const FVector& Location) const
+{
+	float BestDistSq = MAX_FLT;
+	for (int32 i = 0; i < ListenerLocations.Num(); i++)
+	{
+		BestDistSq = FMath::Min(BestDistSq, FVector::DistSquared(Location, ListenerLocations[i]));
+	}
+
+	return BestDistSq < MAX_FLT ? FMath::Sqrt(BestDistSq) : MAX_FLT;
+}
+
+float FShooterAudioVoiceManager::GetPriority(const FVector& Location, bool bLocalSource) const
+{
+	// local player sounds always come first, everything else by distance
+	return bLocalSource ? 0.0f : -GetListenerDistance(Location);
+}
+
+bool FShooterAudioVoiceManager::ClaimVoice(UWorld* World, EShooterSoundCategory::Type Category, const FVector& Location, bool bLocalSource)
+{
+	if (World == NULL || World->GetNetMode() == NM_DedicatedServer || !GEngine->UseSound())
+	{
+		return false;
+	}
+
+	ConditionalUpdateListeners(World);
+
+	FCategoryVoices& CategoryVoices = Categories[Category];
+	if (!bLocalSource && GetListenerDistance(Location) > CategoryVoices.MaxDistance)
+	{
+		return false;
+	}
+
+	TArray<FVoice>& Voices = CategoryVoices.Voices;
+	for (int32 i = Voices.Num() - 1; i >= 0; i--)
+	{
+		UAudioComponent* AC = Voices[i].Component.Get();
+		if (AC == NULL || AC->IsPendingKill() || !AC->IsPlaying())
+		{
+			Voices.RemoveAt(i);
+		}
+	}
+
+	if (Voices.Num() < CategoryVoices.MaxVoices)
+	{
+		return true;
+	}
+
+	// category is full, find least important voice
+	const float NewPriority = GetPriority(Location, bLocalSource);
+	int32 WorstIndex = INDEX_NONE;
+	float WorstPriority = NewPriority;
+	for (int32 i = 0; i < Voices.Num(); i++)
+	{
+		UAudioComponent* AC = Voices[i].Component.Get();
+		const float VoicePriority = GetPriority(AC->GetComponentLocation(), Voices[i].bLocalSource);
+		if (VoicePriority < WorstPriority)
+		{
+			WorstPriority = VoicePriority;
+			WorstIndex = i;
+		}
+	}
+
+	// local sources all share the top priority, newest one replaces the oldest
+	if (WorstIndex == INDEX_NONE && bLocalSource)
+	{
+		for (int32 i = 0; i < Voices.Num(); i++)
+		{
+			if (Voices[i].bLocalSource)
+			{
+				WorstIndex = i;
+				break;
+			}
+		}
+	}
+
+	if (WorstIndex == INDEX_NONE)
+	{
+		return false;
+	}
+
+	Voices[WorstIndex].Component->Stop();
+	Voices.RemoveAt(WorstIndex);
+	return true;
+}
+
+void FShooterAudioVoiceManager::AddVoice(EShooterSoundCategory::Type Category, UAudioComponent* Component, bool bLocalSource)
+{
+	if (Component)
+	{
+		FVoice Voice;
+		Voice.Component = Component;
+		Voice.bLocalSource = bLocalSource;
+		Categories[Category].Voices.Add(Voice);
+	}
+}
+
+UAudioComponent* FShooterAudioVoiceManager::PlaySoundAtLocation(UWorld* World, EShooterSoundCategory::Type Category, USoundBase* Sound, const FVector& Location, bool bLocalSource)
+{
+	if (Sound == NULL || !ClaimVoice(World, Category, Location, bLocalSource))
+	{
+		return NULL;
+	}
+
+	UAudioComponent* AC = FAudioDevice::CreateComponent(Sound, World, NULL, false, false, &Location);
+	if (AC)
+	{
+		AC->bAutoDestroy = true;
+		AC->Play();
+		AddVoice(Category, AC, bLocalSource);
+	}
+
+	return AC;
+}
+
+UAudioComponent* FShooterAudioVoiceManager::PlaySoundAttached(EShooterSoundCategory::Type Category, USoundBase* Sound, USceneComponent* AttachTo, bool bLocalSource, bool bStopWhenAttachedToDestroyed)
+{
+	if (Sound == NULL || AttachTo == NULL || !ClaimVoice(AttachTo->GetWorld(), Category, AttachTo->GetComponentLocation(), bLocalSource))
+	{
+		return NULL;
+	}
+
+	UAudioComponent* AC = UGameplayStatics::PlaySoundAttached(Sound, AttachTo, NAME_None, FVector(ForceInit), EAttachLocation::KeepRelativeOffset, bStopWhenAttachedToDestroyed);
+	AddVoice(Category, AC, bLocalSource);
+
+	return AC;
+}
@@ -0,0 +1,85 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+namespace EShooterSoundCategory
+{
+	enum Type
+	{
+		Weapon,
+		Impact,
+		Explosion,
+		LowHealth,
+		MAX,
+	};
+}
+
+/**
+ * Limits concurrent gameplay sounds per category, one per world (owned by the game state).
+ * Sources of local players always win, others are ranked by distance to the closest local listener.
+ * When a category is full, a new sound either steals the least important voice or is dropped,
+ * local sources steal the oldest local voice if there is nothing less important.
+ *
+ * Limits are read from [ShooterGame.AudioVoices] in Game ini.
+ */
+class FShooterAudioVoiceManager
+{
+public:
+
+	FShooterAudioVoiceManager();
+
+	/** plays one shot sound at location, returns NULL when voice was dropped */
+	UAudioComponent* PlaySoundAtLocation(UWorld* World, EShooterSoundCategory::Type Category, USoundBase* Sound, const FVector& Location, bool bLocalSource = false);
+
+	/** plays sound attached to component, returns NULL when voice was dropped */
+	UAudioComponent* PlaySoundAttached(EShooterSoundCategory::Type Category, USoundBase* Sound, USceneComponent* AttachTo, bool bLocalSource = false, bool bStopWhenAttachedToDestroyed = false);
+
+private:
+
+	/** single playing voice */
+	struct FVoice
+	{
+		/** component playing the sound */
+		TWeakObjectPtr<UAudioComponent> Component;
+
+		/** played by local player? */
+		bool bLocalSource;
+	};
+
+	/** limits and playing voices for single category */
+	struct FCategoryVoices
+	{
+		/** max voices playing at once */
+		int32 MaxVoices;
+
+		/** non local sources further from all listeners are dropped */
+		float MaxDistance;
+
+		/** playing voices, oldest first */
+		TArray<FVoice> Voices;
+	};
+
+	/** makes room for new voice, stealing less important one if needed; false if sound should be dropped */
+	bool ClaimVoice(UWorld* World, EShooterSoundCategory::Type Category, const FVector& Location, bool bLocalSource);
+
+	/** tracks newly started voice */
+	void AddVoice(EShooterSoundCategory::Type Category, UAudioComponent* Component, bool bLocalSource);
+
+	/** higher is more important */
+	float GetPriority(const FVector& Location, bool bLocalSource) const;
+
+	/** distance from location to closest local listener */
+	float GetListenerDistance(const FVector& Location) const;
+
+	/** refreshes local listener locations once per frame */
+	void ConditionalUpdateListeners(UWorld* World);
+
+	/** voices per category */
+	FCategoryVoices Categories[EShooterSoundCategory::MAX];
+
+	/** local listener locations for current frame */
+	TArray<FVector> ListenerLocations;
+
+	/** frame number listeners were gathered in */
+	uint64 CachedFrame;
+};
@@ -7,25 +7,16 @@
 #include "ShooterMenuSoundsWidgetStyle.h"
 #include "ShooterGameKing.h"
 #include "Slate.h"
-#include "GenericPlatformChunkInstall.h"
+#include "ShooterContentAvailability.h"
+#include "ShooterPreloadManifest.h"
 
 #define LOCTEXT_NAMESPACE "ShooterGame.HUD.Menu"
 
 #define MAX_BOT_COUNT 8
 
-static const FString MapNames[] = { TEXT("Sanctuary"), TEXT("Highrise") };
-static const FName PackageNames[] = { TEXT("Sanctuary.umap"), TEXT("Highrise.umap") };
 static const int DefaultTDMMap = 1;
 static const int DefaultFFAMap = 0; 
 
-//use an EMap index, get back the ChunkIndex that map should be part of.
-//Instead of this mapping we should really use the AssetRegistry to query for chunk mappings, but maps aren't members of the AssetRegistry yet.
-#if PLATFORM_XBOXONE
-static const int ChunkMapping[] = { 1000, 1000 };
-#else
-static const int ChunkMapping[] = { 1, 2 };
-#endif
-
 FShooterMainMenu::~FShooterMainMenu()
 {
 
@@ -33,7 +24,6 @@ FShooterMainMenu::~FShooterMainMenu()
 
 void FShooterMainMenu::Construct(APlayerController* _PCOwner, AShooterGame_Menu* _SGOwner)
 {
-	bShowingDownloadPct = false;
 	PCOwner = _PCOwner;
 	SGOwner = _SGOwner;
 
@@ -56,9 +46,10 @@ void FShooterMainMenu::Construct(APlayerController* _PCOwner, AShooterGame_Menu*
 	}
 	
 	TArray<FText> MapList;
-	for (int32 i = 0; i < ARRAY_COUNT(MapNames); ++i)
+	const TArray<FShooterMapContent>& Maps = FShooterContentAvailability::Get().GetMaps();
+	for (int32 i = 0; i < Maps.Num(); ++i)
 	{
-		MapList.Add(FText::FromString(MapNames[i]));		
+		MapList.Add(FText::FromString(Maps[i].MapName));
 	}	
 
 	TArray<FText> OnOffList;
@@ -107,7 +98,7 @@ void FShooterMainMenu::Construct(APlayerController* _PCOwner, AShooterGame_Menu*
 		TSharedPtr<FShooterMenuItem> NumberOfBotsOption = MenuHelper::AddMenuOptionSP(PlaySubMenu, LOCTEXT("NumberOfBots", "NUMBER OF BOTS"), BotsCountList, this, &FShooterMainMenu::BotCountOptionChanged);
 		NumberOfBotsOption->SelectedMultiChoice = BotsCountOpt;
 
-		MapOption = MenuHelper::AddMenuOption(PlaySubMenu, LOCTEXT("SELECTED_LEVEL", "Map"), MapList);
+		MapOption = MenuHelper::AddMenuOptionSP(PlaySubMenu, LOCTEXT("SELECTED_LEVEL", "Map"), MapList, this, &FShooterMainMenu::MapOptionChanged);
 		MapOption->SelectedMultiChoice = DefaultTDMMap;
 
 #else
@@ -122,7 +113,7 @@ void FShooterMainMenu::Construct(APlayerController* _PCOwner, AShooterGame_Menu*
 		TSharedPtr<FShooterMenuItem> NumberOfBotsOption = MenuHelper::AddMenuOptionSP(MenuItem, LOCTEXT("NumberOfBots", "NUMBER OF BOTS"), BotsCountList, this, &FShooterMainMenu::BotCountOptionChanged);				
 		NumberOfBotsOption->SelectedMultiChoice = BotsCountOpt;																
 
-		MapOption = MenuHelper::AddMenuOption(MenuItem, LOCTEXT("SELECTED_LEVEL", "Map"), MapList);
+		MapOption = MenuHelper::AddMenuOptionSP(MenuItem, LOCTEXT("SELECTED_LEVEL", "Map"), MapList, this, &FShooterMainMenu::MapOptionChanged);
 
 		HostLANItem = MenuHelper::AddMenuOptionSP(MenuItem, LOCTEXT("LanMatch", "LAN"), OnOffList, this, &FShooterMainMenu::LanMatchChanged);
 		HostLANItem->SelectedMultiChoice = bIsLanMatch;
@@ -164,6 +155,12 @@ void FShooterMainMenu::Construct(APlayerController* _PCOwner, AShooterGame_Menu*
 		MenuWidget->MainMenu = MenuWidget->CurrentMenu = RootMenuItem->SubMenu;
 		MenuWidget->OnMenuHidden.BindSP(this, &FShooterMainMenu::OnMenuHidden);
 
+		// follow install state of maps and start fetching the one that's selected by default
+		FShooterContentAvailability& Content = FShooterContentAvailability::Get();
+		Content.OnMapContentChanged().AddSP(this, &FShooterMainMenu::OnMapContentChanged);
+		Content.PrioritizeMap((int32)GetSelectedMap());
+		OnMapContentChanged((int32)GetSelectedMap());
+
 		
 		ShooterOptions->UpdateOptions();
 		MenuWidget->BuildAndShowMenu();
@@ -190,52 +187,28 @@ void FShooterMainMenu::RemoveMenuFromGameViewport()
 	}
 }
 
-void FShooterMainMenu::Tick(float DeltaSeconds)
+void FShooterMainMenu::OnMapContentChanged(int32 MapIndex)
 {
-	IPlatformChunkInstall* ChunkInstaller = FPlatformMisc::GetPlatformChunkInstall();
-	if (ChunkInstaller)
+	if (MapIndex != (int32)GetSelectedMap())
 	{
-		EMap SelectedMap = GetSelectedMap();
-		// use assetregistry when maps are added to it.
-		int32 MapChunk = ChunkMapping[(int)SelectedMap];
-		EChunkLocation::Type ChunkLocation = ChunkInstaller->GetChunkLocation(MapChunk);
-
-		FText UpdatedText;
-		bool bUpdateText = false;
-		if (ChunkLocation == EChunkLocation::NotAvailable)
-		{			
-			float PercentComplete = FMath::Min(ChunkInstaller->GetChunkProgress(MapChunk, EChunkProgressReportingType::PercentageComplete), 100.0f);									
-			UpdatedText = FText::FromString(FString::Printf(TEXT("%s %4.0f%%"),*LOCTEXT("SELECTED_LEVEL", "Map").ToString(), PercentComplete));
-			bUpdateText = true;
-			bShowingDownloadPct = true;
-		}
-		else if (bShowingDownloadPct)
-		{
-			UpdatedText = LOCTEXT("SELECTED_LEVEL", "Map");			
-			bUpdateText = true;
-			bShowingDownloadPct = false;			
-		}
-
-		if (bUpdateText)
-		{
-			MapOption->SetText(UpdatedText);			
-		}
+		return;
 	}
-}
 
-bool FShooterMainMenu::IsTickable() const
-{
-	return true;
-}
-
-TStatId FShooterMainMenu::GetStatId() const
-{
-	RETURN_QUICK_DECLARE_CYCLE_STAT(FShooterMainMenu, STATGROUP_Tickables);
+	const FShooterContentAvailability& Content = FShooterContentAvailability::Get();
+	if (Content.IsMapReady(MapIndex))
+	{
+		MapOption->SetText(LOCTEXT("SELECTED_LEVEL", "Map"));
+	}
+	else
+	{
+		MapOption->SetText(FText::Format(LOCTEXT("SELECTED_LEVEL_DOWNLOADING", "Map {0}%"), FText::AsNumber(Content.GetMapPercentComplete(MapIndex))));
+	}
 }
 
-bool FShooterMainMenu::IsTickableWhenPaused() const
+void FShooterMainMenu::MapOptionChanged(TSharedPtr<FShooterMenuItem> MenuItem, int32 MultiOptionIndex)
 {
-	return true;
+	FShooterContentAvailability::Get().PrioritizeMap(MultiOptionIndex);
+	OnMapContentChanged(MultiOptionIndex);
 }
 
 void FShooterMainMenu::OnMenuHidden()
@@ -360,12 +333,14 @@ void FShooterMainMenu::HostFreeForAll()
 {
 	AShooterPlayerController_Menu* const ShooterPC = Cast<AShooterPlayerController_Menu>(PCOwner);
 	EMap SelectedMap = GetSelectedMap();
-	FString StartStr = FString::Printf(TEXT("/Game/Maps/%s?game=FFA?listen%s?%s=%d"), *MapNames[(int)SelectedMap], bIsLanMatch ? TEXT("?bIsLanMatch") : TEXT(""), *AShooterGameMode::GetBotsCountOptionName(), BotsCountOpt);
+	FString StartStr = FString::Printf(TEXT("/Game/Maps/%s?game=FFA?listen%s?%s=%d"), *FShooterContentAvailability::Get().GetMaps()[(int)SelectedMap].MapName, bIsLanMatch ? TEXT("?bIsLanMatch") : TEXT(""), *AShooterGameMode::GetBotsCountOptionName(), BotsCountOpt);
 
 	CreateSplitScreenPlayers();
 
 	if (ShooterPC != NULL && ShooterPC->CreateGame(LOCTEXT("FFA","FFA").ToString(), StartStr))
 	{		
+		FShooterPreloadManifest::Get().StartPreload(FShooterContentAvailability::Get().GetMaps()[(int)SelectedMap].MapName, AShooterGame_FreeForAll::StaticClass());
+
 		FSlateApplication::Get().SetFocusToGameViewport();
 		LockAndHideMenu();
 		DisplayLoadingScreen();
@@ -376,12 +351,14 @@ void FShooterMainMenu::HostTeamDeathMatch()
 {	
 	EMap SelectedMap = GetSelectedMap();
 	AShooterPlayerController_Menu * ShooterPC = Cast<AShooterPlayerController_Menu>(PCOwner);
-	FString StartStr = FString::Printf(TEXT("/Game/Maps/%s?game=TDM?listen%s?%s=%d"), *MapNames[(int)SelectedMap], bIsLanMatch ? TEXT("?bIsLanMatch") : TEXT(""), *AShooterGameMode::GetBotsCountOptionName(), BotsCountOpt);
+	FString StartStr = FString::Printf(TEXT("/Game/Maps/%s?game=TDM?listen%s?%s=%d"), *FShooterContentAvailability::Get().GetMaps()[(int)SelectedMap].MapName, bIsLanMatch ? TEXT("?bIsLanMatch") : TEXT(""), *AShooterGameMode::GetBotsCountOptionName(), BotsCountOpt);
 	
 	CreateSplitScreenPlayers();
 
 	if (ShooterPC != NULL && ShooterPC->CreateGame(LOCTEXT("TDM","TDM").ToString(), StartStr))
 	{		
+		FShooterPreloadManifest::Get().StartPreload(FShooterContentAvailability::Get().GetMaps()[(int)SelectedMap].MapName, AShooterGame_TeamDeathMatch::StaticClass());
+
 		// Set presence for playing in a map
 		if(ShooterPC->PlayerState && ShooterPC->PlayerState->UniqueId.IsValid())
 		{
@@ -472,20 +449,7 @@ void FShooterMainMenu::UpdateMenuOwner()
 
 bool FShooterMainMenu::IsMapReady() const
 {
-	bool bReady = true;
-	IPlatformChunkInstall* ChunkInstaller = FPlatformMisc::GetPlatformChunkInstall();
-	if (ChunkInstaller)
-	{
-		EMap SelectedMap = GetSelectedMap();
-		// should use the AssetRegistry as soon as maps are added to the AssetRegistry
-		int32 MapChunk = ChunkMapping[(int)SelectedMap];
-		EChunkLocation::Type ChunkLocation = ChunkInstaller->GetChunkLocation(MapChunk);
-		if (ChunkLocation == EChunkLocation::NotAvailable)
-		{			
-			bReady = false;
-		}
-	}
-	return bReady;
+	return FShooterContentAvailability::Get().IsMapReady((int32)GetSelectedMap());
 }
 
 UShooterPersistentUser* FShooterMainMenu::GetPersistentUser() const
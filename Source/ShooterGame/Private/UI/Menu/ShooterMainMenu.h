@@ -10,7 +10,7 @@
 #include "ShooterGameKing.h"
 
 
-class FShooterMainMenu : public TSharedFromThis<FShooterMainMenu>, public FTickableGameObject
+class FShooterMainMenu : public TSharedFromThis<FShooterMainMenu>
 {
 public:	
 
@@ -25,13 +25,6 @@ public:
 	/** Remove from the gameviewport. */
 	void RemoveMenuFromGameViewport();	
 
-	/** TickableObject Functions */
-	virtual void Tick(float DeltaTime) OVERRIDE;	
-	virtual bool IsTickable() const OVERRIDE;	
-	virtual TStatId GetStatId() const OVERRIDE;
-	virtual bool IsTickableWhenPaused() const OVERRIDE;	
-
-
 protected:
 
 	enum class EMap
@@ -84,11 +77,14 @@ protected:
 	/** Map selection widget */
 	TSharedPtr<FShooterMenuItem> MapOption;
 
-	/** Track if we are showing a map download pct or not. */
-	bool bShowingDownloadPct;
-
 	EMap GetSelectedMap() const;
 
+	/** updates map option text when install state of selected map changes */
+	void OnMapContentChanged(int32 MapIndex);
+
+	/** map option changed callback, prefetches newly selected map */
+	void MapOptionChanged(TSharedPtr<FShooterMenuItem> MenuItem, int32 MultiOptionIndex);
+
 	/** goes back in menu structure */
 	void CloseSubMenu();
 
@@ -19,7 +19,7 @@ void FShooterOptions::Construct(APlayerController* _PCOwner)
 	TArray<FText> OnOffList;
 	TArray<FText> SensitivityList;
 	TArray<FText> GammaList;
-	TArray<FText> LowHighList;
+	TArray<FText> QualityList;
 
 	FDisplayMetrics DisplayMetrics;
 	FSlateApplication::Get().GetInitialDisplayMetrics(DisplayMetrics);
@@ -48,8 +48,9 @@ void FShooterOptions::Construct(APlayerController* _PCOwner)
 	OnOffList.Add(LOCTEXT("Off","OFF"));
 	OnOffList.Add(LOCTEXT("On","ON"));
 
-	LowHighList.Add(LOCTEXT("Low","LOW"));
-	LowHighList.Add(LOCTEXT("High","HIGH"));
+	QualityList.Add(LOCTEXT("Low","LOW"));
+	QualityList.Add(LOCTEXT("High","HIGH"));
+	QualityList.Add(LOCTEXT("Auto","AUTO"));
 
 	//Mouse sensitivity 0-50
 	for (int32 i = 0; i < 51; i++)
@@ -77,7 +78,7 @@ void FShooterOptions::Construct(APlayerController* _PCOwner)
 	OptionsItem = MenuHelper::AddMenuItem(OptionsRoot,LOCTEXT("Options", "OPTIONS"));
 #if PLATFORM_DESKTOP
 	VideoResolutionOption = MenuHelper::AddMenuOptionSP(OptionsItem,LOCTEXT("Resolution", "RESOLUTION"), ResolutionList, this, &FShooterOptions::VideoResolutionOptionChanged);
-	GraphicsQualityOption = MenuHelper::AddMenuOptionSP(OptionsItem,LOCTEXT("Quality", "QUALITY"),LowHighList, this, &FShooterOptions::GraphicsQualityOptionChanged);
+	GraphicsQualityOption = MenuHelper::AddMenuOptionSP(OptionsItem,LOCTEXT("Quality", "QUALITY"),QualityList, this, &FShooterOptions::GraphicsQualityOptionChanged);
 	FullScreenOption = MenuHelper::AddMenuOptionSP(OptionsItem,LOCTEXT("FullScreen", "FULL SCREEN"),OnOffList, this, &FShooterOptions::FullScreenOptionChanged);
 #endif
 	GammaOption = MenuHelper::AddMenuOptionSP(OptionsItem,LOCTEXT("Gamma", "GAMMA CORRECTION"),GammaList, this, &FShooterOptions::GammaOptionChanged);
@@ -5,6 +5,7 @@
 #include "SHeaderRow.h"
 #include "ShooterStyle.h"
 #include "ShooterGameLoadingScreen.h"
+#include "ShooterPreloadManifest.h"
 
 #define LOCTEXT_NAMESPACE "ShooterGame.HUD.Menu"
 
@@ -253,6 +254,9 @@ void SShooterServerList::ConnectToServer()
 				LoadingScreenModule->StartInGameLoadingScreen();
 			}
 
+			// map isn't known until travel, stream the shared gameplay assets
+			FShooterPreloadManifest::Get().StartPreload(FString(), AShooterGameMode::StaticClass());
+
 			Game->JoinSession(PCOwner.Get(), ServerToJoin);
 		}
 	}
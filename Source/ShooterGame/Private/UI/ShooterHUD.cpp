@@ -1,8 +1,12 @@
 // Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
 
 #include "ShooterGame.h"
+#include "ShooterStatCounters.h"
+#include "ShooterHUDSnapshot.h"
 #include "SShooterScoreboardWidget.h"
 #include "SChatWidget.h"
+#include "Player/ShooterKillCamPlayback.h"
+#include "Online/ShooterKillFeed.h"
 
 #define LOCTEXT_NAMESPACE "ShooterGame.HUD.Menu"
 
@@ -90,17 +94,6 @@ EShooterMatchState::Type AShooterHUD::GetMatchState() const
 	return MatchState;
 }
 
-FString AShooterHUD::GetTimeString(float TimeSeconds)
-{
-	// only minutes and seconds are relevant
-	const int32 TotalSeconds = FMath::Max(0, FMath::TruncToInt(TimeSeconds) % 3600);
-	const int32 NumMinutes = TotalSeconds / 60;
-	const int32 NumSeconds = TotalSeconds % 60;
-
-	const FString TimeDesc = FString::Printf(TEXT("%02d:%02d"), NumMinutes, NumSeconds);
-	return TimeDesc;
-}
-
 void AShooterHUD::DrawWeaponHUD()
 {
 	AShooterCharacter* MyPawn = CastChecked<AShooterCharacter>(GetOwningPawn());
@@ -321,17 +314,17 @@ void AShooterHUD::DrawMatchTimerAndPosition()
 		FString Text;
 		TextItem.FontRenderInfo = ShadowedFont;
 		TextItem.Scale = FVector2D( TextScale*ScaleUI, TextScale*ScaleUI );
+		const FShooterHUDSnapshot& Snapshot = MyGameState->GetHUDSnapshot();
 		if (MyGameState->GetMatchState() == MatchState::WaitingToStart)
 		{
 			TextItem.Scale = FVector2D( ScaleUI, ScaleUI );
-			Text = LOCTEXT("WarmupString","MATCH STARTS IN: ").ToString() + FString::FromInt(MyGameState->RemainingTime);
 			TextItem.SetColor( HUDLight );
-			TextItem.Text = FText::FromString( Text );			
+			TextItem.Text = FText::FromString( Snapshot.GetWarmupText() );			
 			AddMatchInfoString(TextItem);
 		}
 		else if (MyGameState->GetMatchState() == MatchState::InProgress)
 		{
-			Text = GetTimeString(MyGameState->RemainingTime);
+			Text = Snapshot.GetTimerText();
 			Canvas->StrLen(BigFont, Text, SizeX, SizeY);
 
 			TextItem.SetColor( HUDDark );
@@ -351,24 +344,11 @@ void AShooterHUD::DrawMatchTimerAndPosition()
 			{
 				if (MyGameState->NumTeams > 1) // team based game
 				{
-					int32 MyTeam = MyPlayerState->GetTeamNum();
-					int32 MyPos = FMath::Max(1, MyGameState->TeamScores.Num());
-					for (int32 i=0; i < MyGameState->TeamScores.Num(); i++)
-					{
-						if (MyGameState->TeamScores.Num() > MyTeam &&
-							MyGameState->TeamScores[MyTeam] >= MyGameState->TeamScores[i] && MyTeam != i)
-						{
-							MyPos--;
-						}
-					}
-					Text = FString::Printf(TEXT("%d/%d"), MyPos, MyGameState->NumTeams);
+					Text = FString::Printf(TEXT("%d/%d"), Snapshot.GetTeamPosition(MyPlayerState->GetTeamNum()), MyGameState->NumTeams);
 				}
 				else // free for all
 				{
-					RankedPlayerMap PlayerStateMap;
-					MyGameState->GetRankedMap(0,PlayerStateMap);
-					int32 MyPos = *PlayerStateMap.FindKey(MyPlayerState) + 1;
-					Text = FString::Printf(TEXT("%d/%d"), MyPos, PlayerStateMap.Num());
+					Text = FString::Printf(TEXT("%d/%d"), Snapshot.GetPlayerPosition(MyPlayerState), Snapshot.GetNumRankedPlayers());
 				}
 				Canvas->StrLen(BigFont, Text, SizeX, SizeY);
 				Canvas->DrawIcon(PlaceIcon,
@@ -495,6 +475,7 @@ void AShooterHUD::DrawHUD()
 		DrawDebugInfoString(NetModeDesc, Canvas->OrgX + Offset*ScaleUI, Canvas->OrgY + 5*Offset*ScaleUI, true, true, HUDLight);
 	}
 
+	DrawStatCounters();
 	DrawMatchTimerAndPosition();
 
 	float MessageOffset = (Canvas->ClipY / 4.0)* ScaleUI;
@@ -513,8 +494,11 @@ void AShooterHUD::DrawHUD()
 		}
 		else
 		{
+			DrawKillCam();
+
 			// respawn
-			FString Text = LOCTEXT("WaitingForRespawn", "WAITING FOR RESPAWN").ToString();
+			const bool bKillCam = MyPC && MyPC->GetKillCamPlayback();
+			FString Text = bKillCam ? LOCTEXT("KillCam", "KILL CAM").ToString() : LOCTEXT("WaitingForRespawn", "WAITING FOR RESPAWN").ToString();
 			FCanvasTextItem TextItem( FVector2D::ZeroVector, FText::GetEmpty(), BigFont, HUDDark );
 			TextItem.EnableShadow( FLinearColor::Black );
 			TextItem.Text = FText::FromString( Text );
@@ -555,6 +539,84 @@ void AShooterHUD::DrawHUD()
 	
 }
 
+void AShooterHUD::DrawKillCam()
+{
+	AShooterPlayerController* MyPC = Cast<AShooterPlayerController>(PlayerOwner);
+	const FShooterKillCamPlayback* Playback = MyPC ? MyPC->GetKillCamPlayback() : NULL;
+	if (Playback == NULL)
+	{
+		return;
+	}
+
+	TArray<FShooterKillCamPlayback::FShotView> Shots;
+	Playback->GetShotViews(Shots);
+	for (int32 i = 0; i < Shots.Num(); i++)
+	{
+		const FVector Start = Canvas->Project(Shots[i].Start);
+		const FVector End = Canvas->Project(Shots[i].End);
+		if (Start.Z > 0.0f && End.Z > 0.0f)
+		{
+			FCanvasLineItem LineItem(FVector2D(Start.X, Start.Y), FVector2D(End.X, End.Y));
+			LineItem.SetColor(FLinearColor(1.0f, 0.8f, 0.3f, Shots[i].Alpha));
+			Canvas->DrawItem(LineItem);
+		}
+	}
+
+	const FShooterKillCamClip& Clip = Playback->GetClip();
+	const TArray<FShooterKillCamPlayback::FPawnView>& PawnViews = Playback->GetPawnViews();
+	for (int32 i = 0; i < PawnViews.Num(); i++)
+	{
+		const FShooterKillCamActor& Actor = Clip.Actors[i];
+		const FVector ScreenPos = PawnViews[i].bVisible ? Canvas->Project(PawnViews[i].Location + FVector(0.0f, 0.0f, 100.0f)) : FVector::ZeroVector;
+		if (ScreenPos.Z <= 0.0f)
+		{
+			continue;
+		}
+
+		FString Name = Actor.PlayerState ? Actor.PlayerState->GetShortPlayerName() : FString();
+		if (Actor.bVictim)
+		{
+			Name = LOCTEXT("KillCamYou", "YOU").ToString();
+		}
+
+		float SizeX, SizeY;
+		Canvas->StrLen(NormalFont, Name, SizeX, SizeY);
+
+		FCanvasTextItem TextItem(FVector2D(ScreenPos.X - SizeX * 0.5f * ScaleUI, ScreenPos.Y - SizeY * ScaleUI), FText::FromString(Name), NormalFont, HUDLight);
+		TextItem.EnableShadow(FLinearColor::Black);
+		TextItem.Scale = FVector2D(ScaleUI, ScaleUI);
+		TextItem.FontRenderInfo = ShadowedFont;
+		TextItem.SetColor(Actor.bKiller ? FLinearColor(0.75f, 0.125f, 0.125f) : FLinearColor(HUDLight));
+		Canvas->DrawItem(TextItem);
+	}
+}
+
+void AShooterHUD::DrawStatCounters()
+{
+#if !UE_BUILD_SHIPPING
+	const FShooterStatCounters& Counters = FShooterStatCounters::Get();
+	if (!Counters.IsOverlayVisible())
+	{
+		return;
+	}
+
+	float SizeX, SizeY;
+	Canvas->StrLen(NormalFont, TEXT("0"), SizeX, SizeY);
+	const float LineHeight = (SizeY + 12.0f) * ScaleUI;
+
+	float PosY = Canvas->OrgY + 10 * Offset * ScaleUI;
+	for (int32 i = 0; i < EShooterCounter::MAX; i++)
+	{
+		const EShooterCounter::Type Counter = (EShooterCounter::Type)i;
+		const FShooterStatCounters::FCounterStats Stats = Counters.GetStats(Counter);
+		const FString Line = FString::Printf(TEXT("%s: %d  avg %.1f  peak %d"), FShooterStatCounters::GetCounterName(Counter), Stats.LastFrame, Stats.Average, Stats.Peak);
+
+		DrawDebugInfoString(Line, Canvas->OrgX + Offset * ScaleUI, PosY, true, true, HUDLight);
+		PosY += LineHeight;
+	}
+#endif
+}
+
 void AShooterHUD::DrawDebugInfoString(const FString& Text, float PosX, float PosY, bool bAlignLeft, bool bAlignTop, const FColor& TextColor)
 {
 #if !UE_BUILD_SHIPPING
@@ -671,10 +733,13 @@ void AShooterHUD::DrawCrosshair()
 
 void AShooterHUD::DrawDeathMessages()
 {
-	if (PlayerOwner == NULL)
+	AShooterGameState* const MyGameState = Cast<AShooterGameState>(GetWorld()->GameState);
+	if (PlayerOwner == NULL || MyGameState == NULL)
 	{
 		return;
 	}
+	const AShooterPlayerState* MyPlayerState = Cast<AShooterPlayerState>(PlayerOwner->PlayerState);
+	FShooterKillFeed& KillFeed = MyGameState->GetKillFeed();
 	
 	float OffsetX = 20;
 	float OffsetY = 20;
@@ -689,9 +754,8 @@ void AShooterHUD::DrawDeathMessages()
 
 	const FColor BlueTeamColor = FColor(70, 70, 152, 255);
 	const FColor RedTeamColor = FColor(152, 70, 70, 255);
-	const FColor OwnerColor = HUDLight;
 
-	const FString KilledText = LOCTEXT("killed"," killed ").ToString();
+	const FText KilledText = LOCTEXT("killed"," killed ");
 	FVector2D KilledTextSize(0.0f, 0.0f);
 
 	const float GameTime = GetWorld()->GetTimeSeconds();
@@ -704,25 +768,32 @@ void AShooterHUD::DrawDeathMessages()
 	// draw messages
 	float CurrentY = InitialY;
 
-	Canvas->StrLen(NormalFont, KilledText, KilledTextSize.X, KilledTextSize.Y);
+	Canvas->StrLen(NormalFont, KilledText.ToString(), KilledTextSize.X, KilledTextSize.Y);
 
 	FCanvasTextItem TextItem( FVector2D::ZeroVector, FText::GetEmpty(), NormalFont, HUDDark );
 	TextItem.EnableShadow( FLinearColor::Black );
-	for (int32 i = DeathMessages.Num() - 1; i >= 0; i--)
+	for (int32 Age = 0; Age < KillFeed.Num(); Age++)
 	{
-		const FDeathMessage& Message = DeathMessages[i];
+		FShooterKillFeedEntry& Message = KillFeed.GetEntry(Age);
 		float CurrentX = InitialX;
-		FVector2D KillerSize(0.0f, 0.0f);
-		FVector2D VictimNameSize(0.0f, 0.0f);
 		float TextScale = 1.00f;
-		Canvas->StrLen(NormalFont, Message.KillerDesc, KillerSize.X, KillerSize.Y);
+
+		// names only change when a new kill comes in, measure them once
+		if (Message.MeasuredFont != NormalFont)
+		{
+			Canvas->StrLen(NormalFont, Message.KillerDesc, Message.KillerSize.X, Message.KillerSize.Y);
+			Canvas->StrLen(NormalFont, Message.VictimDesc, Message.VictimSize.X, Message.VictimSize.Y);
+			Message.MeasuredFont = NormalFont;
+		}
+
 		TextItem.Scale = FVector2D( TextScale * ScaleUI, TextScale * ScaleUI );
 		TextItem.FontRenderInfo = ShadowedFont;
-		TextItem.SetColor(Message.bKillerIsOwner == true ? HUDLight : ( Message.KillerTeamNum == 0 ? RedTeamColor : BlueTeamColor));
+		const bool bKillerIsOwner = MyPlayerState && Message.KillerPlayerState.Get() == MyPlayerState;
+		TextItem.SetColor(bKillerIsOwner ? HUDLight : ( Message.KillerTeamNum == 0 ? RedTeamColor : BlueTeamColor));
 
-		TextItem.Text = FText::FromString( Message.KillerDesc );
+		TextItem.Text = Message.KillerText;
 		Canvas->DrawItem(TextItem, CurrentX, CurrentY);
-		CurrentX += KillerSize.X * TextScale * ScaleUI;
+		CurrentX += Message.KillerSize.X * TextScale * ScaleUI;
 		
 		if (Message.DamageType.IsValid())
 		{
@@ -735,7 +806,7 @@ void AShooterHUD::DrawDeathMessages()
 		}
 		else
 		{
-			TextItem.Text = FText::FromString( KilledText );
+			TextItem.Text = KilledText;
 			TextItem.Scale = FVector2D( TextScale * ScaleUI, TextScale * ScaleUI );
 			TextItem.FontRenderInfo = ShadowedFont;
 			TextItem.SetColor(HUDDark);
@@ -744,10 +815,10 @@ void AShooterHUD::DrawDeathMessages()
 			CurrentX += KilledTextSize.X * TextScale * ScaleUI;
 		}
 			
-		TextItem.SetColor(Message.bVictimIsOwner == true ? HUDLight : (Message.VictimTeamNum == 0 ? RedTeamColor : BlueTeamColor));		
+		const bool bVictimIsOwner = MyPlayerState && Message.VictimPlayerState.Get() == MyPlayerState;
+		TextItem.SetColor(bVictimIsOwner ? HUDLight : (Message.VictimTeamNum == 0 ? RedTeamColor : BlueTeamColor));		
 
-		Canvas->StrLen(NormalFont, Message.VictimDesc, VictimNameSize.X, VictimNameSize.Y);
-		TextItem.Text = FText::FromString( Message.VictimDesc );
+		TextItem.Text = Message.VictimText;
 		Canvas->DrawItem( TextItem, CurrentX, CurrentY );
 		CurrentY -= (KilledTextSize.Y + LinePadding) * TextScale * ScaleUI;
 	}
@@ -755,37 +826,19 @@ void AShooterHUD::DrawDeathMessages()
 
 void AShooterHUD::ShowDeathMessage(class AShooterPlayerState* KillerPlayerState, class AShooterPlayerState* VictimPlayerState, const UDamageType* KillerDamageType)
 {
-	const int32 MaxDeathMessages = 5;
-	const float MessageDuration = 10.0f;
-
-	if (GetWorld()->GameState && GetWorld()->GameState->GameModeClass)
+	AShooterGameState* const MyGameState = Cast<AShooterGameState>(GetWorld()->GameState);
+	if (MyGameState && MyGameState->GameModeClass)
 	{
-		const AShooterGameMode* DefGame = GetWorld()->GameState->GameModeClass->GetDefaultObject<AShooterGameMode>();
+		const AShooterGameMode* DefGame = MyGameState->GameModeClass->GetDefaultObject<AShooterGameMode>();
 		AShooterPlayerState* MyPlayerState = PlayerOwner ? Cast<AShooterPlayerState>(PlayerOwner->PlayerState) : NULL;
 
+		// kill feed itself is shared by all local players and filled by the game state
 		if (DefGame && KillerPlayerState && VictimPlayerState && MyPlayerState)
 		{
-			if (DeathMessages.Num() >= MaxDeathMessages)
-			{
-				DeathMessages.RemoveAt(0, 1, false);
-			}
-
-			FDeathMessage NewMessage;
-			NewMessage.KillerDesc = KillerPlayerState->GetShortPlayerName();
-			NewMessage.VictimDesc = VictimPlayerState->GetShortPlayerName();
-			NewMessage.KillerTeamNum = KillerPlayerState->GetTeamNum();
-			NewMessage.VictimTeamNum = VictimPlayerState->GetTeamNum();
-			NewMessage.bKillerIsOwner = MyPlayerState == KillerPlayerState;
-			NewMessage.bVictimIsOwner = MyPlayerState == VictimPlayerState;
-
-			NewMessage.DamageType = Cast<const UShooterDamageType>(KillerDamageType);
-			NewMessage.HideTime = GetWorld()->GetTimeSeconds() + MessageDuration;
-
-			DeathMessages.Add(NewMessage);
 			if (KillerPlayerState == MyPlayerState && VictimPlayerState != MyPlayerState)
 			{
 				LastKillTime = GetWorld()->GetTimeSeconds();
-				CenteredKillMessage = FText::FromString(NewMessage.VictimDesc);
+				CenteredKillMessage = FText::FromString(VictimPlayerState->GetShortPlayerName());
 			}
 		}
 	}
@@ -0,0 +1,73 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "ShooterHUDSnapshot.h"
+
+#define LOCTEXT_NAMESPACE "ShooterGame.HUD.Menu"
+
+FShooterHUDSnapshot::FShooterHUDSnapshot()
+	: LastUpdateFrame(0)
+	, TimerSeconds(-1)
+{
+}
+
+void FShooterHUDSnapshot::Update(AShooterGameState* GameState)
+{
+	if (LastUpdateFrame == GFrameCounter)
+	{
+		return;
+	}
+	LastUpdateFrame = GFrameCounter;
+
+	// timer text only changes once per second
+	if (GameState->RemainingTime != TimerSeconds)
+	{
+		TimerSeconds = GameState->RemainingTime;
+
+		// only minutes and seconds are relevant
+		const int32 TotalSeconds = FMath::Max(0, TimerSeconds % 3600);
+		TimerText = FString::Printf(TEXT("%02d:%02d"), TotalSeconds / 60, TotalSeconds % 60);
+		WarmupText = LOCTEXT("WarmupString","MATCH STARTS IN: ").ToString() + FString::FromInt(TimerSeconds);
+	}
+
+	PlayerPositions.Reset();
+	TeamPositions.Reset();
+	if (GameState->NumTeams > 1)
+	{
+		const TArray<int32>& TeamScores = GameState->TeamScores;
+		for (int32 TeamNum = 0; TeamNum < TeamScores.Num(); TeamNum++)
+		{
+			int32 Pos = TeamScores.Num();
+			for (int32 i = 0; i < TeamScores.Num(); i++)
+			{
+				if (TeamScores[TeamNum] >= TeamScores[i] && TeamNum != i)
+				{
+					Pos--;
+				}
+			}
+			TeamPositions.Add(Pos);
+		}
+	}
+	else
+	{
+		RankedPlayerMap PlayerStateMap;
+		GameState->GetRankedMap(0, PlayerStateMap);
+		for (RankedPlayerMap::TConstIterator It(PlayerStateMap); It; ++It)
+		{
+			PlayerPositions.Add(It.Value().Get(), It.Key() + 1);
+		}
+	}
+}
+
+int32 FShooterHUDSnapshot::GetPlayerPosition(const AShooterPlayerState* PlayerState) const
+{
+	const int32* Pos = PlayerPositions.Find(PlayerState);
+	return Pos ? *Pos : 0;
+}
+
+int32 FShooterHUDSnapshot::GetTeamPosition(int32 TeamNum) const
+{
+	return TeamPositions.IsValidIndex(TeamNum) ? TeamPositions[TeamNum] : FMath::Max(1, TeamPositions.Num());
+}
+
+#undef LOCTEXT_NAMESPACE
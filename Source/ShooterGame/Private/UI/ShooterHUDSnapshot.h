@@ -0,0 +1,61 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+/**
+ * HUD data shared by all local players, built once per world tick.
+ * In split-screen every AShooterHUD draws from the same snapshot and only computes elements specific to its view.
+ */
+class FShooterHUDSnapshot
+{
+public:
+
+	FShooterHUDSnapshot();
+
+	/** rebuilds shared data, does nothing if already done in this frame */
+	void Update(class AShooterGameState* GameState);
+
+	/** returns match timer as MM:SS */
+	const FString& GetTimerText() const
+	{
+		return TimerText;
+	}
+
+	/** returns warmup countdown message */
+	const FString& GetWarmupText() const
+	{
+		return WarmupText;
+	}
+
+	/** returns 1-based position of player in free for all, 0 if not ranked */
+	int32 GetPlayerPosition(const class AShooterPlayerState* PlayerState) const;
+
+	/** returns number of players ranked in free for all */
+	int32 GetNumRankedPlayers() const
+	{
+		return PlayerPositions.Num();
+	}
+
+	/** returns 1-based position of team */
+	int32 GetTeamPosition(int32 TeamNum) const;
+
+private:
+
+	/** frame of last update */
+	uint64 LastUpdateFrame;
+
+	/** seconds TimerText and WarmupText were built for */
+	int32 TimerSeconds;
+
+	/** match timer */
+	FString TimerText;
+
+	/** warmup countdown */
+	FString WarmupText;
+
+	/** free for all positions */
+	TMap<const class AShooterPlayerState*, int32> PlayerPositions;
+
+	/** team positions, indexed by team number */
+	TArray<int32> TeamPositions;
+};
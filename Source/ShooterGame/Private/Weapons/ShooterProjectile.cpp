@@ -1,6 +1,7 @@
 // Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
 
 #include "ShooterGame.h"
+#include "Bots/ShooterPerceptionBus.h"
 
 AShooterProjectile::AShooterProjectile(const class FPostConstructInitializeProperties& PCIP) : Super(PCIP)
 {
@@ -80,9 +81,16 @@ void AShooterProjectile::Explode(const FHitResult& Impact)
 	// effects and damage origin shouldn't be placed inside mesh at impact point
 	const FVector NudgedImpactLocation = Impact.ImpactPoint + Impact.ImpactNormal * 10.0f;
 
-	if (WeaponConfig.ExplosionDamage > 0 && WeaponConfig.ExplosionRadius > 0 && WeaponConfig.DamageType)
+	AShooterGameMode* const GameMode = GetWorld()->GetAuthGameMode<AShooterGameMode>();
+	if (GameMode && WeaponConfig.ExplosionDamage > 0 && WeaponConfig.ExplosionRadius > 0 && WeaponConfig.DamageType)
 	{
-		UGameplayStatics::ApplyRadialDamage(this, WeaponConfig.ExplosionDamage, NudgedImpactLocation, WeaponConfig.ExplosionRadius, WeaponConfig.DamageType, TArray<AActor*>(), this, MyController.Get());
+		GameMode->ApplyExplosionDamage(WeaponConfig.ExplosionDamage, NudgedImpactLocation, WeaponConfig.ExplosionRadius, WeaponConfig.DamageType, this, MyController.Get());
+	}
+
+	if (GameMode)
+	{
+		AController* InstigatorController = MyController.Get();
+		GameMode->GetPerceptionBus().Post(EShooterStimulus::Explosion, NudgedImpactLocation, InstigatorController ? InstigatorController->GetPawn() : Instigator);
 	}
 
 	if (ExplosionTemplate)
@@ -1,6 +1,215 @@
 // Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
 
 #include "ShooterGame.h"
+#include "ShooterStatCounters.h"
+#include "Sound/ShooterAudioVoiceManager.h"
+#include "Online/ShooterNetAccounting.h"
+#include "Online/ShooterKillCamRecorder.h"
+#include "Bots/ShooterPerceptionBus.h"
+#include "ShooterWeaponRegistry.h"
+#include "ShooterConfigSection.h"
+#include "ShooterDevHelper.h"
+
+/** fire burst protocol tuning, read from [ShooterGame.FireProtocol] of the Game ini */
+struct FShooterFireProtocolConfig
+{
+	/** shots collected before batch is sent */
+	int32 ShotsPerBatch;
+
+	/** max time shot waits for its batch, also interval of resends */
+	float BatchInterval;
+
+	/** max shots in single batch, older unacknowledged shots go first */
+	int32 MaxShotsPerBatch;
+
+	/** how much earlier than weapon cadence allows shot can arrive on server (s) */
+	float CadenceTolerance;
+
+	FShooterFireProtocolConfig()
+		: ShotsPerBatch(4)
+		, BatchInterval(0.1f)
+		, MaxShotsPerBatch(16)
+		, CadenceTolerance(0.1f)
+	{
+		const FShooterConfigSection Config(TEXT("ShooterGame.FireProtocol"));
+		Config.Get(TEXT("ShotsPerBatch"), ShotsPerBatch);
+		Config.Get(TEXT("BatchInterval"), BatchInterval);
+		Config.Get(TEXT("MaxShotsPerBatch"), MaxShotsPerBatch);
+		Config.Get(TEXT("CadenceTolerance"), CadenceTolerance);
+	}
+};
+
+static const FShooterFireProtocolConfig& GetFireProtocolConfig()
+{
+	static FShooterFireProtocolConfig Config;
+	return Config;
+}
+
+#if !UE_BUILD_SHIPPING
+struct FShooterWeaponTest
+{
+	/** returns authority weapon of test pawn */
+	static AShooterWeapon* GetWeapon()
+	{
+		AShooterCharacter* Pawn = ShooterDevHelper::GetTestPawn(ShooterDevHelper::GetWorld());
+		AShooterWeapon* Weapon = Pawn ? Pawn->GetWeapon() : NULL;
+		if (Weapon == NULL || Weapon->Role < ROLE_Authority)
+		{
+			UE_LOG(LogShooterWeapon, Log, TEXT("No weapon with authority, run in standalone or on the listen server"));
+			return NULL;
+		}
+		return Weapon;
+	}
+
+	/** opens burst of owning client on server as if it started Seconds ago, returns its shots */
+	static void StartBurst(AShooterWeapon* Weapon, float Seconds, int32 NumShots, TArray<FWeaponShotResult>& OutShots)
+	{
+		Weapon->FireBurstId++;
+		Weapon->bServerBurstActive = true;
+		Weapon->ServerBurstStartTime = Weapon->GetWorld()->GetTimeSeconds() - Seconds;
+		Weapon->ServerFirstShotDelay = 0.0f;
+		Weapon->LastServerShotIndex = INDEX_NONE;
+		Weapon->ServerFirstShotSequence = FMath::Max(Weapon->AmmoState.ShotSequence, Weapon->ServerReloadShotSequence) + 1;
+
+		OutShots.Reset();
+		for (int32 i = 0; i < NumShots; i++)
+		{
+			FWeaponShotResult Shot;
+			Shot.ShotIndex = i;
+			OutShots.Add(Shot);
+		}
+	}
+
+	/** feeds shots of a burst that started Seconds ago, once as regular batch and once as final batch */
+	static void FireProtocol(const TArray<FString>& Args)
+	{
+		AShooterWeapon* Weapon = GetWeapon();
+		if (Weapon == NULL)
+		{
+			return;
+		}
+
+		const float Seconds = Args.Num() > 0 ? FCString::Atof(*Args[0]) : 0.5f;
+		const float TimeBetweenShots = FMath::Max(Weapon->EffectiveStats.TimeBetweenShots, 0.01f);
+		const int32 NumShots = FMath::Min(FMath::CeilToInt(Seconds / TimeBetweenShots) + 4, 64);
+
+		const int32 SavedAmmo = Weapon->CurrentAmmo;
+		const int32 SavedAmmoInClip = Weapon->CurrentAmmoInClip;
+		const FWeaponAmmoState SavedAmmoState = Weapon->AmmoState;
+
+		TArray<FWeaponShotResult> Shots;
+		StartBurst(Weapon, Seconds, NumShots, Shots);
+
+		UE_LOG(LogShooterWeapon, Log, TEXT("TestFireProtocol: %d shots %.2fs into burst, %.3fs between shots, cadence tolerance %.2fs"),
+			NumShots, Seconds, Weapon->EffectiveStats.TimeBetweenShots, GetFireProtocolConfig().CadenceTolerance);
+
+		Weapon->ServerProcessShots(Weapon->FireBurstId, Shots);
+		UE_LOG(LogShooterWeapon, Log, TEXT("TestFireProtocol: regular batch processed up to shot %d, rest waits for resend"), Weapon->LastServerShotIndex);
+
+		Weapon->ServerProcessShots(Weapon->FireBurstId, Shots, true);
+		UE_LOG(LogShooterWeapon, Log, TEXT("TestFireProtocol: final batch processed up to shot %d, %d dropped"), Weapon->LastServerShotIndex,
+			NumShots - 1 - Weapon->LastServerShotIndex);
+
+		Weapon->bServerBurstActive = false;
+		Weapon->CurrentAmmo = SavedAmmo;
+		Weapon->CurrentAmmoInClip = SavedAmmoInClip;
+		Weapon->AmmoState = SavedAmmoState;
+	}
+
+	/** processes start of a burst, reloads with more shots already fired and feeds the whole burst again as if it arrived after the reload */
+	static void ReloadOrdering()
+	{
+		AShooterWeapon* Weapon = GetWeapon();
+		if (Weapon == NULL)
+		{
+			return;
+		}
+
+		const int32 NumShots = 6;
+		const int32 NumBeforeReload = 4;
+
+		TArray<FWeaponShotResult> Shots;
+		StartBurst(Weapon, 10.0f, NumShots, Shots);
+
+		TArray<FWeaponShotResult> FirstShots;
+		FirstShots.Append(Shots.GetData(), 2);
+		Weapon->ServerProcessShots(Weapon->FireBurstId, FirstShots);
+
+		if (!Weapon->CanReload())
+		{
+			UE_LOG(LogShooterWeapon, Log, TEXT("TestReloadOrdering: weapon can't reload now, try again once it's idle"));
+			Weapon->bServerBurstActive = false;
+			return;
+		}
+
+		const int32 FirstShotSequence = Weapon->ServerFirstShotSequence;
+		Weapon->ServerStartReload_Implementation(Weapon->ReloadSequence + 1, FirstShotSequence + NumBeforeReload - 1);
+
+		const int32 StartBurstCounter = Weapon->BurstCounter;
+		Weapon->ServerProcessShots(Weapon->FireBurstId, Shots);
+
+		UE_LOG(LogShooterWeapon, Log, TEXT("TestReloadOrdering: reload after shot sequence %d, %d of %d late shots processed (expected %d), ammo state at shot %d"),
+			Weapon->ServerReloadShotSequence, Weapon->BurstCounter - StartBurstCounter, NumShots - 2, NumShots - NumBeforeReload, Weapon->AmmoState.ShotSequence);
+
+		Weapon->bServerBurstActive = false;
+	}
+
+	/** logs modifiers and effective stats of weapon */
+	static void LogModifiers(AShooterWeapon* Weapon, const TCHAR* When)
+	{
+		FString Sources;
+		for (int32 i = 0; i < Weapon->Modifiers.Num(); i++)
+		{
+			Sources += (i > 0 ? TEXT(", ") : TEXT("")) + Weapon->Modifiers[i].Source.ToString();
+		}
+
+		const FWeaponEffectiveStats& Stats = Weapon->GetEffectiveStats();
+		UE_LOG(LogShooterWeapon, Log, TEXT("TestWeaponModifier %s: [%s] time between shots %.3f, damage x%.2f, spread x%.2f, infinite ammo %d, infinite clip %d"),
+			When, *Sources, Stats.TimeBetweenShots, Stats.DamageScale, Stats.SpreadScale, Stats.bInfiniteAmmo, Stats.bInfiniteClip);
+	}
+
+	/** adds modifier to weapon of local pawn and removes it again, logging effective stats at each step */
+	static void WeaponModifier(const TArray<FString>& Args)
+	{
+		AShooterWeapon* Weapon = GetWeapon();
+		if (Weapon == NULL)
+		{
+			return;
+		}
+
+		static const FName TestSource(TEXT("Test"));
+
+		FWeaponModifier Modifier;
+		Modifier.Source = TestSource;
+		Modifier.TimeBetweenShotsScale = Args.Num() > 0 ? FCString::Atof(*Args[0]) : 0.5f;
+		Modifier.DamageScale = Args.Num() > 1 ? FCString::Atof(*Args[1]) : 2.0f;
+
+		LogModifiers(Weapon, TEXT("before"));
+		Weapon->AddModifier(Modifier);
+		LogModifiers(Weapon, TEXT("added"));
+		Weapon->RemoveModifier(TestSource);
+		LogModifiers(Weapon, TEXT("removed"));
+	}
+};
+
+static FAutoConsoleCommand CmdTestFireProtocol(
+	TEXT("Shooter.TestFireProtocol"),
+	TEXT("Feeds shots of a burst that started [seconds] ago to the local pawn's weapon, logs how many the cadence check lets through"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(FShooterWeaponTest::FireProtocol)
+	);
+
+static FAutoConsoleCommand CmdTestReloadOrdering(
+	TEXT("Shooter.TestReloadOrdering"),
+	TEXT("Reloads the local pawn's weapon in the middle of a synthetic burst, logs that shots from before the reload arriving after it are dropped"),
+	FConsoleCommandDelegate::CreateStatic(FShooterWeaponTest::ReloadOrdering)
+	);
+
+static FAutoConsoleCommand CmdTestWeaponModifier(
+	TEXT("Shooter.TestWeaponModifier"),
+	TEXT("Adds a modifier to the local pawn's weapon and removes it again, logging effective stats at each step; optional arguments: time between shots scale, damage scale"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(FShooterWeaponTest::WeaponModifier)
+	);
+#endif
 
 AShooterWeapon::AShooterWeapon(const class FPostConstructInitializeProperties& PCIP) : Super(PCIP)
 {
@@ -35,12 +244,27 @@ AShooterWeapon::AShooterWeapon(const class FPostConstructInitializeProperties& P
 	bPendingReload = false;
 	bPendingEquip = false;
 	CurrentState = EWeaponState::Idle;
+	FireLoudness = 1.0f;
 
 	CurrentAmmo = 0;
 	CurrentAmmoInClip = 0;
 	BurstCounter = 0;
 	LastFireTime = 0.0f;
 
+	FireBurstId = 0;
+	FireBurstSeed = 0;
+	NextShotIndex = 0;
+	NumUnsentShots = 0;
+	bServerBurstActive = false;
+	ServerBurstStartTime = 0.0f;
+	ServerFirstShotDelay = 0.0f;
+	LastServerShotIndex = INDEX_NONE;
+	ServerFirstShotSequence = 0;
+	ServerReloadShotSequence = 0;
+
+	NextShotSequence = 1;
+	ReloadSequence = 0;
+
 	PrimaryActorTick.bCanEverTick = true;
 	PrimaryActorTick.TickGroup = TG_PrePhysics;
 	SetRemoteRoleForBackwardsCompat(ROLE_SimulatedProxy);
@@ -53,12 +277,15 @@ void AShooterWeapon::PostInitializeComponents()
 {
 	Super::PostInitializeComponents();
 
+	ApplyDefinition(FShooterWeaponRegistry::Get().FindDefinition(GetClass()));
+
 	if (WeaponConfig.InitialClips > 0)
 	{
 		CurrentAmmoInClip = WeaponConfig.AmmoPerClip;
 		CurrentAmmo = WeaponConfig.AmmoPerClip * WeaponConfig.InitialClips;
 	}
 
+	ResolveModifiers();
 	DetachMeshFromPawn();
 }
 
@@ -69,12 +296,18 @@ void AShooterWeapon::Destroyed()
 	StopSimulatingWeaponFire();
 }
 
+void AShooterWeapon::ApplyDefinition(const UShooterWeaponDefinition* Definition)
+{
+	WeaponConfig = Definition ? Definition->WeaponConfig : GetClass()->GetDefaultObject<AShooterWeapon>()->WeaponConfig;
+}
+
 //////////////////////////////////////////////////////////////////////////
 // Inventory
 
 void AShooterWeapon::OnEquip()
 {
 	AttachMeshToPawn();
+	ResolveModifiers();
 
 	bPendingEquip = true;
 	DetermineWeaponState();
@@ -130,6 +363,12 @@ void AShooterWeapon::OnUnEquip()
 
 		GetWorldTimerManager().ClearTimer(this, &AShooterWeapon::StopReload);
 		GetWorldTimerManager().ClearTimer(this, &AShooterWeapon::ReloadWeapon);
+
+		// interrupted reload resolves client's request without refill
+		if (Role == ROLE_Authority)
+		{
+			AmmoState.ReloadSequence = ReloadSequence;
+		}
 	}
 
 	if (bPendingEquip)
@@ -146,6 +385,7 @@ void AShooterWeapon::OnUnEquip()
 void AShooterWeapon::OnEnterInventory(AShooterCharacter* NewOwner)
 {
 	SetOwningPawn(NewOwner);
+	ResolveModifiers();
 }
 
 void AShooterWeapon::OnLeaveInventory()
@@ -204,13 +444,13 @@ void AShooterWeapon::DetachMeshFromPawn()
 
 void AShooterWeapon::StartFire()
 {
-	if (Role < ROLE_Authority)
-	{
-		ServerStartFire();
-	}
-
 	if (!bWantsToFire)
 	{
+		if (Role < ROLE_Authority)
+		{
+			BeginFireBurst();
+		}
+
 		bWantsToFire = true;
 		DetermineWeaponState();
 	}
@@ -218,13 +458,17 @@ void AShooterWeapon::StartFire()
 
 void AShooterWeapon::StopFire()
 {
-	if (Role < ROLE_Authority)
-	{
-		ServerStopFire();
-	}
-
 	if (bWantsToFire)
 	{
+		if (Role < ROLE_Authority)
+		{
+			// whatever wasn't acknowledged goes reliably with burst end
+			GetWorldTimerManager().ClearTimer(this, &AShooterWeapon::SendShotBatch);
+			ServerStopFire(FireBurstId, UnackedShots);
+			UnackedShots.Reset();
+			NumUnsentShots = 0;
+		}
+
 		bWantsToFire = false;
 		DetermineWeaponState();
 	}
@@ -232,13 +476,17 @@ void AShooterWeapon::StopFire()
 
 void AShooterWeapon::StartReload(bool bFromReplication)
 {
-	if (!bFromReplication && Role < ROLE_Authority)
-	{
-		ServerStartReload();
-	}
-
+	// owning client asks server only for reloads its predicted ammo allows
+	const bool bPredicted = !bFromReplication && Role < ROLE_Authority;
 	if (bFromReplication || CanReload())
 	{
+		if (bPredicted)
+		{
+			ReloadSequence++;
+			AddAmmoPrediction(true, ReloadSequence);
+			ServerStartReload(ReloadSequence, NextShotSequence - 1);
+		}
+
 		bPendingReload = true;
 		DetermineWeaponState();
 
@@ -249,7 +497,7 @@ void AShooterWeapon::StartReload(bool bFromReplication)
 		}
 
 		GetWorldTimerManager().SetTimer(this, &AShooterWeapon::StopReload, AnimDuration, false);
-		if (Role == ROLE_Authority)
+		if (Role == ROLE_Authority || bPredicted)
 		{
 			GetWorldTimerManager().SetTimer(this, &AShooterWeapon::ReloadWeapon, FMath::Max(0.1f, AnimDuration - 0.1f), false);
 		}
@@ -271,34 +519,102 @@ void AShooterWeapon::StopReload()
 	}
 }
 
-bool AShooterWeapon::ServerStartFire_Validate()
+bool AShooterWeapon::ServerStartFire_Validate(uint8 BurstId, int32 BurstSeed, float FirstShotDelay, int32 FirstShotSequence)
 {
 	return true;
 }
 
-void AShooterWeapon::ServerStartFire_Implementation()
+void AShooterWeapon::ServerStartFire_Implementation(uint8 BurstId, int32 BurstSeed, float FirstShotDelay, int32 FirstShotSequence)
 {
+	FireBurstId = BurstId;
+	FireBurstSeed = BurstSeed;
+	bServerBurstActive = true;
+	ServerBurstStartTime = GetWorld()->GetTimeSeconds();
+	ServerFirstShotDelay = FMath::Clamp(FirstShotDelay, 0.0f, EffectiveStats.TimeBetweenShots);
+	LastServerShotIndex = INDEX_NONE;
+	ServerFirstShotSequence = FirstShotSequence;
+
 	StartFire();
 }
 
-bool AShooterWeapon::ServerStopFire_Validate()
+bool AShooterWeapon::ServerStopFire_Validate(uint8 BurstId, const TArray<FWeaponShotResult>& Shots)
 {
 	return true;
 }
 
-void AShooterWeapon::ServerStopFire_Implementation()
+void AShooterWeapon::ServerStopFire_Implementation(uint8 BurstId, const TArray<FWeaponShotResult>& Shots)
 {
+	SHOOTER_COUNTER_INC(ReliableRPC);
+
+	// no resend follows the burst end, shots still too early for the weapon's cadence are dropped
+	ServerProcessShots(BurstId, Shots, true);
+
+	// shots dropped for cadence are resolved as well, client gets their ammo back
+	if (bServerBurstActive && BurstId == FireBurstId && Shots.Num() > 0)
+	{
+		AmmoState.ShotSequence = FMath::Max(AmmoState.ShotSequence, ServerFirstShotSequence + Shots.Last().ShotIndex);
+	}
+	bServerBurstActive = false;
+
 	StopFire();
 }
 
-bool AShooterWeapon::ServerStartReload_Validate()
+bool AShooterWeapon::ServerFireShots_Validate(uint8 BurstId, const TArray<FWeaponShotResult>& Shots)
+{
+	return true;
+}
+
+void AShooterWeapon::ServerFireShots_Implementation(uint8 BurstId, const TArray<FWeaponShotResult>& Shots)
+{
+	ServerProcessShots(BurstId, Shots);
+
+	// acknowledge resends as well, previous ack may have been lost
+	if (bServerBurstActive && BurstId == FireBurstId && LastServerShotIndex != INDEX_NONE)
+	{
+		ClientAckShots(BurstId, LastServerShotIndex);
+	}
+}
+
+void AShooterWeapon::ClientAckShots_Implementation(uint8 BurstId, int32 LastShotIndex)
+{
+	if (BurstId != FireBurstId)
+	{
+		return;
+	}
+
+	int32 NumAcked = 0;
+	while (NumAcked < UnackedShots.Num() && UnackedShots[NumAcked].ShotIndex <= LastShotIndex)
+	{
+		NumAcked++;
+	}
+	UnackedShots.RemoveAt(0, NumAcked);
+
+	if (UnackedShots.Num() == 0)
+	{
+		GetWorldTimerManager().ClearTimer(this, &AShooterWeapon::SendShotBatch);
+	}
+}
+
+bool AShooterWeapon::ServerStartReload_Validate(int32 Sequence, int32 LastShotSequence)
 {
 	return true;
 }
 
-void AShooterWeapon::ServerStartReload_Implementation()
+void AShooterWeapon::ServerStartReload_Implementation(int32 Sequence, int32 LastShotSequence)
 {
-	StartReload();
+	ReloadSequence = Sequence;
+	if (CanReload())
+	{
+		// shots from before the reload can't take ammo from the refilled clip, client drops their predictions
+		ServerReloadShotSequence = FMath::Max(ServerReloadShotSequence, LastShotSequence);
+		AmmoState.ShotSequence = FMath::Max(AmmoState.ShotSequence, ServerReloadShotSequence);
+		StartReload();
+	}
+	else
+	{
+		// rejected, client drops its predicted refill
+		AmmoState.ReloadSequence = Sequence;
+	}
 }
 
 bool AShooterWeapon::ServerStopReload_Validate()
@@ -313,7 +629,7 @@ void AShooterWeapon::ServerStopReload_Implementation()
 
 void AShooterWeapon::ClientStartReload_Implementation()
 {
-	StartReload();
+	StartReload(true);
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -350,36 +666,44 @@ void AShooterWeapon::GiveAmmo(int AddAmount)
 		BotAI->CheckAmmo(this);
 	}
 	
-	// start reload if clip was empty
+	// start reload if clip was empty, owning client can't predict it since new ammo isn't there yet
 	if (GetCurrentAmmoInClip() <= 0 &&
 		CanReload() &&
 		MyPawn->GetWeapon() == this)
 	{
-		ClientStartReload();
+		StartReload();
+		if (!MyPawn->IsLocallyControlled())
+		{
+			ClientStartReload();
+		}
 	}
 }
 
-void AShooterWeapon::UseAmmo()
+void AShooterWeapon::ConsumeRound(int32& Ammo, int32& AmmoInClip) const
 {
 	if (!HasInfiniteAmmo())
 	{
-		CurrentAmmoInClip--;
+		AmmoInClip--;
 	}
 
 	if (!HasInfiniteAmmo() && !HasInfiniteClip())
 	{
-		CurrentAmmo--;
+		Ammo--;
 	}
+}
 
-	AShooterAIController* BotAI = MyPawn ? Cast<AShooterAIController>(MyPawn->GetController()) : NULL;	
-	AShooterPlayerController* PlayerController = MyPawn ? Cast<AShooterPlayerController>(MyPawn->GetController()) : NULL;
+void AShooterWeapon::UseAmmo()
+{
+	ConsumeRound(CurrentAmmo, CurrentAmmoInClip);
+
+	AShooterAIController* BotAI = OwnerBotController.Get();
+	AShooterPlayerState* PlayerState = OwnerPlayerState.Get();
 	if (BotAI)
 	{
 		BotAI->CheckAmmo(this);
 	}
-	else if(PlayerController)
+	else if (PlayerState)
 	{
-		AShooterPlayerState* PlayerState = Cast<AShooterPlayerState>(PlayerController->PlayerState);
 		switch (GetAmmoType())
 		{
 			case EAmmoType::ERocket:
@@ -404,12 +728,25 @@ void AShooterWeapon::HandleFiring()
 
 		if (MyPawn && MyPawn->IsLocallyControlled())
 		{
+			PendingShot = FWeaponShotResult();
 			FireWeapon();
 
 			UseAmmo();
 			
 			// update firing FX on remote clients if function was called on server
 			BurstCounter++;
+
+			// local client will notify server
+			if (Role < ROLE_Authority)
+			{
+				AddAmmoPrediction(false, NextShotSequence++);
+				QueueShotResult();
+			}
+			else
+			{
+				RecordKillCamShot(PendingShot);
+				ReportFireNoise();
+			}
 		}
 	}
 	else if (CanReload())
@@ -438,12 +775,6 @@ void AShooterWeapon::HandleFiring()
 
 	if (MyPawn && MyPawn->IsLocallyControlled())
 	{
-		// local client will notify server
-		if (Role < ROLE_Authority)
-		{
-			ServerHandleFiring();
-		}
-
 		// reload after firing last round
 		if (CurrentAmmoInClip <= 0 && CanReload())
 		{
@@ -451,55 +782,198 @@ void AShooterWeapon::HandleFiring()
 		}
 
 		// setup refire timer
-		bRefiring = (CurrentState == EWeaponState::Firing && WeaponConfig.TimeBetweenShots > 0.0f);
+		bRefiring = (CurrentState == EWeaponState::Firing && EffectiveStats.TimeBetweenShots > 0.0f);
 		if (bRefiring)
 		{
-			GetWorldTimerManager().SetTimer(this, &AShooterWeapon::HandleFiring, WeaponConfig.TimeBetweenShots, false);
+			GetWorldTimerManager().SetTimer(this, &AShooterWeapon::HandleFiring, EffectiveStats.TimeBetweenShots, false);
 		}
 	}
 
 	LastFireTime = GetWorld()->GetTimeSeconds();
 }
 
-bool AShooterWeapon::ServerHandleFiring_Validate()
+void AShooterWeapon::BeginFireBurst()
 {
-	return true;
+	// first shot waits for previous burst's refire, same as in OnBurstStarted
+	const float GameTime = GetWorld()->GetTimeSeconds();
+	const float FirstShotDelay = LastFireTime > 0.0f ? FMath::Max(0.0f, LastFireTime + EffectiveStats.TimeBetweenShots - GameTime) : 0.0f;
+
+	FireBurstId++;
+	FireBurstSeed = FMath::Rand();
+	NextShotIndex = 0;
+	NumUnsentShots = 0;
+	UnackedShots.Reset();
+
+	ServerStartFire(FireBurstId, FireBurstSeed, FirstShotDelay, NextShotSequence);
 }
 
-void AShooterWeapon::ServerHandleFiring_Implementation()
+void AShooterWeapon::QueueShotResult()
 {
-	const bool bShouldUpdateAmmo = (CurrentAmmoInClip > 0 && CanFire());
+	PendingShot.ShotIndex = NextShotIndex++;
+	UnackedShots.Add(PendingShot);
+	NumUnsentShots++;
 
-	HandleFiring();
+	if (NumUnsentShots >= GetFireProtocolConfig().ShotsPerBatch)
+	{
+		SendShotBatch();
+	}
+	else if (!GetWorldTimerManager().IsTimerActive(this, &AShooterWeapon::SendShotBatch))
+	{
+		GetWorldTimerManager().SetTimer(this, &AShooterWeapon::SendShotBatch, GetFireProtocolConfig().BatchInterval, false);
+	}
+}
 
-	if (bShouldUpdateAmmo)
+void AShooterWeapon::SendShotBatch()
+{
+	if (UnackedShots.Num() == 0)
 	{
-		// update ammo
-		UseAmmo();
+		return;
+	}
 
-		// update firing FX on remote clients
-		BurstCounter++;
+	const int32 MaxShotsPerBatch = GetFireProtocolConfig().MaxShotsPerBatch;
+	if (UnackedShots.Num() > MaxShotsPerBatch)
+	{
+		TArray<FWeaponShotResult> Batch;
+		Batch.Append(UnackedShots.GetData(), MaxShotsPerBatch);
+		ServerFireShots(FireBurstId, Batch);
+	}
+	else
+	{
+		ServerFireShots(FireBurstId, UnackedShots);
 	}
+	NumUnsentShots = 0;
+
+	// keep resending until acknowledged
+	GetWorldTimerManager().SetTimer(this, &AShooterWeapon::SendShotBatch, GetFireProtocolConfig().BatchInterval, false);
 }
 
-void AShooterWeapon::ReloadWeapon()
+int32 AShooterWeapon::GetShotRandomSeed(int32 ShotIndex) const
+{
+	return (int32)FCrc::MemCrc32(&ShotIndex, sizeof(ShotIndex), (uint32)FireBurstSeed);
+}
+
+void AShooterWeapon::ServerProcessShots(uint8 BurstId, const TArray<FWeaponShotResult>& Shots, bool bFinalBatch /*= false*/)
+{
+	// shots of earlier bursts came with their burst end
+	if (!bServerBurstActive || BurstId != FireBurstId)
+	{
+		return;
+	}
+
+	const float BurstTime = GetWorld()->GetTimeSeconds() - ServerBurstStartTime;
+	for (int32 i = 0; i < Shots.Num(); i++)
+	{
+		const FWeaponShotResult& Shot = Shots[i];
+		if (Shot.ShotIndex <= LastServerShotIndex)
+		{
+			continue;
+		}
+
+		// client can't fire faster than weapon's cadence, modifiers included; early shots stay unacknowledged and wait for a resend,
+		// the final batch has none so they are dropped and the client gets their ammo back
+		const float ShotTime = ServerFirstShotDelay + Shot.ShotIndex * EffectiveStats.TimeBetweenShots;
+		if (ShotTime > BurstTime + GetFireProtocolConfig().CadenceTolerance)
+		{
+			UE_LOG(LogShooterWeapon, Verbose, TEXT("%s %s client shot %d (due %.2fs into burst, only %.2fs passed)"), *GetNameSafe(this),
+				bFinalBatch ? TEXT("Dropped") : TEXT("Delayed"), Shot.ShotIndex, ShotTime, BurstTime);
+			return;
+		}
+
+		LastServerShotIndex = Shot.ShotIndex;
+
+		// fired before a reload the reliable request for overtook, acknowledged but not processed
+		const int32 ShotSequence = ServerFirstShotSequence + Shot.ShotIndex;
+		if (ShotSequence <= ServerReloadShotSequence)
+		{
+			UE_LOG(LogShooterWeapon, Verbose, TEXT("%s Dropped client shot %d fired before reload"), *GetNameSafe(this), Shot.ShotIndex);
+			continue;
+		}
+
+		AmmoState.ShotSequence = ShotSequence;
+		if ((CurrentAmmoInClip > 0 || HasInfiniteClip() || HasInfiniteAmmo()) && MyPawn && MyPawn->CanFire())
+		{
+			ServerProcessShot(Shot);
+		}
+	}
+}
+
+void AShooterWeapon::ServerProcessShot(const FWeaponShotResult& Shot)
+{
+	if (GetNetMode() != NM_DedicatedServer)
+	{
+		SimulateWeaponFire();
+	}
+
+	UseAmmo();
+	RecordKillCamShot(Shot);
+	ReportFireNoise();
+
+	// update firing FX on remote clients
+	BurstCounter++;
+	LastFireTime = GetWorld()->GetTimeSeconds();
+}
+
+void AShooterWeapon::ReportFireNoise()
+{
+	AShooterGameMode* const GameMode = Cast<AShooterGameMode>(GetWorld()->GetAuthGameMode());
+	if (GameMode && MyPawn && FireLoudness > 0.0f)
+	{
+		GameMode->GetPerceptionBus().Post(EShooterStimulus::Gunfire, MyPawn->GetActorLocation(), MyPawn, NULL, FireLoudness);
+	}
+}
+
+void AShooterWeapon::RecordKillCamShot(const FWeaponShotResult& Shot)
+{
+	AShooterGameMode* const GameMode = Cast<AShooterGameMode>(GetWorld()->GetAuthGameMode());
+	if (GameMode && MyPawn && GameMode->GetKillCamRecorder().IsEnabled())
+	{
+		FShooterKillCamRecorder& Recorder = GameMode->GetKillCamRecorder();
+		const FVector ShootDir = Shot.ShootDir.IsZero() ? GetAdjustedAim() : Shot.ShootDir;
+		const FVector End = Shot.bBlockingHit ? Shot.ImpactPoint : GetMuzzleLocation() + ShootDir * Recorder.GetTracerLength();
+
+		Recorder.RecordShot(GetWorld(), MyPawn, End);
+	}
+}
+
+void AShooterWeapon::RefillClip(int32& Ammo, int32& AmmoInClip) const
 {
-	int32 ClipDelta = FMath::Min(WeaponConfig.AmmoPerClip - CurrentAmmoInClip, CurrentAmmo - CurrentAmmoInClip);
+	int32 ClipDelta = FMath::Min(WeaponConfig.AmmoPerClip - AmmoInClip, Ammo - AmmoInClip);
 
 	if (HasInfiniteClip())
 	{
-		ClipDelta = WeaponConfig.AmmoPerClip - CurrentAmmoInClip;
+		ClipDelta = WeaponConfig.AmmoPerClip - AmmoInClip;
 	}
 
 	if (ClipDelta > 0)
 	{
-		CurrentAmmoInClip += ClipDelta;
+		AmmoInClip += ClipDelta;
 	}
 
 	if (HasInfiniteClip())
 	{
-		CurrentAmmo = FMath::Max(CurrentAmmoInClip, CurrentAmmo);
+		Ammo = FMath::Max(AmmoInClip, Ammo);
+	}
+}
+
+void AShooterWeapon::ReloadWeapon()
+{
+	if (Role == ROLE_Authority)
+	{
+		AmmoState.ReloadSequence = ReloadSequence;
+	}
+	else
+	{
+		// refill stays predicted until server finishes the same reload
+		for (int32 i = 0; i < AmmoPredictions.Num(); i++)
+		{
+			if (AmmoPredictions[i].bReload && AmmoPredictions[i].Sequence == ReloadSequence)
+			{
+				AmmoPredictions[i].bApplied = true;
+			}
+		}
 	}
+
+	RefillClip(CurrentAmmo, CurrentAmmoInClip);
 }
 
 void AShooterWeapon::SetWeaponState(EWeaponState::Type NewState)
@@ -553,10 +1027,10 @@ void AShooterWeapon::OnBurstStarted()
 {
 	// start firing, can be delayed to satisfy TimeBetweenShots
 	const float GameTime = GetWorld()->GetTimeSeconds();
-	if (LastFireTime > 0 && WeaponConfig.TimeBetweenShots > 0.0f &&
-		LastFireTime + WeaponConfig.TimeBetweenShots > GameTime)
+	if (LastFireTime > 0 && EffectiveStats.TimeBetweenShots > 0.0f &&
+		LastFireTime + EffectiveStats.TimeBetweenShots > GameTime)
 	{
-		GetWorldTimerManager().SetTimer(this, &AShooterWeapon::HandleFiring, LastFireTime + WeaponConfig.TimeBetweenShots - GameTime, false);
+		GetWorldTimerManager().SetTimer(this, &AShooterWeapon::HandleFiring, LastFireTime + EffectiveStats.TimeBetweenShots - GameTime, false);
 	}
 	else
 	{
@@ -586,9 +1060,10 @@ void AShooterWeapon::OnBurstFinished()
 UAudioComponent* AShooterWeapon::PlayWeaponSound(USoundCue* Sound)
 {
 	UAudioComponent* AC = NULL;
-	if (Sound && MyPawn)
+	AShooterGameState* const MyGameState = Cast<AShooterGameState>(GetWorld()->GameState);
+	if (Sound && MyPawn && MyGameState)
 	{
-		AC = UGameplayStatics::PlaySoundAttached(Sound, MyPawn->GetRootComponent());
+		AC = MyGameState->GetAudioVoiceManager().PlaySoundAttached(EShooterSoundCategory::Weapon, Sound, MyPawn->GetRootComponent(), MyPawn->IsLocallyControlled());
 	}
 
 	return AC;
@@ -709,6 +1184,8 @@ FHitResult AShooterWeapon::WeaponTrace(const FVector& StartTrace, const FVector&
 {
 	static FName WeaponFireTag = FName(TEXT("WeaponTrace"));
 
+	SHOOTER_COUNTER_INC(WeaponTrace);
+
 	// Perform trace to retrieve hit info
 	FCollisionQueryParams TraceParams(WeaponFireTag, true, Instigator);
 	TraceParams.bTraceAsyncScene = true;
@@ -758,6 +1235,49 @@ void AShooterWeapon::OnRep_BurstCounter()
 	}
 }
 
+void AShooterWeapon::OnRep_AmmoState()
+{
+	// drop what server already accounted for
+	for (int32 i = AmmoPredictions.Num() - 1; i >= 0; i--)
+	{
+		const FWeaponAmmoPrediction& Prediction = AmmoPredictions[i];
+		if (Prediction.Sequence <= (Prediction.bReload ? AmmoState.ReloadSequence : AmmoState.ShotSequence))
+		{
+			AmmoPredictions.RemoveAt(i, 1, false);
+		}
+	}
+
+	// and replay the rest on top of server ammo
+	CurrentAmmo = AmmoState.Ammo;
+	CurrentAmmoInClip = AmmoState.AmmoInClip;
+	for (int32 i = 0; i < AmmoPredictions.Num(); i++)
+	{
+		if (!AmmoPredictions[i].bReload)
+		{
+			ConsumeRound(CurrentAmmo, CurrentAmmoInClip);
+		}
+		else if (AmmoPredictions[i].bApplied)
+		{
+			RefillClip(CurrentAmmo, CurrentAmmoInClip);
+		}
+	}
+}
+
+void AShooterWeapon::AddAmmoPrediction(bool bReload, int32 Sequence)
+{
+	// server stopped answering, old predictions are of no use anymore
+	const int32 MaxAmmoPredictions = 128;
+	if (AmmoPredictions.Num() >= MaxAmmoPredictions)
+	{
+		AmmoPredictions.RemoveAt(0);
+	}
+
+	FWeaponAmmoPrediction Prediction;
+	Prediction.bReload = bReload;
+	Prediction.Sequence = Sequence;
+	AmmoPredictions.Add(Prediction);
+}
+
 void AShooterWeapon::OnRep_Reload()
 {
 	if (bPendingReload)
@@ -869,14 +1389,37 @@ void AShooterWeapon::StopSimulatingWeaponFire()
 	}
 }
 
+void AShooterWeapon::PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker)
+{
+	Super::PreReplication(ChangedPropertyTracker);
+
+	// sequence numbers are updated where client's actions are resolved, counts are picked up here
+	AmmoState.Ammo = CurrentAmmo;
+	AmmoState.AmmoInClip = CurrentAmmoInClip;
+
+	FShooterNetAccounting::Get().AccountReplicatedProperties(this);
+}
+
+bool AShooterWeapon::CallRemoteFunction(UFunction* Function, void* Parameters, FOutParmRec* OutParms, FFrame* Stack)
+{
+	FShooterNetAccounting::FScopedSend ScopedSend(this, Function);
+	return Super::CallRemoteFunction(Function, Parameters, OutParms, Stack);
+}
+
+void AShooterWeapon::ProcessEvent(UFunction* Function, void* Parameters)
+{
+	FShooterNetAccounting::Get().AccountReceivedCall(this, Function, Parameters);
+	Super::ProcessEvent(Function, Parameters);
+}
+
 void AShooterWeapon::GetLifetimeReplicatedProps( TArray< FLifetimeProperty > & OutLifetimeProps ) const
 {
 	Super::GetLifetimeReplicatedProps( OutLifetimeProps );
 
 	DOREPLIFETIME( AShooterWeapon, MyPawn );
 
-	DOREPLIFETIME_CONDITION( AShooterWeapon, CurrentAmmo,		COND_OwnerOnly );
-	DOREPLIFETIME_CONDITION( AShooterWeapon, CurrentAmmoInClip, COND_OwnerOnly );
+	DOREPLIFETIME_CONDITION( AShooterWeapon, AmmoState,			COND_OwnerOnly );
+	DOREPLIFETIME_CONDITION( AShooterWeapon, Modifiers,			COND_OwnerOnly );
 
 	DOREPLIFETIME_CONDITION( AShooterWeapon, BurstCounter,		COND_SkipOwner );
 	DOREPLIFETIME_CONDITION( AShooterWeapon, bPendingReload,	COND_SkipOwner );
@@ -927,16 +1470,95 @@ int32 AShooterWeapon::GetMaxAmmo() const
 	return WeaponConfig.MaxAmmo;
 }
 
-bool AShooterWeapon::HasInfiniteAmmo() const
+void AShooterWeapon::AddModifier(const FWeaponModifier& Modifier)
+{
+	RemoveModifier(Modifier.Source);
+	Modifiers.Add(Modifier);
+	ResolveModifiers();
+}
+
+void AShooterWeapon::RemoveModifier(FName Source)
 {
-	const AShooterPlayerController* MyPC = (MyPawn != NULL) ? Cast<const AShooterPlayerController>(MyPawn->Controller) : NULL;
-	return WeaponConfig.bInfiniteAmmo || (MyPC && MyPC->HasInfiniteAmmo());
+	for (int32 i = Modifiers.Num() - 1; i >= 0; i--)
+	{
+		if (Modifiers[i].Source == Source)
+		{
+			Modifiers.RemoveAt(i);
+		}
+	}
+	ResolveModifiers();
+}
+
+void AShooterWeapon::ResolveModifiers()
+{
+	AController* OwnerController = MyPawn ? MyPawn->Controller : NULL;
+	const AShooterPlayerController* MyPC = Cast<AShooterPlayerController>(OwnerController);
+
+	OwnerBotController = Cast<AShooterAIController>(OwnerController);
+	OwnerPlayerState = MyPC ? Cast<AShooterPlayerState>(MyPC->PlayerState) : NULL;
+
+	// owner's cheats replicate and resolve like any other modifier
+	if (Role == ROLE_Authority)
+	{
+		UpdateCheatModifier(MyPC);
+	}
+
+	FWeaponEffectiveStats Stats;
+	Stats.bInfiniteAmmo = WeaponConfig.bInfiniteAmmo;
+	Stats.bInfiniteClip = WeaponConfig.bInfiniteClip;
+	Stats.TimeBetweenShots = WeaponConfig.TimeBetweenShots;
+
+	for (int32 i = 0; i < Modifiers.Num(); i++)
+	{
+		const FWeaponModifier& Modifier = Modifiers[i];
+		Stats.bInfiniteAmmo |= Modifier.bInfiniteAmmo;
+		Stats.bInfiniteClip |= Modifier.bInfiniteClip;
+		Stats.TimeBetweenShots *= Modifier.TimeBetweenShotsScale;
+		Stats.DamageScale *= Modifier.DamageScale;
+		Stats.SpreadScale *= Modifier.SpreadScale;
+	}
+
+	EffectiveStats = Stats;
+}
+
+void AShooterWeapon::UpdateCheatModifier(const AShooterPlayerController* MyPC)
+{
+	static const FName CheatSource(TEXT("Cheats"));
+
+	FWeaponModifier Cheats;
+	Cheats.Source = CheatSource;
+	Cheats.bInfiniteAmmo = MyPC && MyPC->HasInfiniteAmmo();
+	Cheats.bInfiniteClip = MyPC && MyPC->HasInfiniteClip();
+
+	int32 Index = INDEX_NONE;
+	for (int32 i = 0; i < Modifiers.Num() && Index == INDEX_NONE; i++)
+	{
+		if (Modifiers[i].Source == CheatSource)
+		{
+			Index = i;
+		}
+	}
+
+	if (!Cheats.bInfiniteAmmo && !Cheats.bInfiniteClip)
+	{
+		if (Index != INDEX_NONE)
+		{
+			Modifiers.RemoveAt(Index);
+		}
+	}
+	else if (Index == INDEX_NONE)
+	{
+		Modifiers.Add(Cheats);
+	}
+	else
+	{
+		Modifiers[Index] = Cheats;
+	}
 }
 
-bool AShooterWeapon::HasInfiniteClip() const
+void AShooterWeapon::OnRep_Modifiers()
 {
-	const AShooterPlayerController* MyPC = (MyPawn != NULL) ? Cast<const AShooterPlayerController>(MyPawn->Controller) : NULL;
-	return WeaponConfig.bInfiniteClip || (MyPC && MyPC->HasInfiniteClip());
+	ResolveModifiers();
 }
 
 float AShooterWeapon::GetEquipStartedTime() const
@@ -0,0 +1,9 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+
+UShooterWeaponDefinition::UShooterWeaponDefinition(const class FPostConstructInitializeProperties& PCIP) : Super(PCIP)
+{
+	WeaponClass = NULL;
+	DamageFalloff = NULL;
+}
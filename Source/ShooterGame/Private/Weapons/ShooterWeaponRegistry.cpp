@@ -0,0 +1,251 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "ShooterWeaponRegistry.h"
+#include "Engine/ObjectLibrary.h"
+#include "ShooterConfigSection.h"
+
+#if !UE_BUILD_SHIPPING
+static void ReloadWeaponDefinitions()
+{
+	FShooterWeaponRegistry::Get().Reload();
+}
+
+static void DumpWeaponTables()
+{
+	FShooterWeaponRegistry::Get().Dump();
+}
+
+static FAutoConsoleCommand CmdReloadWeaponDefinitions(
+	TEXT("Shooter.ReloadWeaponDefinitions"),
+	TEXT("Collects weapon definitions again and re-applies them to spawned weapons"),
+	FConsoleCommandDelegate::CreateStatic(ReloadWeaponDefinitions)
+	);
+
+static FAutoConsoleCommand CmdDumpWeaponTables(
+	TEXT("Shooter.DumpWeaponTables"),
+	TEXT("Logs the configured table limits and the spread and damage lookups of each instant hit weapon class"),
+	FConsoleCommandDelegate::CreateStatic(DumpWeaponTables)
+	);
+#endif
+
+float FShooterInstantWeaponTable::GetDamage(float Distance) const
+{
+	if (DamageSamples.Num() == 1)
+	{
+		return DamageSamples[0];
+	}
+
+	const float Sample = FMath::Clamp(Distance * DamageSampleScale, 0.0f, (float)(DamageSamples.Num() - 1));
+	const int32 Index = FMath::Min(FMath::FloorToInt(Sample), DamageSamples.Num() - 2);
+	return FMath::Lerp(DamageSamples[Index], DamageSamples[Index + 1], Sample - Index);
+}
+
+FShooterWeaponRegistry& FShooterWeaponRegistry::Get()
+{
+	static FShooterWeaponRegistry Instance;
+	return Instance;
+}
+
+FShooterWeaponRegistry::FShooterWeaponRegistry()
+	: MaxSpreadSteps(64)
+	, NumDamageSamples(32)
+	, Library(NULL)
+{
+	GetDefinitionPaths(Paths);
+
+	const FShooterConfigSection Config(TEXT("ShooterGame.WeaponDefinitions"));
+	Config.Get(TEXT("MaxSpreadSteps"), MaxSpreadSteps);
+	Config.Get(TEXT("NumDamageSamples"), NumDamageSamples);
+	MaxSpreadSteps = FMath::Max(MaxSpreadSteps, 1);
+	NumDamageSamples = FMath::Max(NumDamageSamples, 2);
+
+	LoadDefinitions();
+}
+
+void FShooterWeaponRegistry::GetDefinitionPaths(TArray<FString>& OutPaths)
+{
+	FShooterConfigSection(TEXT("ShooterGame.WeaponDefinitions")).Get(TEXT("Paths"), OutPaths);
+	if (OutPaths.Num() == 0)
+	{
+		OutPaths.Add(TEXT("/Game/Weapons"));
+	}
+}
+
+void FShooterWeaponRegistry::LoadDefinitions()
+{
+	Definitions.Reset();
+
+	if (Library == NULL)
+	{
+		Library = UObjectLibrary::CreateLibrary(UShooterWeaponDefinition::StaticClass(), false, GIsEditor);
+	}
+
+	for (int32 i = 0; i < Paths.Num(); i++)
+	{
+		Library->LoadAssetDataFromPath(Paths[i]);
+	}
+	Library->LoadAssetsFromAssetData();
+
+	TArray<UShooterWeaponDefinition*> Loaded;
+	Library->GetObjects(Loaded);
+
+	for (int32 i = 0; i < Loaded.Num(); i++)
+	{
+		UShooterWeaponDefinition* Definition = Loaded[i];
+		if (Definition == NULL || Definition->WeaponClass == NULL)
+		{
+			continue;
+		}
+
+		UShooterWeaponDefinition*& Existing = Definitions.FindOrAdd(Definition->WeaponClass);
+		if (Existing)
+		{
+			UE_LOG(LogShooterWeapon, Warning, TEXT("Weapon definitions %s and %s both tune %s, using %s"),
+				*Existing->GetName(), *Definition->GetName(), *Definition->WeaponClass->GetName(), *Existing->GetName());
+			continue;
+		}
+
+		Existing = Definition;
+	}
+
+	UE_LOG(LogShooterWeapon, Log, TEXT("Loaded %d weapon definitions"), Definitions.Num());
+}
+
+const UShooterWeaponDefinition* FShooterWeaponRegistry::FindDefinition(UClass* WeaponClass) const
+{
+	for (UClass* Class = WeaponClass; Class && Class != AShooterWeapon::StaticClass(); Class = Class->GetSuperClass())
+	{
+		UShooterWeaponDefinition* const* Definition = Definitions.Find(Class);
+		if (Definition)
+		{
+			return *Definition;
+		}
+	}
+
+	return NULL;
+}
+
+int32 FShooterWeaponRegistry::FindOrAddInstantTable(UClass* WeaponClass, const FInstantWeaponData& Config, const UCurveFloat* DamageFalloff)
+{
+	int32* TableIndex = InstantTableIndices.Find(WeaponClass);
+	if (TableIndex == NULL)
+	{
+		TableIndex = &InstantTableIndices.Add(WeaponClass, InstantTables.AddDefaulted());
+	}
+
+	FShooterInstantWeaponTable& Table = InstantTables[*TableIndex];
+	if (Table.bStale)
+	{
+		BuildInstantTable(Config, DamageFalloff, Table);
+	}
+
+	return *TableIndex;
+}
+
+void FShooterWeaponRegistry::BuildInstantTable(const FInstantWeaponData& Config, const UCurveFloat* DamageFalloff, FShooterInstantWeaponTable& OutTable)
+{
+	const FShooterWeaponRegistry& Registry = Get();
+
+	OutTable.WeaponRange = Config.WeaponRange;
+	OutTable.bStale = false;
+
+	// continuous firing adds the same increment every shot until max, so every reachable spread can be listed;
+	// if that takes more than MaxSpreadSteps, spread stays at the last listed step instead of jumping to max
+	int32 NumSteps = 1;
+	if (Config.FiringSpreadIncrement > 0.0f && Config.FiringSpreadMax > 0.0f)
+	{
+		NumSteps = FMath::Min(FMath::CeilToInt(Config.FiringSpreadMax / Config.FiringSpreadIncrement) + 1, Registry.MaxSpreadSteps);
+	}
+
+	OutTable.SpreadSteps.Reset();
+	OutTable.SpreadSteps.AddUninitialized(NumSteps);
+	for (int32 i = 0; i < NumSteps; i++)
+	{
+		const float FiringSpread = FMath::Min(Config.FiringSpreadMax, i * Config.FiringSpreadIncrement);
+		const float HipSpread = Config.WeaponSpread + FMath::Max(FiringSpread, 0.0f);
+		const float TargetingSpread = HipSpread * Config.TargetingSpreadMod;
+
+		FShooterSpreadStep& Step = OutTable.SpreadSteps[i];
+		Step.Spread[0] = HipSpread;
+		Step.Spread[1] = TargetingSpread;
+		Step.ConeHalfAngle[0] = FMath::DegreesToRadians(HipSpread * 0.5f);
+		Step.ConeHalfAngle[1] = FMath::DegreesToRadians(TargetingSpread * 0.5f);
+	}
+
+	OutTable.DamageSamples.Reset();
+	if (DamageFalloff && Config.WeaponRange > 0.0f)
+	{
+		// curve is sampled over fraction of range, so the same curve fits weapons of any range
+		const int32 NumSamples = Registry.NumDamageSamples;
+		OutTable.DamageSamples.AddUninitialized(NumSamples);
+		for (int32 i = 0; i < NumSamples; i++)
+		{
+			OutTable.DamageSamples[i] = Config.HitDamage * DamageFalloff->GetFloatValue((float)i / (NumSamples - 1));
+		}
+		OutTable.DamageSampleScale = (NumSamples - 1) / Config.WeaponRange;
+	}
+	else
+	{
+		OutTable.DamageSamples.Add(Config.HitDamage);
+		OutTable.DamageSampleScale = 0.0f;
+	}
+}
+
+void FShooterWeaponRegistry::Reload()
+{
+	LoadDefinitions();
+
+	for (int32 i = 0; i < InstantTables.Num(); i++)
+	{
+		InstantTables[i].bStale = true;
+	}
+
+	int32 NumWeapons = 0;
+	for (TObjectIterator<AShooterWeapon> It; It; ++It)
+	{
+		AShooterWeapon* Weapon = *It;
+		if (!Weapon->IsTemplate() && !Weapon->IsPendingKill())
+		{
+			Weapon->ApplyDefinition(FindDefinition(Weapon->GetClass()));
+			Weapon->ResolveModifiers();
+			NumWeapons++;
+		}
+	}
+
+	UE_LOG(LogShooterWeapon, Log, TEXT("Re-applied weapon definitions to %d weapons"), NumWeapons);
+}
+
+void FShooterWeaponRegistry::Dump() const
+{
+	UE_LOG(LogShooterWeapon, Log, TEXT("Weapon tables: %d instant hit classes, max %d spread steps, %d damage samples"),
+		InstantTableIndices.Num(), MaxSpreadSteps, NumDamageSamples);
+
+	for (TMap<TWeakObjectPtr<UClass>, int32>::TConstIterator It(InstantTableIndices); It; ++It)
+	{
+		const FShooterInstantWeaponTable& Table = InstantTables[It.Value()];
+		if (Table.bStale || Table.SpreadSteps.Num() == 0)
+		{
+			UE_LOG(LogShooterWeapon, Log, TEXT("  %s: stale"), It.Key().IsValid() ? *It.Key()->GetName() : TEXT("(unloaded)"));
+			continue;
+		}
+
+		const FShooterSpreadStep& First = Table.GetSpreadStep(0);
+		const FShooterSpreadStep& Last = Table.GetSpreadStep(Table.SpreadSteps.Num() - 1);
+		UE_LOG(LogShooterWeapon, Log, TEXT("  %s: range %.0f, %d spread steps%s (hip %.2f-%.2f, targeting %.2f-%.2f), %d damage samples (%.1f / %.1f / %.1f at 0 / half / full range)"),
+			It.Key().IsValid() ? *It.Key()->GetName() : TEXT("(unloaded)"), Table.WeaponRange,
+			Table.SpreadSteps.Num(), Table.SpreadSteps.Num() == MaxSpreadSteps ? TEXT(" (capped)") : TEXT(""),
+			First.Spread[0], Last.Spread[0], First.Spread[1], Last.Spread[1],
+			Table.DamageSamples.Num(), Table.GetDamage(0.0f), Table.GetDamage(Table.WeaponRange * 0.5f), Table.GetDamage(Table.WeaponRange));
+	}
+}
+
+void FShooterWeaponRegistry::AddReferencedObjects(FReferenceCollector& Collector)
+{
+	Collector.AddReferencedObject(Library);
+
+	for (TMap<UClass*, UShooterWeaponDefinition*>::TIterator It(Definitions); It; ++It)
+	{
+		Collector.AddReferencedObject(It.Value());
+	}
+}
@@ -0,0 +1,122 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+/** spread after given number of shots into a burst, [0] from the hip and [1] while targeting */
+struct FShooterSpreadStep
+{
+	/** spread (degrees) */
+	float Spread[2];
+
+	/** half-angle of shot cone (radians) */
+	float ConeHalfAngle[2];
+};
+
+/** runtime values of instant hit weapon class, derived once from its config */
+struct FShooterInstantWeaponTable
+{
+	/** weapon range */
+	float WeaponRange;
+
+	/** spread per shot into burst, last step holds once max spread or max number of steps is reached */
+	TArray<FShooterSpreadStep> SpreadSteps;
+
+	/** hit damage sampled at even steps over weapon range, single entry without falloff */
+	TArray<float> DamageSamples;
+
+	/** converts distance to index into DamageSamples */
+	float DamageSampleScale;
+
+	/** needs to be rebuilt from config before next use */
+	bool bStale;
+
+	FShooterInstantWeaponTable()
+		: WeaponRange(0.0f)
+		, DamageSampleScale(0.0f)
+		, bStale(true)
+	{
+	}
+
+	/** returns spread step after given number of shots into burst */
+	FORCEINLINE const FShooterSpreadStep& GetSpreadStep(int32 BurstShotCount) const
+	{
+		return SpreadSteps[FMath::Min(BurstShotCount, SpreadSteps.Num() - 1)];
+	}
+
+	/** returns hit damage at distance from shot origin */
+	float GetDamage(float Distance) const;
+};
+
+/**
+ * Weapon definitions and the runtime tables derived from them.
+ *
+ * UShooterWeaponDefinition assets are collected from Paths in [ShooterGame.WeaponDefinitions] of the Game ini
+ * when the first game state comes up with a map, and applied to weapons when they spawn, weapon classes without a definition keep the config set in their defaults.
+ * Spread cones and damage falloff of instant hit weapons are precomputed per class, so the fire path only looks them up.
+ *
+ * Outside of shipping builds "Shooter.ReloadWeaponDefinitions" collects definitions again, rebuilds the tables
+ * and re-applies them to spawned weapons, which lets balancing changes made in the editor show up in a running match;
+ * "Shooter.DumpWeaponTables" logs the lookups of each instant hit weapon class. MaxSpreadSteps and NumDamageSamples in the same section limit table sizes.
+ */
+class FShooterWeaponRegistry : public FGCObject
+{
+public:
+
+	/** returns the registry */
+	static FShooterWeaponRegistry& Get();
+
+	/** returns definition of weapon class or its nearest parent, NULL if there is none */
+	const class UShooterWeaponDefinition* FindDefinition(UClass* WeaponClass) const;
+
+	/** returns index of runtime table of instant hit weapon class, building it from config if needed */
+	int32 FindOrAddInstantTable(UClass* WeaponClass, const struct FInstantWeaponData& Config, const UCurveFloat* DamageFalloff);
+
+	/** returns runtime table by index */
+	const FShooterInstantWeaponTable& GetInstantTable(int32 TableIndex) const
+	{
+		return InstantTables[TableIndex];
+	}
+
+	/** collects definitions again and re-applies them to spawned weapons */
+	void Reload();
+
+	/** logs table limits and the lookups of each runtime table */
+	void Dump() const;
+
+	/** returns content paths definitions are collected from, without loading anything */
+	static void GetDefinitionPaths(TArray<FString>& OutPaths);
+
+	/** keeps definitions alive */
+	virtual void AddReferencedObjects(FReferenceCollector& Collector) OVERRIDE;
+
+private:
+
+	FShooterWeaponRegistry();
+
+	/** loads definitions from configured paths */
+	void LoadDefinitions();
+
+	/** derives runtime values of instant hit weapon */
+	static void BuildInstantTable(const struct FInstantWeaponData& Config, const UCurveFloat* DamageFalloff, FShooterInstantWeaponTable& OutTable);
+
+	/** content paths searched for definitions */
+	TArray<FString> Paths;
+
+	/** max number of spread steps per weapon */
+	int32 MaxSpreadSteps;
+
+	/** number of damage samples over weapon range of weapons with falloff */
+	int32 NumDamageSamples;
+
+	/** library used to find definitions */
+	class UObjectLibrary* Library;
+
+	/** definition of each weapon class */
+	TMap<UClass*, class UShooterWeaponDefinition*> Definitions;
+
+	/** runtime tables of instant hit weapons, indices stay valid through reloads */
+	TArray<FShooterInstantWeaponTable> InstantTables;
+
+	/** index in InstantTables of each weapon class */
+	TMap<TWeakObjectPtr<UClass>, int32> InstantTableIndices;
+};
@@ -1,10 +1,24 @@
 // Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
 
 #include "ShooterGame.h"
+#include "ShooterStatCounters.h"
+#include "Online/ShooterServerBudget.h"
+#include "ShooterWeaponRegistry.h"
 
 AShooterWeapon_Instant::AShooterWeapon_Instant(const class FPostConstructInitializeProperties& PCIP) : Super(PCIP)
 {
-	CurrentFiringSpread = 0.0f;
+	InstantTableIndex = INDEX_NONE;
+	BurstShotCount = 0;
+	LastHitNotifyTime = 0.0f;
+}
+
+void AShooterWeapon_Instant::ApplyDefinition(const UShooterWeaponDefinition* Definition)
+{
+	Super::ApplyDefinition(Definition);
+
+	InstantConfig = Definition ? Definition->InstantConfig : GetClass()->GetDefaultObject<AShooterWeapon_Instant>()->InstantConfig;
+	InstantTableIndex = FShooterWeaponRegistry::Get().FindOrAddInstantTable(GetClass(), InstantConfig, Definition ? Definition->DamageFalloff : NULL);
+	BurstShotCount = 0;
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -12,28 +26,59 @@ AShooterWeapon_Instant::AShooterWeapon_Instant(const class FPostConstructInitial
 
 void AShooterWeapon_Instant::FireWeapon()
 {
-	const int32 RandomSeed = FMath::Rand();
+	// owning client's shots have to be reproducible on server for remote FX
+	const int32 RandomSeed = Role < ROLE_Authority ? GetShotRandomSeed(NextShotIndex) : FMath::Rand();
 	FRandomStream WeaponRandomStream(RandomSeed);
 	const float CurrentSpread = GetCurrentSpread();
-	const float ConeHalfAngle = FMath::DegreesToRadians(CurrentSpread * 0.5f);
+	const float ConeHalfAngle = GetCurrentConeHalfAngle();
 
 	const FVector AimDir = GetAdjustedAim();
 	const FVector StartTrace = GetCameraDamageStartLocation(AimDir);
 	const FVector ShootDir = WeaponRandomStream.VRandCone(AimDir, ConeHalfAngle, ConeHalfAngle);
-	const FVector EndTrace = StartTrace + ShootDir * InstantConfig.WeaponRange;
+	const FVector EndTrace = StartTrace + ShootDir * GetInstantTable().WeaponRange;
 
 	const FHitResult Impact = WeaponTrace(StartTrace, EndTrace);
 	ProcessInstantHit(Impact, StartTrace, ShootDir, RandomSeed, CurrentSpread);
 
-	CurrentFiringSpread = FMath::Min(InstantConfig.FiringSpreadMax, CurrentFiringSpread + InstantConfig.FiringSpreadIncrement);
+	AdvanceBurstSpread();
 }
 
-bool AShooterWeapon_Instant::ServerNotifyHit_Validate(const FHitResult Impact, FVector_NetQuantizeNormal ShootDir, int32 RandomSeed, float ReticleSpread)
+void AShooterWeapon_Instant::ServerProcessShot(const FWeaponShotResult& Shot)
 {
-	return true;
+	Super::ServerProcessShot(Shot);
+
+	// spread follows the same progression as on client, so client can't claim a wider one
+	const int32 RandomSeed = GetShotRandomSeed(Shot.ShotIndex);
+	const float ReticleSpread = GetCurrentSpread();
+	AdvanceBurstSpread();
+
+	if (Shot.bBlockingHit)
+	{
+		FHitResult Impact;
+		Impact.bBlockingHit = true;
+		Impact.Actor = Shot.HitActor;
+		Impact.Location = Impact.ImpactPoint = Shot.ImpactPoint;
+		Impact.Normal = Impact.ImpactNormal = Shot.ImpactNormal;
+
+		ServerConfirmHit(Impact, Shot.ShootDir, RandomSeed, ReticleSpread);
+	}
+	else
+	{
+		const FVector Origin = GetMuzzleLocation();
+
+		// play FX on remote clients
+		NotifyRemoteHit(Origin, RandomSeed, ReticleSpread);
+
+		// play FX locally
+		if (GetNetMode() != NM_DedicatedServer)
+		{
+			const FVector EndTrace = Origin + Shot.ShootDir * GetInstantTable().WeaponRange;
+			SpawnTrailEffect(EndTrace);
+		}
+	}
 }
 
-void AShooterWeapon_Instant::ServerNotifyHit_Implementation(const FHitResult Impact, FVector_NetQuantizeNormal ShootDir, int32 RandomSeed, float ReticleSpread)
+void AShooterWeapon_Instant::ServerConfirmHit(const FHitResult& Impact, const FVector& ShootDir, int32 RandomSeed, float ReticleSpread)
 {
 	const float WeaponAngleDot = FMath::Abs(FMath::Sin(ReticleSpread * PI / 180.f));
 
@@ -104,50 +149,21 @@ void AShooterWeapon_Instant::ServerNotifyHit_Implementation(const FHitResult Imp
 	}
 }
 
-bool AShooterWeapon_Instant::ServerNotifyMiss_Validate(FVector_NetQuantizeNormal ShootDir, int32 RandomSeed, float ReticleSpread)
-{
-	return true;
-}
-
-void AShooterWeapon_Instant::ServerNotifyMiss_Implementation(FVector_NetQuantizeNormal ShootDir, int32 RandomSeed, float ReticleSpread)
-{
-	const FVector Origin = GetMuzzleLocation();
-
-	// play FX on remote clients
-	HitNotify.Origin = Origin;
-	HitNotify.RandomSeed = RandomSeed;
-	HitNotify.ReticleSpread = ReticleSpread;
-
-	// play FX locally
-	if (GetNetMode() != NM_DedicatedServer)
-	{
-		const FVector EndTrace = Origin + ShootDir * InstantConfig.WeaponRange;
-		SpawnTrailEffect(EndTrace);
-	}
-}
-
 void AShooterWeapon_Instant::ProcessInstantHit(const FHitResult& Impact, const FVector& Origin, const FVector& ShootDir, int32 RandomSeed, float ReticleSpread)
 {
-	if (MyPawn && MyPawn->IsLocallyControlled() && GetNetMode() == NM_Client)
+	if (MyPawn && MyPawn->IsLocallyControlled())
 	{
-		// if we're a client and we've hit something that is being controlled by the server
-		if (Impact.GetActor() && Impact.GetActor()->GetRemoteRole() == ROLE_Authority)
+		// result goes to server with next shot batch, on server it's recorded for kill-cams right away
+		PendingShot.ShootDir = ShootDir;
+
+		// only hits on world and on actors controlled by the server are reported, anything else shows up as a miss
+		const bool bReportHit = (Role == ROLE_Authority || Impact.GetActor() == NULL) ? Impact.bBlockingHit : Impact.GetActor()->GetRemoteRole() == ROLE_Authority;
+		if (bReportHit)
 		{
-			// notify the server of the hit
-			ServerNotifyHit(Impact, ShootDir, RandomSeed, ReticleSpread);
-		}
-		else if (Impact.GetActor() == NULL)
-		{
-			if (Impact.bBlockingHit)
-			{
-				// notify the server of the hit
-				ServerNotifyHit(Impact, ShootDir, RandomSeed, ReticleSpread);
-			}
-			else
-			{
-				// notify server of the miss
-				ServerNotifyMiss(ShootDir, RandomSeed, ReticleSpread);
-			}
+			PendingShot.bBlockingHit = true;
+			PendingShot.HitActor = Impact.GetActor();
+			PendingShot.ImpactPoint = Impact.ImpactPoint;
+			PendingShot.ImpactNormal = Impact.ImpactNormal;
 		}
 	}
 
@@ -160,21 +176,19 @@ void AShooterWeapon_Instant::ProcessInstantHit_Confirmed(const FHitResult& Impac
 	// handle damage
 	if (ShouldDealDamage(Impact.GetActor()))
 	{
-		DealDamage(Impact, ShootDir);
+		DealDamage(Impact, Origin, ShootDir);
 	}
 
 	// play FX on remote clients
 	if (Role == ROLE_Authority)
 	{
-		HitNotify.Origin = Origin;
-		HitNotify.RandomSeed = RandomSeed;
-		HitNotify.ReticleSpread = ReticleSpread;
+		NotifyRemoteHit(Origin, RandomSeed, ReticleSpread);
 	}
 
 	// play FX locally
 	if (GetNetMode() != NM_DedicatedServer)
 	{
-		const FVector EndTrace = Origin + ShootDir * InstantConfig.WeaponRange;
+		const FVector EndTrace = Origin + ShootDir * GetInstantTable().WeaponRange;
 		const FVector EndPoint = Impact.GetActor() ? Impact.ImpactPoint : EndTrace;
 
 		SpawnTrailEffect(EndPoint);
@@ -198,13 +212,13 @@ bool AShooterWeapon_Instant::ShouldDealDamage(AActor* TestActor) const
 	return false;
 }
 
-void AShooterWeapon_Instant::DealDamage(const FHitResult& Impact, const FVector& ShootDir)
+void AShooterWeapon_Instant::DealDamage(const FHitResult& Impact, const FVector& Origin, const FVector& ShootDir)
 {
 	FPointDamageEvent PointDmg;
 	PointDmg.DamageTypeClass = InstantConfig.DamageType;
 	PointDmg.HitInfo = Impact;
 	PointDmg.ShotDirection = ShootDir;
-	PointDmg.Damage = InstantConfig.HitDamage;
+	PointDmg.Damage = GetInstantTable().GetDamage((Impact.ImpactPoint - Origin).Size()) * EffectiveStats.DamageScale;
 
 	Impact.GetActor()->TakeDamage(PointDmg.Damage, PointDmg, MyPawn->Controller, this);
 }
@@ -213,22 +227,33 @@ void AShooterWeapon_Instant::OnBurstFinished()
 {
 	Super::OnBurstFinished();
 
-	CurrentFiringSpread = 0.0f;
+	BurstShotCount = 0;
 }
 
 
 //////////////////////////////////////////////////////////////////////////
 // Weapon usage helpers
 
+const FShooterInstantWeaponTable& AShooterWeapon_Instant::GetInstantTable() const
+{
+	return FShooterWeaponRegistry::Get().GetInstantTable(InstantTableIndex);
+}
+
 float AShooterWeapon_Instant::GetCurrentSpread() const
 {
-	float FinalSpread = InstantConfig.WeaponSpread + CurrentFiringSpread;
-	if (MyPawn && MyPawn->IsTargeting())
-	{
-		FinalSpread *= InstantConfig.TargetingSpreadMod;
-	}
+	const int32 Mode = (MyPawn && MyPawn->IsTargeting()) ? 1 : 0;
+	return GetInstantTable().GetSpreadStep(BurstShotCount).Spread[Mode] * EffectiveStats.SpreadScale;
+}
+
+float AShooterWeapon_Instant::GetCurrentConeHalfAngle() const
+{
+	const int32 Mode = (MyPawn && MyPawn->IsTargeting()) ? 1 : 0;
+	return GetInstantTable().GetSpreadStep(BurstShotCount).ConeHalfAngle[Mode] * EffectiveStats.SpreadScale;
+}
 
-	return FinalSpread;
+void AShooterWeapon_Instant::AdvanceBurstSpread()
+{
+	BurstShotCount = FMath::Min(BurstShotCount + 1, GetInstantTable().SpreadSteps.Num() - 1);
 }
 
 
@@ -240,6 +265,23 @@ void AShooterWeapon_Instant::OnRep_HitNotify()
 	SimulateInstantHit(HitNotify.Origin, HitNotify.RandomSeed, HitNotify.ReticleSpread);
 }
 
+void AShooterWeapon_Instant::NotifyRemoteHit(const FVector& Origin, int32 RandomSeed, float ReticleSpread)
+{
+	// trails and impacts on remote clients are cosmetic, an overloaded server sends fewer of them
+	const float CurrentTime = GetWorld()->GetTimeSeconds();
+	AShooterGameMode* GameMode = Cast<AShooterGameMode>(GetWorld()->GetAuthGameMode());
+	if (GameMode && GameMode->GetServerBudget().ShouldShed(EShooterShedWork::CosmeticMulticast) &&
+		CurrentTime - LastHitNotifyTime < GameMode->GetServerBudget().GetCosmeticInterval())
+	{
+		return;
+	}
+
+	LastHitNotifyTime = CurrentTime;
+	HitNotify.Origin = Origin;
+	HitNotify.RandomSeed = RandomSeed;
+	HitNotify.ReticleSpread = ReticleSpread;
+}
+
 void AShooterWeapon_Instant::SimulateInstantHit(const FVector& ShotOrigin, int32 RandomSeed, float ReticleSpread)
 {
 	FRandomStream WeaponRandomStream(RandomSeed);
@@ -248,7 +290,7 @@ void AShooterWeapon_Instant::SimulateInstantHit(const FVector& ShotOrigin, int32
 	const FVector StartTrace = ShotOrigin;
 	const FVector AimDir = GetAdjustedAim();
 	const FVector ShootDir = WeaponRandomStream.VRandCone(AimDir, ConeHalfAngle, ConeHalfAngle);
-	const FVector EndTrace = StartTrace + ShootDir * InstantConfig.WeaponRange;
+	const FVector EndTrace = StartTrace + ShootDir * GetInstantTable().WeaponRange;
 
 	FHitResult Impact = WeaponTrace(StartTrace, EndTrace);
 	if (Impact.bBlockingHit)
@@ -266,6 +308,8 @@ void AShooterWeapon_Instant::SpawnImpactEffects(const FHitResult& Impact)
 {
 	if (ImpactTemplate && Impact.bBlockingHit)
 	{
+		SHOOTER_COUNTER_INC(ImpactEffect);
+
 		FHitResult UseImpact = Impact;
 
 		// trace again to find component lost during replication
@@ -1,6 +1,7 @@
 // Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
 
 #include "ShooterGame.h"
+#include "ShooterStatCounters.h"
 
 AShooterWeapon_Projectile::AShooterWeapon_Projectile(const class FPostConstructInitializeProperties& PCIP) : Super(PCIP)
 {
@@ -59,6 +60,8 @@ void AShooterWeapon_Projectile::FireWeapon()
 		}
 	}
 
+	// spawn can't wait for a shot batch, batch only carries the shot for ammo and cadence
+	PendingShot.ShootDir = ShootDir;
 	ServerFireProjectile(Origin, ShootDir);
 }
 
@@ -69,6 +72,9 @@ bool AShooterWeapon_Projectile::ServerFireProjectile_Validate(FVector Origin, FV
 
 void AShooterWeapon_Projectile::ServerFireProjectile_Implementation(FVector Origin, FVector_NetQuantizeNormal ShootDir)
 {
+	SHOOTER_COUNTER_INC(ReliableRPC);
+	SHOOTER_COUNTER_INC(ProjectileSpawn);
+
 	FTransform SpawnTM(ShootDir.Rotation(), Origin);
 	AShooterProjectile* Projectile = Cast<AShooterProjectile>(UGameplayStatics::BeginSpawningActorFromClass(this, ProjectileConfig.ProjectileClass, SpawnTM));
 	if (Projectile)
@@ -81,7 +87,15 @@ void AShooterWeapon_Projectile::ServerFireProjectile_Implementation(FVector Orig
 	}
 }
 
+void AShooterWeapon_Projectile::ApplyDefinition(const UShooterWeaponDefinition* Definition)
+{
+	Super::ApplyDefinition(Definition);
+
+	ProjectileConfig = Definition ? Definition->ProjectileConfig : GetClass()->GetDefaultObject<AShooterWeapon_Projectile>()->ProjectileConfig;
+}
+
 void AShooterWeapon_Projectile::ApplyWeaponConfig(FProjectileWeaponData& Data)
 {
 	Data = ProjectileConfig;
+	Data.ExplosionDamage = FMath::RoundToInt(Data.ExplosionDamage * EffectiveStats.DamageScale);
 }
@@ -31,6 +31,8 @@ public ShooterGame(TargetInfo Target)
         PrivateDependencyModuleNames.AddRange(
 			new string[] {
 				"InputCore",
+				"Json",
+				"RenderCore",
 				"Slate",
 				"SlateCore",
 				"ShooterGameLoadingScreen",